@@ -0,0 +1,269 @@
+/*********************************************************************************************************************
+ * @file        attitude_bench.c
+ * @brief       飞檐走壁智能车 - 姿态解算检查工具 (上位机)
+ * @details     用已知角度生成陀螺仪/加速度计原始数据, 驱动 Attitude_Update / Attitude_UpdateIdle,
+ *              检查俯仰角、偏航角与真值的误差, 以及零偏只在停车 (Idle) 更新中学习
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-03-01
+ *
+ * @note        编译 (仓库根目录):
+ *              gcc -O2 -Wall -DCAR_HOST_BUILD -Ihost/hal -Iuser -I. -o attitude_bench \
+ *                  host/attitude_bench.c user/attitude.c -lm
+ *
+ *              用法:
+ *              ./attitude_bench                    结果输出到 stdout, 超出误差界时返回 1
+ *
+ *              检查项与误差界 (角度单位 0.01°):
+ *              1. CORDIC atan2: 1g 模长向量每 0.5° 一个点, |误差| ≤ BENCH_ATAN2_BOUND (0.1°)
+ *              2. 静态俯仰: 0° ~ ±85° 倾斜静止, 首次更新后 |误差| ≤ BENCH_PITCH_BOUND (0.5°)
+ *              3. 动态俯仰: 以 60°/s 上坡到 30° (走壁过渡弧), 陀螺仪/加速度计一致, 全程 |误差| ≤ 0.5°
+ *              4. 偏航: 零偏学习后以 180°/s 转 90°, 再静止 10s, |误差| ≤ BENCH_YAW_BOUND (0.5°)
+ *              5. 零偏学习: 带零偏的静止数据只经 Attitude_Update 时 bias_valid 保持 0、零偏不变;
+ *                 经 Attitude_UpdateIdle 静止 ATTITUDE_STILL_TIME_MS 后学到零偏 (±1 原始值);
+ *                 Idle 中陀螺仪持续变化 (转动) 时不学习; 学习后 Attitude_Update 不改变零偏
+ *              原始值换算: 加速度 1g = ATTITUDE_ACC_1G, 角速度 1°/s = ATTITUDE_GYRO_LSB_X10 / 10
+ ********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "attitude.h"
+
+/*==================================================================================================================
+ *                                              配置
+ *==================================================================================================================*/
+
+#define BENCH_ATAN2_BOUND       10          /* 0.1° (12 次迭代 + 查表取整) */
+#define BENCH_PITCH_BOUND       50          /* 0.5° */
+#define BENCH_YAW_BOUND         50          /* 0.5° */
+#define BENCH_IDLE_DT_MS        10          /* 停车 Idle 更新间隔 */
+#define BENCH_BIAS_X            -12         /* 模拟陀螺仪零偏 (原始值) */
+#define BENCH_BIAS_Y            25
+#define BENCH_BIAS_Z            31
+
+#define BENCH_PI                3.14159265358979
+
+/*==================================================================================================================
+ *                                              数据生成
+ *==================================================================================================================*/
+
+static long s_errors = 0;
+
+static void check(int ok, const char *what, long got, long want)
+{
+    if (!ok)
+    {
+        if (s_errors < 10)
+        {
+            printf("  FAIL %s: got %ld, want %ld\n", what, got, want);
+        }
+        s_errors++;
+    }
+}
+
+/**
+ * @brief   生成俯仰角 pitch_cdeg 静止时的加速度 (机体系, pitch = atan2(acc_x, acc_z)), 陀螺仪 = 零偏 + 角速度
+ * @param   pitch_rate_dps  俯仰角速度 (°/s, 正 = 抬头, 对应 gyro_y 为负)
+ * @param   yaw_rate_dps    偏航角速度 (°/s, 正 = 右转)
+ */
+static void bench_imu(imu660ra_data_struct *imu, double pitch_cdeg, double pitch_rate_dps, double yaw_rate_dps)
+{
+    double rad = pitch_cdeg / 100.0 * BENCH_PI / 180.0;
+    double lsb = ATTITUDE_GYRO_LSB_X10 / 10.0;
+
+    imu->acc_x  = (int16)floor(ATTITUDE_ACC_1G * sin(rad) + 0.5);
+    imu->acc_y  = 0;
+    imu->acc_z  = (int16)floor(ATTITUDE_ACC_1G * cos(rad) + 0.5);
+    imu->gyro_x = BENCH_BIAS_X;
+    imu->gyro_y = (int16)(BENCH_BIAS_Y + floor(-pitch_rate_dps * lsb + 0.5));
+    imu->gyro_z = (int16)(BENCH_BIAS_Z + floor(yaw_rate_dps * lsb + 0.5));
+}
+
+/**
+ * @brief   Idle 静止 ms 毫秒 (俯仰角 pitch_cdeg)
+ */
+static void bench_idle(int ms, double pitch_cdeg)
+{
+    imu660ra_data_struct imu;
+    int t;
+
+    bench_imu(&imu, pitch_cdeg, 0.0, 0.0);
+    for (t = 0; t < ms; t += BENCH_IDLE_DT_MS)
+    {
+        Attitude_UpdateIdle(&imu, BENCH_IDLE_DT_MS);
+    }
+}
+
+/*==================================================================================================================
+ *                                              检查项
+ *==================================================================================================================*/
+
+static void bench_atan2(void)
+{
+    int half_deg;
+    double rad;
+    long want, got, err, max_err = 0;
+
+    for (half_deg = -359; half_deg <= 360; half_deg++)
+    {
+        rad = half_deg * 0.5 * BENCH_PI / 180.0;
+        got = Attitude_Atan2((int32)floor(ATTITUDE_ACC_1G * sin(rad) + 0.5), (int32)floor(ATTITUDE_ACC_1G * cos(rad) + 0.5));
+        want = half_deg * 50L;
+        err = labs(got - want);
+        if (err > 18000) err = 36000 - err;         /* ±180° 处同一方向 */
+        if (err > max_err) max_err = err;
+        check(err <= BENCH_ATAN2_BOUND, "atan2", got, want);
+    }
+    printf("atan2     : 720 points, max |err| = %ld (0.01 deg, bound %d)\n", max_err, BENCH_ATAN2_BOUND);
+}
+
+static void bench_static_pitch(void)
+{
+    imu660ra_data_struct imu;
+    int deg;
+    long err, max_err = 0;
+
+    for (deg = -85; deg <= 85; deg += 5)
+    {
+        Attitude_Init();
+        bench_imu(&imu, deg * 100.0, 0.0, 0.0);
+        Attitude_Update(&imu);
+        Attitude_Update(&imu);
+        err = labs((long)g_attitude.pitch - deg * 100L);
+        if (err > max_err) max_err = err;
+        check(err <= BENCH_PITCH_BOUND, "static pitch", g_attitude.pitch, deg * 100L);
+    }
+    printf("pitch     : static -85..85 deg, max |err| = %ld (bound %d)\n", max_err, BENCH_PITCH_BOUND);
+}
+
+static void bench_dynamic_pitch(void)
+{
+    imu660ra_data_struct imu;
+    double truth = 0.0;
+    double rate;
+    int k;
+    long err, max_err = 0;
+
+    Attitude_Init();
+    bench_idle(ATTITUDE_STILL_TIME_MS + 500, 0.0);
+
+    /* 0.1s 平地, 0.5s 以 60°/s 抬头到 30°, 0.5s 保持, 0.5s 以 -60°/s 回到 0° */
+    for (k = 0; k < 320; k++)
+    {
+        if (k < 20)       rate = 0.0;
+        else if (k < 120) rate = 60.0;
+        else if (k < 220) rate = 0.0;
+        else              rate = -60.0;
+
+        truth += rate * CONTROL_PERIOD_MS / 1000.0 * 100.0;
+        bench_imu(&imu, truth, rate, 0.0);
+        Attitude_Update(&imu);
+
+        err = labs((long)g_attitude.pitch - (long)floor(truth + 0.5));
+        if (err > max_err) max_err = err;
+        check(err <= BENCH_PITCH_BOUND, "dynamic pitch", g_attitude.pitch, (long)floor(truth + 0.5));
+    }
+    printf("pitch     : 0 -> 30 -> 0 deg at 60 deg/s, max |err| = %ld (bound %d)\n", max_err, BENCH_PITCH_BOUND);
+}
+
+static void bench_yaw(void)
+{
+    imu660ra_data_struct imu;
+    int k;
+    long err_turn, err_hold;
+
+    Attitude_Init();
+    bench_idle(ATTITUDE_STILL_TIME_MS + 1000, 0.0);
+    Attitude_ResetYaw();
+
+    /* 180°/s 右转 0.5s = 90° */
+    bench_imu(&imu, 0.0, 0.0, 180.0);
+    for (k = 0; k < 500 / CONTROL_PERIOD_MS; k++)
+    {
+        Attitude_Update(&imu);
+    }
+    err_turn = labs((long)g_attitude.yaw - 9000);
+    check(err_turn <= BENCH_YAW_BOUND, "yaw after turn", g_attitude.yaw, 9000);
+
+    /* 静止 10s: 零偏已扣除, 不应漂移 */
+    bench_imu(&imu, 0.0, 0.0, 0.0);
+    for (k = 0; k < 10000 / CONTROL_PERIOD_MS; k++)
+    {
+        Attitude_Update(&imu);
+    }
+    err_hold = labs((long)g_attitude.yaw - 9000);
+    check(err_hold <= BENCH_YAW_BOUND, "yaw after hold", g_attitude.yaw, 9000);
+
+    printf("yaw       : 90 deg turn at 180 deg/s |err| = %ld, after 10 s still |err| = %ld (bound %d)\n",
+           err_turn, err_hold, BENCH_YAW_BOUND);
+}
+
+static void bench_bias_learning(void)
+{
+    imu660ra_data_struct imu;
+    int k;
+    int16 bias_z;
+
+    /* 1. 运行中 (Attitude_Update) 静止 2s: 不学习, 零偏被当成转动积分到偏航角 */
+    Attitude_Init();
+    bench_imu(&imu, 0.0, 0.0, 0.0);
+    for (k = 0; k < 2000 / CONTROL_PERIOD_MS; k++)
+    {
+        Attitude_Update(&imu);
+    }
+    check(g_attitude.bias_valid == 0, "bias_valid after Update", g_attitude.bias_valid, 0);
+    check(g_attitude.gyro_bias_z == 0, "bias z after Update", g_attitude.gyro_bias_z, 0);
+    printf("bias      : Update only, 2 s still: bias_valid %u, yaw drift %d (0.01 deg)\n",
+           g_attitude.bias_valid, g_attitude.yaw);
+
+    /* 2. Idle 中持续转动 (陀螺仪每次变化超过静止阈值): 不学习 */
+    Attitude_Init();
+    for (k = 0; k < 2000 / BENCH_IDLE_DT_MS; k++)
+    {
+        bench_imu(&imu, 0.0, 0.0, (k & 1) ? 30.0 : -30.0);
+        Attitude_UpdateIdle(&imu, BENCH_IDLE_DT_MS);
+    }
+    check(g_attitude.bias_valid == 0, "bias_valid while moving", g_attitude.bias_valid, 0);
+
+    /* 3. Idle 静止: 满 ATTITUDE_STILL_TIME_MS 前不学习, 之后学到零偏 */
+    Attitude_Init();
+    bench_idle(ATTITUDE_STILL_TIME_MS - 2 * BENCH_IDLE_DT_MS, 0.0);
+    check(g_attitude.bias_valid == 0, "bias_valid before still time", g_attitude.bias_valid, 0);
+    bench_idle(1000, 0.0);
+    check(g_attitude.bias_valid == 1, "bias_valid after Idle", g_attitude.bias_valid, 1);
+    check(abs(g_attitude.gyro_bias_x - BENCH_BIAS_X) <= 1, "bias x", g_attitude.gyro_bias_x, BENCH_BIAS_X);
+    check(abs(g_attitude.gyro_bias_y - BENCH_BIAS_Y) <= 1, "bias y", g_attitude.gyro_bias_y, BENCH_BIAS_Y);
+    check(abs(g_attitude.gyro_bias_z - BENCH_BIAS_Z) <= 1, "bias z", g_attitude.gyro_bias_z, BENCH_BIAS_Z);
+    printf("bias      : Idle still: learned (%d, %d, %d), want (%d, %d, %d)\n",
+           g_attitude.gyro_bias_x, g_attitude.gyro_bias_y, g_attitude.gyro_bias_z,
+           BENCH_BIAS_X, BENCH_BIAS_Y, BENCH_BIAS_Z);
+
+    /* 4. 学习后运行中: 零偏保持不变 (原始数据零偏偏移 +10 也不跟随) */
+    bias_z = g_attitude.gyro_bias_z;
+    bench_imu(&imu, 0.0, 0.0, 0.0);
+    imu.gyro_z = (int16)(imu.gyro_z + 10);
+    for (k = 0; k < 2000 / CONTROL_PERIOD_MS; k++)
+    {
+        Attitude_Update(&imu);
+    }
+    check(g_attitude.gyro_bias_z == bias_z, "bias z after Update", g_attitude.gyro_bias_z, bias_z);
+    printf("bias      : Update after learning: bias z %d -> %d\n", bias_z, g_attitude.gyro_bias_z);
+}
+
+/*==================================================================================================================
+ *                                              主函数
+ *==================================================================================================================*/
+
+int main(void)
+{
+    bench_atan2();
+    bench_static_pitch();
+    bench_dynamic_pitch();
+    bench_yaw();
+    bench_bias_learning();
+
+    printf("%s: %ld error(s)\n", s_errors ? "FAIL" : "PASS", s_errors);
+    return s_errors ? 1 : 0;
+}
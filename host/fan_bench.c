@@ -0,0 +1,219 @@
+/*********************************************************************************************************************
+ * @file        fan_bench.c
+ * @brief       飞檐走壁智能车 - 上墙/离墙风扇吸附时序对比工具 (上位机)
+ * @details     用简单的吸附模型跑几组 地面 → 墙根过渡弧 → 墙面 → 过渡弧 → 地面 的工况,
+ *              对比原俯仰角线性映射 (Fan_AutoAdjust) 与模型控制 (Fan_Control) 的吸附裕量和打滑时间
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-26
+ *
+ * @note        编译 (仓库根目录):
+ *              gcc -O2 -Wall -DCAR_HOST_BUILD -Ihost/hal -Iuser -I. -o fan_bench \
+ *                  host/fan_bench.c host/sim_hal.c host/sim_model.c user/fan.c user/attitude.c -lm
+ *
+ *              用法:
+ *              ./fan_bench                         结果输出到 stdout, 模型控制在任一工况打滑时返回 1
+ *
+ *              模型:
+ *              - 风扇: 转速 (以占空比表示) 按 BENCH_FAN_TAU 一阶跟随 PWM, 吸力 = 最大吸力 × (转速 / 满转速)^2
+ *              - 吸附: 法向力 = 吸力 + 重力法向分量 + 过渡弧向心力 (内凹弧压向墙面),
+ *                      裕量 = 摩擦系数 × 法向力 − 重力沿坡分量, 裕量 < 0 即打滑
+ *              - IMU: 加速度计给出重力 + 向心加速度 (机体系), 陀螺仪给出俯仰角速度,
+ *                     俯仰角由固件姿态模块 (Attitude_Update) 解算, 与车上一样带有滤波滞后
+ *              电压补偿在此不考虑 (标称电压)
+ ********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "fan.h"
+#include "attitude.h"
+
+/*==================================================================================================================
+ *                                              模型参数
+ *==================================================================================================================*/
+
+#define BENCH_MASS          0.60        /* 整车质量 (kg) */
+#define BENCH_G             9.81
+#define BENCH_MU            0.80        /* 轮胎与墙面摩擦系数 */
+#define BENCH_FAN_FORCE     20.0        /* 满转速吸力 (N) */
+#define BENCH_FAN_TAU       0.15        /* 风扇转速时间常数 (s) */
+#define BENCH_ARC_RADIUS    0.10        /* 墙根过渡弧半径 (m) */
+#define BENCH_GROUND_S      1.0         /* 上墙前、离墙后地面行驶时间 (s) */
+#define BENCH_WALL_S        1.5         /* 墙面行驶时间 (s) */
+#define BENCH_DT            0.001       /* 物理步长 (s) */
+#define BENCH_PI            3.14159265358979
+
+/*==================================================================================================================
+ *                                              对比结果
+ *==================================================================================================================*/
+
+typedef struct
+{
+    double slip_ms;             /* 裕量 < 0 的累计时间 */
+    double min_margin;          /* 最小吸附裕量 (N) */
+    double min_margin_t;        /* 最小裕量出现时刻 (s, 从过渡弧起点算) */
+    double avg_duty;            /* 平均占空比 (能耗参考) */
+} BenchResult_t;
+
+/*==================================================================================================================
+ *                                              电压补偿 (固件 battery.c 提供, 这里按标称电压)
+ *==================================================================================================================*/
+
+uint16 Battery_GetCompScale(void)
+{
+    return 4096;
+}
+
+/*==================================================================================================================
+ *                                              工况仿真
+ *==================================================================================================================*/
+
+/**
+ * @brief   路径上 s 处的坡角 (rad) 和坡角变化率 (rad/m)
+ * @param   curv    输出: 曲率符号 × 1/R (内凹弧为正), 直线段为 0
+ */
+static double bench_path_angle(double s, double len_ground, double len_wall, double *curv)
+{
+    double arc = BENCH_PI / 2.0 * BENCH_ARC_RADIUS;
+
+    *curv = 0.0;
+    if (s < len_ground)
+    {
+        return 0.0;
+    }
+    s -= len_ground;
+    if (s < arc)
+    {
+        *curv = 1.0 / BENCH_ARC_RADIUS;
+        return s / BENCH_ARC_RADIUS;
+    }
+    s -= arc;
+    if (s < len_wall)
+    {
+        return BENCH_PI / 2.0;
+    }
+    s -= len_wall;
+    if (s < arc)
+    {
+        *curv = 1.0 / BENCH_ARC_RADIUS;         /* 下墙也是内凹弧 (墙面 → 地面) */
+        return BENCH_PI / 2.0 - s / BENCH_ARC_RADIUS;
+    }
+    return 0.0;
+}
+
+/**
+ * @brief   跑一个工况
+ * @param   speed       车速 (编码器脉冲/周期)
+ * @param   use_model   0 = Fan_AutoAdjust, 1 = Fan_Control
+ */
+static BenchResult_t bench_run(int16 speed, uint8 use_model)
+{
+    BenchResult_t res;
+    imu660ra_data_struct imu;
+    double v = (double)speed * POSE_UM_PER_COUNT * 1e-6 / (CONTROL_PERIOD_MS * 1e-3);
+    double len_ground = v * BENCH_GROUND_S;
+    double len_wall = v * BENCH_WALL_S;
+    double total = 2.0 * len_ground + len_wall + BENCH_PI * BENCH_ARC_RADIUS;
+    double s = 0.0, t = 0.0, fan = 0.0, duty_sum = 0.0;
+    double angle, angle_last, rate, curv, normal, margin, force, acc_n;
+    long ticks = 0;
+    int sub = 0;
+
+    res.slip_ms = 0.0;
+    res.min_margin = 1e9;
+    res.min_margin_t = 0.0;
+
+    Attitude_Init();
+    Fan_Init();
+    Fan_SetMode(FAN_MODE_AUTO);
+    angle_last = 0.0;
+
+    while (s < total)
+    {
+        angle = bench_path_angle(s, len_ground, len_wall, &curv);
+        rate = (angle - angle_last) / BENCH_DT;
+        angle_last = angle;
+
+        /* 每个控制周期: IMU → 姿态 → 风扇 */
+        if (sub == 0)
+        {
+            acc_n = (s > 0.0) ? v * v * curv / BENCH_G : 0.0;
+            imu.acc_x  = (int16)(4096.0 * sin(angle));
+            imu.acc_y  = 0;
+            imu.acc_z  = (int16)(4096.0 * (cos(angle) + acc_n));
+            imu.gyro_x = 0;
+            imu.gyro_y = (int16)(-rate * 180.0 / BENCH_PI * ATTITUDE_GYRO_LSB_X10 / 10.0);
+            imu.gyro_z = 0;
+            Attitude_Update(&imu);
+
+            if (use_model)
+            {
+                Fan_Control(g_attitude.pitch, g_attitude.gyro_bias_y - imu.gyro_y, speed, 0);
+            }
+            else
+            {
+                Fan_AutoAdjust(g_attitude.pitch / 100);
+            }
+            duty_sum += Fan_GetDuty();
+            ticks++;
+        }
+        sub = (sub + 1) % CONTROL_PERIOD_MS;
+
+        /* 风扇转速一阶滞后, 吸力与转速平方成正比 */
+        fan += ((double)Fan_GetDuty() - fan) * BENCH_DT / BENCH_FAN_TAU;
+        force = BENCH_FAN_FORCE * (fan / FAN_DUTY_MAX) * (fan / FAN_DUTY_MAX);
+
+        normal = force + BENCH_MASS * BENCH_G * cos(angle) + BENCH_MASS * v * v * curv;
+        margin = BENCH_MU * normal - BENCH_MASS * BENCH_G * sin(angle);
+        if (margin < res.min_margin)
+        {
+            res.min_margin = margin;
+            res.min_margin_t = t - len_ground / v;
+        }
+        if (margin < 0.0)
+        {
+            res.slip_ms += BENCH_DT * 1000.0;
+        }
+
+        s += v * BENCH_DT;
+        t += BENCH_DT;
+    }
+
+    res.avg_duty = ticks ? duty_sum / ticks : 0.0;
+    return res;
+}
+
+/*==================================================================================================================
+ *                                              主函数
+ *==================================================================================================================*/
+
+int main(void)
+{
+    static const int16 speeds[] = { 40, 70, 100, 130 };
+    BenchResult_t old_res, new_res;
+    int fail = 0;
+    unsigned i;
+
+    printf("speed,v_mps,old_slip_ms,old_min_margin_n,old_min_t_s,old_avg_duty,"
+           "new_slip_ms,new_min_margin_n,new_min_t_s,new_avg_duty\n");
+
+    for (i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+    {
+        old_res = bench_run(speeds[i], 0);
+        new_res = bench_run(speeds[i], 1);
+
+        printf("%d,%.2f,%.0f,%.2f,%.3f,%.0f,%.0f,%.2f,%.3f,%.0f\n", speeds[i],
+               (double)speeds[i] * POSE_UM_PER_COUNT * 1e-6 / (CONTROL_PERIOD_MS * 1e-3),
+               old_res.slip_ms, old_res.min_margin, old_res.min_margin_t, old_res.avg_duty,
+               new_res.slip_ms, new_res.min_margin, new_res.min_margin_t, new_res.avg_duty);
+
+        if (new_res.slip_ms > 0.0)
+        {
+            fail = 1;
+        }
+    }
+
+    return fail;
+}
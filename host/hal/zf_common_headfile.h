@@ -0,0 +1,99 @@
+/*********************************************************************************************************************
+ * @file        zf_common_headfile.h
+ * @brief       飞檐走壁智能车 - 主机仿真用 HAL 桩 (替代逐飞库同名头文件)
+ * @details     只声明 user/ 下各模块实际用到的外设接口, 实现位于 host/sim_hal.c,
+ *              由车辆模型 (host/sim_model.c) 提供 ADC / 编码器 / IMU 数据并接收 PWM 输出
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-10
+ *
+ * @note        编译时以 -Ihost/hal 放在 -Iuser 之前, 即可让 user/ 下的源文件在 PC 上编译
+ ********************************************************************************************************************/
+
+#ifndef __ZF_COMMON_HEADFILE_H__
+#define __ZF_COMMON_HEADFILE_H__
+
+#include <stdio.h>
+#include "zf_common_typedef.h"
+
+/*==================================================================================================================
+ *                                              引脚与通道枚举
+ *==================================================================================================================*/
+
+typedef enum
+{
+    IO_P24, IO_P25, IO_P35, IO_P40, IO_P41, IO_P42, IO_P43, IO_P53,
+    IO_P60, IO_P64, IO_P67, IO_P70, IO_P75,
+    SIM_GPIO_PIN_COUNT
+} gpio_pin_enum;
+
+typedef enum { GPI, GPO } gpio_dir_enum;
+typedef enum { GPI_PULL_UP, GPI_FLOATING, GPO_PUSH_PULL, GPO_OPEN_DTAIN } gpio_mode_enum;
+
+#define GPIO_LOW    0
+#define GPIO_HIGH   1
+
+typedef enum
+{
+    PWMA_CH2P_P62, PWMA_CH4P_P66, PWMB_CH3_P33,
+    SIM_PWM_CH_COUNT
+} pwm_channel_enum;
+
+#define PWM_DUTY_MAX    10000
+
+typedef enum
+{
+    ADC_CH5_P15, ADC_CH8_P00, ADC_CH9_P01, ADC_CH13_P05, ADC_CH14_P06,
+    SIM_ADC_CH_COUNT
+} adc_channel_enum;
+
+typedef enum { ADC_8BIT, ADC_10BIT, ADC_12BIT } adc_resolution_enum;
+
+typedef enum { TIM0_ENCOEDER, TIM3_ENCOEDER, SIM_ENCODER_COUNT } encoder_index_enum;
+typedef enum { TIM0_ENCOEDER_P34, TIM3_ENCOEDER_P04 } encoder_channel_enum;
+
+typedef enum { UART_1, UART_2, UART_3, UART_4 } uart_index_enum;
+typedef enum { UART2_TX_P11, UART4_TX_P03 } uart_tx_pin_enum;
+typedef enum { UART2_RX_P10, UART4_RX_P02 } uart_rx_pin_enum;
+
+typedef enum { TIM0_PIT, TIM1_PIT, TIM2_PIT, TIM3_PIT, TIM4_PIT } pit_index_enum;
+
+/*==================================================================================================================
+ *                                              外设接口 (host/sim_hal.c)
+ *==================================================================================================================*/
+
+void   gpio_init(gpio_pin_enum pin, gpio_dir_enum dir, uint8 dat, gpio_mode_enum mode);
+uint8  gpio_get_level(gpio_pin_enum pin);
+void   gpio_set_level(gpio_pin_enum pin, uint8 dat);
+void   gpio_toggle_level(gpio_pin_enum pin);
+#define gpio_high(pin)      gpio_set_level((pin), 1)
+#define gpio_low(pin)       gpio_set_level((pin), 0)
+
+void   pwm_init(pwm_channel_enum ch, uint32 freq, uint32 duty);
+void   pwm_set_duty(pwm_channel_enum ch, uint32 duty);
+
+void   adc_init(adc_channel_enum ch, adc_resolution_enum resolution);
+uint16 adc_convert(adc_channel_enum ch);
+uint16 adc_mean_filter_convert(adc_channel_enum ch, uint8 count);
+
+void   encoder_dir_init(encoder_index_enum index, gpio_pin_enum dir_pin, encoder_channel_enum ch);
+int16  encoder_get_count(encoder_index_enum index);
+void   encoder_clear_count(encoder_index_enum index);
+
+void   uart_init(uart_index_enum index, uint32 baud, uart_tx_pin_enum tx, uart_rx_pin_enum rx);
+void   uart_rx_interrupt(uart_index_enum index, uint8 status);
+void   uart_write_byte(uart_index_enum index, uint8 dat);
+void   uart_write_buffer(uart_index_enum index, const uint8 *buff, uint32 len);
+void   uart_write_string(uart_index_enum index, const char *str);
+
+void   iap_init(void);
+void   iap_read_bytes(uint32 addr, uint8 *buf, uint16 len);
+void   iap_write_bytes(uint32 addr, uint8 *buf, uint16 len);
+void   iap_erase_page(uint32 addr);
+
+void   pit_ms_init(pit_index_enum index, uint16 ms);
+void   system_delay_ms(uint16 ms);
+void   interrupt_global_enable(void);
+void   interrupt_global_disable(void);
+
+#endif /* __ZF_COMMON_HEADFILE_H__ */
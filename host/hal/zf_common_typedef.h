@@ -0,0 +1,36 @@
+/*********************************************************************************************************************
+ * @file        zf_common_typedef.h
+ * @brief       飞檐走壁智能车 - 主机仿真用类型定义 (替代逐飞库同名头文件)
+ * @details     仅用于 host/ 目录下的 PC 端程序, 单片机工程仍使用逐飞库原版
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-10
+ ********************************************************************************************************************/
+
+#ifndef __ZF_COMMON_TYPEDEF_H__
+#define __ZF_COMMON_TYPEDEF_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t     uint8;
+typedef uint16_t    uint16;
+typedef uint32_t    uint32;
+typedef int8_t      int8;
+typedef int16_t     int16;
+typedef int32_t     int32;
+
+typedef volatile uint8   vuint8;
+typedef volatile uint16  vuint16;
+typedef volatile uint32  vuint32;
+typedef volatile int8    vint8;
+typedef volatile int16   vint16;
+typedef volatile int32   vint32;
+
+/* C251 存储区关键字在 PC 上无意义 */
+#define code
+#define xdata
+#define edata
+#define idata
+
+#endif /* __ZF_COMMON_TYPEDEF_H__ */
@@ -0,0 +1,16 @@
+/*********************************************************************************************************************
+ * @file        zf_device_type.h
+ * @brief       飞檐走壁智能车 - 主机仿真用设备接口类型 (替代逐飞库同名头文件)
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-10
+ ********************************************************************************************************************/
+
+#ifndef __ZF_DEVICE_TYPE_H__
+#define __ZF_DEVICE_TYPE_H__
+
+#define HARDWARE_SPI    0
+#define SOFT_SPI        1
+#define SOFT_IIC        2
+
+#endif /* __ZF_DEVICE_TYPE_H__ */
@@ -0,0 +1,304 @@
+/*********************************************************************************************************************
+ * @file        inductor_bench.c
+ * @brief       飞檐走壁智能车 - 电感解算精度/耗时对比工具 (上位机)
+ * @details     用原除法实现 (归一化除法 + 牛顿迭代 fast_sqrt + 差比和除法) 作为参考,
+ *              穷举对比 Inductor_Process 的查表/乘倒数实现, 并给出主机上的耗时对比
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-20
+ *
+ * @note        编译 (仓库根目录):
+ *              gcc -O2 -Wall -DCAR_HOST_BUILD -Ihost/hal -Iuser -I. -o inductor_bench \
+ *                  host/inductor_bench.c host/sim_hal.c host/sim_model.c user/inductor.c user/adc_scan.c -lm
+ *
+ *              用法:
+ *              ./inductor_bench                    结果输出到 stdout, 有不一致时返回 1
+ *
+ *              对比项:
+ *              1. 归一化: 跨度 1 ~ 4095, 每个跨度穷举 raw = 0 ~ 4095, 与原除法逐位比较
+ *              2. 向量模: x, y = 0 ~ 100 穷举, 分别与原 fast_sqrt 和精确 floor(√) 比较
+ *              3. 差比和: 左右向量模 0 ~ 100 穷举, 与原除法逐位比较
+ *              主机耗时仅供参考: 主机除法很快而逐位开方的分支难以预测, 新实现在主机上不一定更快;
+ *              单片机上 32 位除法是库函数调用, 代价远高于移位/比较, 以每帧除法次数为准
+ ********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "inductor.h"
+
+/*==================================================================================================================
+ *                                              参考实现 (原除法版本)
+ *==================================================================================================================*/
+
+static uint16 s_ref_min[4];
+static uint16 s_ref_max[4];
+
+/**
+ * @brief   原固件的牛顿迭代整数平方根 (固件已改为逐位试商开方, 只作参考)
+ */
+static uint16 fast_sqrt(uint32 val)
+{
+    uint32 result, temp;
+    
+    if (val == 0) return 0;
+    if (val == 1) return 1;
+    
+    // 初始估计值 (选择合适的起点加速收敛)
+    if (val < 256)
+    {
+        result = 8;     // √256 = 16, 取一半作为起点
+    }
+    else if (val < 4096)
+    {
+        result = 32;    // √4096 = 64
+    }
+    else if (val < 65536)
+    {
+        result = 128;   // √65536 = 256
+    }
+    else
+    {
+        result = 256;   // 更大的值
+    }
+    
+    // 牛顿迭代法: x_new = (x + val/x) / 2
+    // 迭代3次, 精度足够用于电感向量计算
+    temp = (result + val / result) >> 1;
+    result = (temp + val / temp) >> 1;
+    result = (result + val / result) >> 1;
+    
+    return (uint16)result;
+}
+
+static uint8 ref_normalize(uint16 raw, uint16 min_val, uint16 max_val)
+{
+    if (raw < min_val) raw = min_val;
+    if (raw > max_val) raw = max_val;
+    return (uint8)((int32)(raw - min_val) * 100 / (int32)(max_val - min_val));
+}
+
+static uint8 ref_magnitude(uint8 x, uint8 y)
+{
+    uint16 m = fast_sqrt((uint32)x * x + (uint32)y * y);
+    return (uint8)(m > 100 ? 100 : m);
+}
+
+static int16 ref_ratio(uint8 left, uint8 right)
+{
+    int16 diff = (int16)left - right;
+    int16 sum = (int16)left + right;
+    return (int16)(-(diff * 100) / (sum + 1));
+}
+
+static void ref_set_calibration(uint8 channel, uint16 min_val, uint16 max_val)
+{
+    s_ref_min[channel] = min_val;
+    s_ref_max[channel] = max_val;
+    Inductor_SetCalibration(channel, min_val, max_val);
+}
+
+/* 原 Inductor_Update 的计算部分, 仅用于耗时对比 */
+static int16 ref_process(const InductorRaw_t *raw)
+{
+    uint8 lx = ref_normalize(raw->left_x,  s_ref_min[0], s_ref_max[0]);
+    uint8 ly = ref_normalize(raw->left_y,  s_ref_min[1], s_ref_max[1]);
+    uint8 rx = ref_normalize(raw->right_x, s_ref_min[2], s_ref_max[2]);
+    uint8 ry = ref_normalize(raw->right_y, s_ref_min[3], s_ref_max[3]);
+    uint8 l = ref_magnitude(lx, ly);
+    uint8 r = ref_magnitude(rx, ry);
+
+    return ((int16)l + r < 20) ? 0 : ref_ratio(l, r);
+}
+
+/*==================================================================================================================
+ *                                              对比项
+ *==================================================================================================================*/
+
+static long bench_normalize(void)
+{
+    InductorRaw_t raw = {0, 0, 0, 0};
+    long mismatch = 0;
+    long count = 0;
+    uint16 span;
+    uint16 min_val;
+    uint16 value;
+
+    for (span = 1; span < 4096; span++)
+    {
+        min_val = (uint16)((span * 7u) % (4096u - span));     // 换几个零点, 覆盖限幅两侧
+        ref_set_calibration(0, min_val, (uint16)(min_val + span));
+        for (value = 0; value < 4096; value++)
+        {
+            raw.left_x = value;
+            Inductor_Process(&raw);
+            count++;
+            if (g_inductor.norm.left_x != ref_normalize(value, min_val, (uint16)(min_val + span)))
+            {
+                if (mismatch < 5)
+                {
+                    printf("  norm mismatch: min=%u span=%u raw=%u new=%u ref=%u\n", min_val, span, value,
+                           g_inductor.norm.left_x, ref_normalize(value, min_val, (uint16)(min_val + span)));
+                }
+                mismatch++;
+            }
+        }
+    }
+    printf("normalize : %ld cases, %ld mismatch\n", count, mismatch);
+    return mismatch;
+}
+
+static long bench_magnitude(void)
+{
+    InductorRaw_t raw = {0, 0, 0, 0};
+    long diff_exact = 0;
+    long diff_old = 0;
+    int worst_old = 0;
+    int x, y, exact, err;
+
+    for (x = 0; x < 4; x++)
+    {
+        ref_set_calibration((uint8)x, 0, 100);          // norm = raw
+    }
+
+    for (x = 0; x <= 100; x++)
+    {
+        for (y = 0; y <= 100; y++)
+        {
+            raw.left_x = (uint16)x;
+            raw.left_y = (uint16)y;
+            Inductor_Process(&raw);
+
+            exact = (int)floor(sqrt((double)(x * x + y * y)));
+            if (exact > 100) exact = 100;
+            if (g_inductor.vector.left_magnitude != exact)
+            {
+                diff_exact++;
+            }
+
+            err = (int)g_inductor.vector.left_magnitude - ref_magnitude((uint8)x, (uint8)y);
+            if (err != 0)
+            {
+                diff_old++;
+                if (abs(err) > abs(worst_old)) worst_old = err;
+            }
+        }
+    }
+    printf("magnitude : 10201 cases, %ld differ from floor(sqrt), %ld differ from fast_sqrt (worst %+d)\n",
+           diff_exact, diff_old, worst_old);
+    return diff_exact;
+}
+
+static long bench_ratio(void)
+{
+    InductorRaw_t raw = {0, 0, 0, 0};
+    long mismatch = 0;
+    long count = 0;
+    int l, r;
+
+    for (l = 0; l < 4; l++)
+    {
+        ref_set_calibration((uint8)l, 0, 100);
+    }
+
+    for (l = 0; l <= 100; l++)
+    {
+        for (r = 0; r <= 100; r++)
+        {
+            raw.left_x = (uint16)l;
+            raw.right_x = (uint16)r;
+            Inductor_Process(&raw);
+            if (!g_inductor.vector.is_online)
+            {
+                continue;
+            }
+            count++;
+            if (g_inductor.vector.error != ref_ratio((uint8)l, (uint8)r))
+            {
+                if (mismatch < 5)
+                {
+                    printf("  ratio mismatch: l=%d r=%d new=%d ref=%d\n", l, r,
+                           g_inductor.vector.error, ref_ratio((uint8)l, (uint8)r));
+                }
+                mismatch++;
+            }
+        }
+    }
+    printf("ratio     : %ld cases, %ld mismatch\n", count, mismatch);
+    return mismatch;
+}
+
+/*==================================================================================================================
+ *                                              耗时对比
+ *==================================================================================================================*/
+
+#define BENCH_FRAMES    4096
+#define BENCH_ROUNDS    2000
+
+static void bench_timing(void)
+{
+    static InductorRaw_t frames[BENCH_FRAMES];
+    volatile int32 sink = 0;
+    clock_t t0;
+    double t_ref, t_new;
+    int i, k;
+
+    srand(1);
+    for (i = 0; i < 4; i++)
+    {
+        ref_set_calibration((uint8)i, (uint16)(100 + i * 37), (uint16)(3500 - i * 53));
+    }
+    for (i = 0; i < BENCH_FRAMES; i++)
+    {
+        frames[i].left_x  = (uint16)(rand() % 4096);
+        frames[i].left_y  = (uint16)(rand() % 4096);
+        frames[i].right_x = (uint16)(rand() % 4096);
+        frames[i].right_y = (uint16)(rand() % 4096);
+    }
+
+    t0 = clock();
+    for (k = 0; k < BENCH_ROUNDS; k++)
+    {
+        for (i = 0; i < BENCH_FRAMES; i++)
+        {
+            sink += ref_process(&frames[i]);
+        }
+    }
+    t_ref = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    t0 = clock();
+    for (k = 0; k < BENCH_ROUNDS; k++)
+    {
+        for (i = 0; i < BENCH_FRAMES; i++)
+        {
+            Inductor_Process(&frames[i]);
+            sink += g_inductor.vector.error;
+        }
+    }
+    t_new = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    printf("timing    : %d frames, old %.1f ns/frame, new %.1f ns/frame (host)\n", BENCH_FRAMES * BENCH_ROUNDS,
+           t_ref * 1e9 / ((double)BENCH_FRAMES * BENCH_ROUNDS), t_new * 1e9 / ((double)BENCH_FRAMES * BENCH_ROUNDS));
+    printf("            32-bit divides per frame: old 11 (4 normalize + 2 x 3 Newton + 1 ratio), new 0\n");
+    (void)sink;
+}
+
+/*==================================================================================================================
+ *                                              主函数
+ *==================================================================================================================*/
+
+int main(void)
+{
+    long fail = 0;
+
+    Inductor_Init();
+
+    fail += bench_normalize();
+    fail += bench_magnitude();
+    fail += bench_ratio();
+    bench_timing();
+
+    return fail ? 1 : 0;
+}
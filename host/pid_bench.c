@@ -0,0 +1,293 @@
+/*********************************************************************************************************************
+ * @file        pid_bench.c
+ * @brief       飞检走壁智能车 - PID 定点/浮点一致性检查工具 (上位机)
+ * @details     用双精度浮点 PID (增益取同一 Q10 值, 不截断) 作为参考, 对比 pid.c 定点实现的输出,
+ *              同时给出原浮点实现 (各分量截断为整数) 的误差作为对照
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-03-01
+ *
+ * @note        编译 (仓库根目录):
+ *              gcc -O2 -Wall -DCAR_HOST_BUILD -Ihost/hal -Iuser -I. -o pid_bench host/pid_bench.c user/pid.c -lm
+ *
+ *              用法:
+ *              ./pid_bench                         结果输出到 stdout, 超出误差界时返回 1
+ *
+ *              误差界 (与同增益的理想浮点 PID 相比, 输出均已限幅):
+ *              - 位置式: Q10 求和后四舍五入, |定点 - 参考| ≤ 0.5
+ *              - 增量式: 小数部分留在 output_frac 中, 未限幅时定点输出 = 参考输出向下取整;
+ *                限幅时参考值丢弃小数而定点保留余量, 退出限幅后可能向上差一个小数, 故界为 |定点 - 参考| < 1
+ *              - 增益换算: PID_GainFromX10 与 x/10 × 1024 的差 ≤ 0.5 LSB, PID_GainToX10 能还原;
+ *                超过 PID_GAIN_MAX_X10 的值限幅到 PID_GAIN_MAX
+ *
+ *              输入序列: 正弦、阶跃、随机目标交替, 方向环偏差 ±100 量级, 速度环目标 ±200 量级,
+ *              Kp/Kd 覆盖 0 ~ PID_GAIN_MAX_X10 (×10)
+ ********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "pid.h"
+
+/*==================================================================================================================
+ *                                              配置
+ *==================================================================================================================*/
+
+#define BENCH_GAIN_SETS         400         /* 随机增益组数 */
+#define BENCH_STEPS             2000        /* 每组增益的控制周期数 */
+#define BENCH_POS_OUT_MAX       PID_DIRECTION_OUT_MAX
+#define BENCH_INC_OUT_MAX       PID_SPEED_OUT_MAX
+#define BENCH_POS_BOUND         (0.5 + 1e-9)
+#define BENCH_INC_BOUND         1.0
+
+/*==================================================================================================================
+ *                                              参考实现
+ *==================================================================================================================*/
+
+typedef struct
+{
+    double kp, ki, kd;
+    double e_now, e_last, e_prev;
+    double integral, integral_max;
+    double output, output_max;
+} RefPid_t;
+
+static double ref_clamp(double v, double max)
+{
+    if (v > max)  return max;
+    if (v < -max) return -max;
+    return v;
+}
+
+static void ref_init(RefPid_t *r, const PID_Controller_t *pid)
+{
+    r->kp = (double)pid->Kp / PID_Q_ONE;
+    r->ki = (double)pid->Ki / PID_Q_ONE;
+    r->kd = (double)pid->Kd / PID_Q_ONE;
+    r->e_now = r->e_last = r->e_prev = 0.0;
+    r->integral = 0.0;
+    r->integral_max = (double)pid->integral_max;
+    r->output = 0.0;
+    r->output_max = (double)pid->output_max;
+}
+
+static double ref_positional(RefPid_t *r, int target, int feedback)
+{
+    r->e_last = r->e_now;
+    r->e_now = target - feedback;
+    r->integral = ref_clamp(r->integral + r->e_now, r->integral_max);
+    r->output = ref_clamp(r->kp * r->e_now + r->ki * r->integral + r->kd * (r->e_now - r->e_last), r->output_max);
+    return r->output;
+}
+
+static double ref_incremental(RefPid_t *r, int target, int feedback)
+{
+    r->e_prev = r->e_last;
+    r->e_last = r->e_now;
+    r->e_now = target - feedback;
+    r->output = ref_clamp(r->output + r->kp * (r->e_now - r->e_last) + r->ki * r->e_now
+                          + r->kd * (r->e_now - 2.0 * r->e_last + r->e_prev), r->output_max);
+    return r->output;
+}
+
+/* 原浮点实现 (各分量截断为 int32 后求和), 仅用于对照 */
+static double old_positional(RefPid_t *r, int target, int feedback)
+{
+    r->e_last = r->e_now;
+    r->e_now = target - feedback;
+    r->integral = ref_clamp(r->integral + r->e_now, r->integral_max);
+    r->output = ref_clamp((double)((long)(r->kp * r->e_now) + (long)(r->ki * r->integral)
+                                   + (long)(r->kd * (r->e_now - r->e_last))), r->output_max);
+    return r->output;
+}
+
+static double old_incremental(RefPid_t *r, int target, int feedback)
+{
+    r->e_prev = r->e_last;
+    r->e_last = r->e_now;
+    r->e_now = target - feedback;
+    r->output = ref_clamp(r->output + (double)((long)(r->kp * (r->e_now - r->e_last)) + (long)(r->ki * r->e_now)
+                                               + (long)(r->kd * (r->e_now - 2.0 * r->e_last + r->e_prev))),
+                          r->output_max);
+    return r->output;
+}
+
+/*==================================================================================================================
+ *                                              输入序列
+ *==================================================================================================================*/
+
+static int bench_rand(int range)
+{
+    return (int)(rand() % (2 * range + 1)) - range;
+}
+
+/**
+ * @brief   第 k 步的目标值 (反馈单独生成)
+ */
+static int bench_input(int set, int k)
+{
+    switch (set % 3)
+    {
+        case 0:  return (int)(3000.0 * sin(k * 0.02 * (1 + set % 7)));     /* 正弦 */
+        case 1:  return ((k / 150) % 2) ? 2500 : -2500;                    /* 阶跃 */
+        default: return bench_rand(4000);                                  /* 随机 */
+    }
+}
+
+/*==================================================================================================================
+ *                                              检查项
+ *==================================================================================================================*/
+
+typedef struct
+{
+    double max_new;             /* 定点与参考的最大偏差 */
+    double max_old;             /* 原浮点实现与参考的最大偏差 */
+    long   violations;
+} BenchStat_t;
+
+static void bench_gains(PID_Controller_t *pid, int set, int out_max)
+{
+    int16 kp = (int16)(rand() % (PID_GAIN_MAX_X10 + 1));
+    int16 ki = (int16)((set % 4 == 0) ? 0 : rand() % 20);
+    int16 kd = (int16)(rand() % (PID_GAIN_MAX_X10 + 1));
+
+    PID_Init(pid, 0, 0, 0, out_max);
+    PID_SetParamsX10(pid, kp, ki, kd);
+}
+
+static void bench_positional(BenchStat_t *st)
+{
+    PID_Controller_t pid;
+    RefPid_t ref, old;
+    int set, k, target, feedback;
+    double out_new, out_ref, err;
+
+    for (set = 0; set < BENCH_GAIN_SETS; set++)
+    {
+        bench_gains(&pid, set, BENCH_POS_OUT_MAX);
+        ref_init(&ref, &pid);
+        ref_init(&old, &pid);
+        feedback = 0;
+
+        for (k = 0; k < BENCH_STEPS; k++)
+        {
+            target = bench_input(set, k) / 30;                  /* 方向环: 偏差 ±100 量级 */
+            feedback = feedback + bench_rand(3);
+            feedback = (feedback > 100) ? 100 : (feedback < -100 ? -100 : feedback);
+
+            out_new = (double)PID_Positional(&pid, (int16)target, (int16)feedback);
+            out_ref = ref_positional(&ref, target, feedback);
+            err = fabs(out_new - out_ref);
+            if (err > st->max_new) st->max_new = err;
+            if (err > BENCH_POS_BOUND)
+            {
+                if (st->violations < 5)
+                {
+                    printf("  positional: set %d step %d kp=%ld kd=%ld new=%.0f ref=%.3f\n",
+                           set, k, (long)pid.Kp, (long)pid.Kd, out_new, out_ref);
+                }
+                st->violations++;
+            }
+            err = fabs(old_positional(&old, target, feedback) - out_ref);
+            if (err > st->max_old) st->max_old = err;
+        }
+    }
+}
+
+static void bench_incremental(BenchStat_t *st)
+{
+    PID_Controller_t pid;
+    RefPid_t ref, old;
+    int set, k, target, feedback;
+    double out_new, out_ref, err;
+
+    for (set = 0; set < BENCH_GAIN_SETS; set++)
+    {
+        bench_gains(&pid, set, BENCH_INC_OUT_MAX);
+        ref_init(&ref, &pid);
+        ref_init(&old, &pid);
+        feedback = 0;
+
+        for (k = 0; k < BENCH_STEPS; k++)
+        {
+            target = bench_input(set, k) / 20;                  /* 速度环: 编码器速度 ±200 量级 */
+            feedback += (target - feedback) / 8 + bench_rand(2);
+
+            out_new = (double)PID_Incremental(&pid, (int16)target, (int16)feedback);
+            out_ref = ref_incremental(&ref, target, feedback);
+            err = fabs(out_new - out_ref);
+            if (err > st->max_new) st->max_new = err;
+            if (err >= BENCH_INC_BOUND)
+            {
+                if (st->violations < 5)
+                {
+                    printf("  incremental: set %d step %d kp=%ld ki=%ld kd=%ld new=%.0f ref=%.3f\n",
+                           set, k, (long)pid.Kp, (long)pid.Ki, (long)pid.Kd, out_new, out_ref);
+                }
+                st->violations++;
+            }
+            err = fabs(old_incremental(&old, target, feedback) - out_ref);
+            if (err > st->max_old) st->max_old = err;
+        }
+    }
+}
+
+static long bench_gain_conversion(void)
+{
+    long bad = 0;
+    int x;
+    int32 q;
+    PID_Controller_t pid;
+
+    for (x = -PID_GAIN_MAX_X10; x <= PID_GAIN_MAX_X10; x++)
+    {
+        q = PID_GainFromX10((int16)x);
+        if (fabs((double)q - x * PID_Q_ONE / 10.0) > 0.5 || PID_GainToX10(q) != x)
+        {
+            if (bad < 5)
+            {
+                printf("  gain x10=%d q=%ld back=%d\n", x, (long)q, PID_GainToX10(q));
+            }
+            bad++;
+        }
+    }
+
+    /* 超过上限: 按 PID_GAIN_MAX 生效 */
+    PID_Init(&pid, 0, 0, 0, 100);
+    PID_SetParamsX10(&pid, 500, -500, PID_GAIN_MAX_X10 + 1);
+    if (pid.Kp != PID_GAIN_MAX || pid.Ki != -PID_GAIN_MAX || pid.Kd != PID_GAIN_MAX)
+    {
+        printf("  gain clamp: kp=%ld ki=%ld kd=%ld\n", (long)pid.Kp, (long)pid.Ki, (long)pid.Kd);
+        bad++;
+    }
+
+    printf("gain x10  : %d values, %ld bad (limit %d -> %.3f)\n",
+           2 * PID_GAIN_MAX_X10 + 1, bad, PID_GAIN_MAX_X10, (double)PID_GAIN_MAX / PID_Q_ONE);
+    return bad;
+}
+
+/*==================================================================================================================
+ *                                              主函数
+ *==================================================================================================================*/
+
+int main(void)
+{
+    BenchStat_t pos = {0.0, 0.0, 0};
+    BenchStat_t inc = {0.0, 0.0, 0};
+    long bad;
+
+    srand(1);
+
+    bench_positional(&pos);
+    printf("positional: %d x %d steps, max |new - ref| = %.3f (bound 0.5), old float max = %.3f, %ld violations\n",
+           BENCH_GAIN_SETS, BENCH_STEPS, pos.max_new, pos.max_old, pos.violations);
+
+    bench_incremental(&inc);
+    printf("incremental: %d x %d steps, max |new - ref| = %.3f (bound < 1), old float max = %.3f, %ld violations\n",
+           BENCH_GAIN_SETS, BENCH_STEPS, inc.max_new, inc.max_old, inc.violations);
+
+    bad = bench_gain_conversion();
+
+    return (pos.violations || inc.violations || bad) ? 1 : 0;
+}
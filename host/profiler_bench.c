@@ -0,0 +1,290 @@
+/*********************************************************************************************************************
+ * @file        profiler_bench.c
+ * @brief       飞檐走壁智能车 - 分段耗时统计逻辑检查工具 (上位机)
+ * @details     用 profiler.c 的主机模拟计数器 (Profiler_MockSetCounter / Profiler_MockSetOverrun) 回放
+ *              已知各阶段耗时的控制周期, 检查逐阶段 min/max/mean、超时计数和蓝牙报告是否与期望一致
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-03-01
+ *
+ * @note        编译 (仓库根目录):
+ *              gcc -O2 -Wall -DCAR_HOST_BUILD -Ihost/hal -Iuser -I. -o profiler_bench \
+ *                  host/profiler_bench.c host/sim_hal.c host/sim_model.c user/profiler.c -lm
+ *
+ *              用法:
+ *              ./profiler_bench                    结果输出到 stdout, 有不一致时返回 1
+ *
+ *              检查项:
+ *              1. 分段统计: 每周期各阶段耗时按固定模式变化, 与上位机独立累计的 min/max/mean 逐项比较
+ *              2. 超时计数: 指定周期置位 "下一周期中断已到" 标志, 超时次数应与置位次数相等
+ *              3. 计数器回绕: 阶段跨过 0xFFFF -> 0 时耗时仍按无符号差值正确计算
+ *              4. 计数减半: 统计次数到 0xFFFF 时 sum/count 同时减半, 平均值变化不超过 1us (整数截断)
+ *              5. 报告: Profiler_SendReport 的每行数值与统计一致, 最慢阶段判定正确
+ *              蓝牙发送和数字格式化在此用桩函数代替, 不链接 bluetooth.c
+ *              主机模拟计数器重装值为 0, 1 计数 = 1us, 控制周期 = CONTROL_PERIOD_MS × 1000 计数
+ ********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "profiler.h"
+
+/*==================================================================================================================
+ *                                              配置
+ *==================================================================================================================*/
+
+#define BENCH_CYCLES            1000        /* 分段统计回放的控制周期数 */
+#define BENCH_OVERRUN_EVERY     97          /* 每 N 个周期置位一次超时标志 */
+#define BENCH_REPORT_LINES      (PROF_STAGE_NUM + 1)
+
+/*==================================================================================================================
+ *                                              蓝牙发送桩
+ *==================================================================================================================*/
+
+static char s_report[BENCH_REPORT_LINES][32];
+static int  s_report_lines = 0;
+
+void Bluetooth_SendString(const char *str)
+{
+    if (s_report_lines < BENCH_REPORT_LINES)
+    {
+        strncpy(s_report[s_report_lines], str, sizeof(s_report[0]) - 1);
+        s_report[s_report_lines][sizeof(s_report[0]) - 1] = '\0';
+    }
+    s_report_lines++;
+}
+
+char *Bluetooth_AppendInt(char *p, int32 value)
+{
+    return p + sprintf(p, "%ld", (long)value);
+}
+
+/*==================================================================================================================
+ *                                              期望值
+ *==================================================================================================================*/
+
+typedef struct
+{
+    unsigned long min, max, sum, count;
+} ExpectStat_t;
+
+static ExpectStat_t s_expect[PROF_STAGE_NUM];
+static long s_errors = 0;
+
+static void expect_record(ProfilerStage_t stage, unsigned long ticks)
+{
+    ExpectStat_t *e = &s_expect[stage];
+
+    if (e->count == 0 || ticks < e->min) e->min = ticks;
+    if (ticks > e->max) e->max = ticks;
+    e->sum += ticks;
+    e->count++;
+}
+
+static void check(int ok, const char *what, long got, long want)
+{
+    if (!ok)
+    {
+        if (s_errors < 10)
+        {
+            printf("  FAIL %s: got %ld, want %ld\n", what, got, want);
+        }
+        s_errors++;
+    }
+}
+
+/**
+ * @brief   第 cycle 个周期中 stage 阶段的耗时 (计数), 各阶段按不同周期变化, 平均值 PID 阶段最大
+ */
+static unsigned long bench_stage_ticks(int cycle, ProfilerStage_t stage)
+{
+    static const unsigned short base[PROF_STAGE_TOTAL] = { 20, 60, 180, 240, 90, 400, 30, 50 };
+    static const unsigned short span[PROF_STAGE_TOTAL] = {  5, 10,  40,  60, 80, 120,  7, 25 };
+
+    return base[stage] + (unsigned long)((cycle * (3 + 2 * stage)) % (span[stage] + 1));
+}
+
+/*==================================================================================================================
+ *                                              检查项
+ *==================================================================================================================*/
+
+/**
+ * @brief   按 System_Control 的打点顺序回放一个周期, start 为周期开始时的计数
+ */
+static unsigned long bench_run_cycle(int cycle, uint16 start, uint8 overrun)
+{
+    uint16 counter = start;
+    unsigned long total;
+    unsigned long ticks;
+    int stage;
+
+    Profiler_MockSetOverrun(0);
+
+    ticks = bench_stage_ticks(cycle, PROF_STAGE_ENTRY);
+    counter = (uint16)(counter + ticks);
+    Profiler_MockSetCounter(counter);
+    Profiler_Begin();
+    expect_record(PROF_STAGE_ENTRY, ticks);
+    total = ticks;
+
+    for (stage = PROF_STAGE_ENCODER; stage < PROF_STAGE_TOTAL; stage++)
+    {
+        ticks = bench_stage_ticks(cycle, (ProfilerStage_t)stage);
+        counter = (uint16)(counter + ticks);
+        Profiler_MockSetCounter(counter);
+        Profiler_Mark((ProfilerStage_t)stage);
+        expect_record((ProfilerStage_t)stage, ticks);
+        total += ticks;
+    }
+
+    Profiler_MockSetOverrun(overrun);
+    Profiler_End();
+    expect_record(PROF_STAGE_TOTAL, total);
+
+    return total;
+}
+
+static void bench_aggregation(void)
+{
+    int cycle, stage;
+    uint16 want_overrun = 0;
+    uint8 overrun;
+    char name[48];
+
+    Profiler_Init();
+    memset(s_expect, 0, sizeof(s_expect));
+
+    for (cycle = 0; cycle < BENCH_CYCLES; cycle++)
+    {
+        overrun = (uint8)(cycle % BENCH_OVERRUN_EVERY == BENCH_OVERRUN_EVERY - 1);
+        want_overrun += overrun;
+        bench_run_cycle(cycle, 0, overrun);
+    }
+
+    for (stage = 0; stage < PROF_STAGE_NUM; stage++)
+    {
+        const ProfilerStat_t *st = &g_profiler.stage[stage];
+        const ExpectStat_t *e = &s_expect[stage];
+
+        sprintf(name, "%s min", Profiler_GetStageName((ProfilerStage_t)stage));
+        check(st->min == e->min, name, st->min, (long)e->min);
+        sprintf(name, "%s max", Profiler_GetStageName((ProfilerStage_t)stage));
+        check(st->max == e->max, name, st->max, (long)e->max);
+        sprintf(name, "%s count", Profiler_GetStageName((ProfilerStage_t)stage));
+        check(st->count == e->count, name, st->count, (long)e->count);
+        sprintf(name, "%s mean us", Profiler_GetStageName((ProfilerStage_t)stage));
+        check(Profiler_GetMeanUs((ProfilerStage_t)stage) == e->sum / e->count, name,
+              Profiler_GetMeanUs((ProfilerStage_t)stage), (long)(e->sum / e->count));
+    }
+    check(g_profiler.overrun == want_overrun, "overrun", g_profiler.overrun, want_overrun);
+    check(Profiler_GetSlowestStage() == PROF_STAGE_PID, "slowest stage", Profiler_GetSlowestStage(), PROF_STAGE_PID);
+
+    printf("aggregate : %d cycles, TOT mean %u us max %u us, %u overruns (want %u), slowest %s\n",
+           BENCH_CYCLES, Profiler_GetMeanUs(PROF_STAGE_TOTAL), Profiler_GetMaxUs(PROF_STAGE_TOTAL),
+           g_profiler.overrun, want_overrun, Profiler_GetStageName(Profiler_GetSlowestStage()));
+}
+
+static void bench_report(void)
+{
+    int stage;
+    char want[32];
+
+    s_report_lines = 0;
+    Profiler_SendReport();
+    check(s_report_lines == BENCH_REPORT_LINES, "report lines", s_report_lines, BENCH_REPORT_LINES);
+
+    for (stage = 0; stage < PROF_STAGE_NUM && stage < s_report_lines; stage++)
+    {
+        sprintf(want, "%s %lu %lu %lu\r\n", Profiler_GetStageName((ProfilerStage_t)stage),
+                s_expect[stage].min, s_expect[stage].sum / s_expect[stage].count, s_expect[stage].max);
+        if (strcmp(s_report[stage], want) != 0)
+        {
+            printf("  FAIL report line %d: \"%.*s\"\n", stage, (int)strcspn(s_report[stage], "\r"), s_report[stage]);
+            s_errors++;
+        }
+    }
+    sprintf(want, "OVR %u PER %u\r\n", g_profiler.overrun, CONTROL_PERIOD_MS * 1000);
+    if (s_report_lines > PROF_STAGE_NUM && strcmp(s_report[PROF_STAGE_NUM], want) != 0)
+    {
+        printf("  FAIL report overrun line: \"%.*s\"\n",
+               (int)strcspn(s_report[PROF_STAGE_NUM], "\r"), s_report[PROF_STAGE_NUM]);
+        s_errors++;
+    }
+
+    printf("report    : %d lines, last \"%.*s\"\n", s_report_lines,
+           (int)strcspn(s_report[PROF_STAGE_NUM], "\r"), s_report[PROF_STAGE_NUM]);
+}
+
+static void bench_wrap(void)
+{
+    int stage;
+
+    Profiler_Reset();
+    memset(s_expect, 0, sizeof(s_expect));
+
+    /* ENTRY 以重装值 0 为起点, 从 0xFF00 开始的阶段打点会跨过 0xFFFF */
+    Profiler_MockSetCounter(0xFF00);
+    Profiler_Begin();
+    Profiler_MockSetCounter(0x0040);
+    Profiler_Mark(PROF_STAGE_ENCODER);
+
+    check(g_profiler.stage[PROF_STAGE_ENCODER].last == 0x0140, "wrap ENC", g_profiler.stage[PROF_STAGE_ENCODER].last, 0x0140);
+
+    for (stage = 0; stage < PROF_STAGE_NUM; stage++)
+    {
+        if (stage != PROF_STAGE_ENTRY && stage != PROF_STAGE_ENCODER)
+        {
+            check(g_profiler.stage[stage].count == 0, "wrap untouched", g_profiler.stage[stage].count, 0);
+        }
+    }
+    printf("wrap      : 0xFF00 -> 0x0040 = %u ticks\n", g_profiler.stage[PROF_STAGE_ENCODER].last);
+}
+
+static void bench_halving(void)
+{
+    long i;
+    uint16 mean_before;
+    const ProfilerStat_t *st = &g_profiler.stage[PROF_STAGE_ENCODER];
+
+    Profiler_Reset();
+
+    /* 两种耗时交替, 平均约 150 (截断为 149); 计数到 0xFFFF 后下一次记录前减半 */
+    for (i = 0; i < 0xFFFFL; i++)
+    {
+        Profiler_MockSetCounter(0);
+        Profiler_Begin();
+        Profiler_MockSetCounter((uint16)((i & 1) ? 200 : 100));
+        Profiler_Mark(PROF_STAGE_ENCODER);
+    }
+    mean_before = Profiler_GetMeanUs(PROF_STAGE_ENCODER);
+    check(st->count == 0xFFFF, "count before halving", st->count, 0xFFFF);
+
+    Profiler_MockSetCounter(0);
+    Profiler_Begin();
+    Profiler_MockSetCounter(150);
+    Profiler_Mark(PROF_STAGE_ENCODER);
+
+    check(st->count == 0x8000, "count after halving", st->count, 0x8000);
+    check(abs((int)Profiler_GetMeanUs(PROF_STAGE_ENCODER) - (int)mean_before) <= 1, "mean after halving",
+          Profiler_GetMeanUs(PROF_STAGE_ENCODER), mean_before);
+    check(st->min == 100 && st->max == 200, "min/max after halving", st->min * 1000L + st->max, 100200L);
+
+    printf("halving   : count 65535 -> %u, mean %u -> %u us\n",
+           st->count, mean_before, Profiler_GetMeanUs(PROF_STAGE_ENCODER));
+}
+
+/*==================================================================================================================
+ *                                              主函数
+ *==================================================================================================================*/
+
+int main(void)
+{
+    bench_aggregation();
+    bench_report();
+    bench_wrap();
+    bench_halving();
+
+    printf("%s: %ld error(s)\n", s_errors ? "FAIL" : "PASS", s_errors);
+    return s_errors ? 1 : 0;
+}
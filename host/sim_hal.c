@@ -0,0 +1,408 @@
+/*********************************************************************************************************************
+ * @file        sim_hal.c
+ * @brief       飞檐走壁智能车 - 主机仿真 HAL 桩 (源文件)
+ * @details     用车辆模型替代 ADC / 编码器 / PWM / IMU, 其余外设 (串口、定时器、延时) 为空实现
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-10
+ ********************************************************************************************************************/
+
+#include <string.h>
+
+#include "zf_common_headfile.h"
+#include "zf_device_imu660ra.h"
+#include "car_config.h"
+#include "sim_model.h"
+#include "sim_hal.h"
+
+/*==================================================================================================================
+ *                                              桩状态
+ *==================================================================================================================*/
+
+static uint8  s_gpio_level[SIM_GPIO_PIN_COUNT];
+static uint32 s_pwm_duty[SIM_PWM_CH_COUNT];
+static double s_encoder_base[SIM_ENCODER_COUNT];    /* 上次清零时的模型累计脉冲 */
+static uint32 s_time_ms = 0;
+static uint8  s_race_mode = 1;
+static uint8  s_uart_echo = 0;
+static FILE  *s_uart_capture = NULL;
+static FILE  *s_debug_capture = NULL;
+
+/* IAP EEPROM 镜像: 与片上 Flash 一致, 写入只能把 1 变 0, 擦除按 512 字节扇区恢复 0xFF */
+#define SIM_EEPROM_SIZE         4096
+#define SIM_EEPROM_SECTOR       512
+static uint8  s_eeprom[SIM_EEPROM_SIZE];
+static uint8  s_eeprom_ready = 0;
+static const char *s_eeprom_file = NULL;
+
+int16 imu660ra_gyro_x = 0, imu660ra_gyro_y = 0, imu660ra_gyro_z = 0;
+int16 imu660ra_acc_x = 0, imu660ra_acc_y = 0, imu660ra_acc_z = 0;
+float imu660ra_transition_factor[2] = {4096, 16.4f};
+
+/*==================================================================================================================
+ *                                              仿真控制接口
+ *==================================================================================================================*/
+
+void SimHal_Reset(uint8 race_mode)
+{
+    int i;
+
+    for (i = 0; i < SIM_GPIO_PIN_COUNT; i++)  s_gpio_level[i] = 1;
+    for (i = 0; i < SIM_PWM_CH_COUNT; i++)    s_pwm_duty[i] = 0;
+    for (i = 0; i < SIM_ENCODER_COUNT; i++)   s_encoder_base[i] = 0.0;
+
+    s_time_ms = 0;
+    s_race_mode = race_mode;
+}
+
+void SimHal_Tick(void)
+{
+    /* 方向引脚 DIR = 1 表示反转 (见 Motor_SetSingle) */
+    g_sim_car.duty_left  = s_gpio_level[MOTOR_LEFT_DIR_PIN]  ? -(double)s_pwm_duty[MOTOR_LEFT_PWM_CH]
+                                                             :  (double)s_pwm_duty[MOTOR_LEFT_PWM_CH];
+    g_sim_car.duty_right = s_gpio_level[MOTOR_RIGHT_DIR_PIN] ? -(double)s_pwm_duty[MOTOR_RIGHT_PWM_CH]
+                                                             :  (double)s_pwm_duty[MOTOR_RIGHT_PWM_CH];
+    g_sim_car.duty_fan   = (double)s_pwm_duty[FAN_PWM_CH];
+
+    s_time_ms += CONTROL_PERIOD_MS;
+}
+
+uint32 SimHal_GetTimeMs(void)
+{
+    return s_time_ms;
+}
+
+void SimHal_SetUartEcho(uint8 enable)
+{
+    s_uart_echo = enable;
+}
+
+void SimHal_SetUartCapture(FILE *fp)
+{
+    s_uart_capture = fp;
+}
+
+void SimHal_SetDebugCapture(FILE *fp)
+{
+    s_debug_capture = fp;
+}
+
+/*==================================================================================================================
+ *                                              GPIO
+ *==================================================================================================================*/
+
+void gpio_init(gpio_pin_enum pin, gpio_dir_enum dir, uint8 dat, gpio_mode_enum mode)
+{
+    (void)dir;
+    (void)mode;
+    s_gpio_level[pin] = dat;
+}
+
+uint8 gpio_get_level(gpio_pin_enum pin)
+{
+    switch (pin)
+    {
+        case IO_P70:    /* 启动按键: 低电平按下 */
+            return (s_time_ms < SIM_KEY_PRESS_MS) ? 0 : 1;
+        case IO_P75:    /* 拨码开关: 低电平 = 比赛模式 */
+            return s_race_mode ? 0 : 1;
+        default:
+            return s_gpio_level[pin];
+    }
+}
+
+void gpio_set_level(gpio_pin_enum pin, uint8 dat)
+{
+    s_gpio_level[pin] = dat ? 1 : 0;
+}
+
+void gpio_toggle_level(gpio_pin_enum pin)
+{
+    s_gpio_level[pin] = !s_gpio_level[pin];
+}
+
+/*==================================================================================================================
+ *                                              PWM
+ *==================================================================================================================*/
+
+void pwm_init(pwm_channel_enum ch, uint32 freq, uint32 duty)
+{
+    (void)freq;
+    s_pwm_duty[ch] = duty;
+}
+
+void pwm_set_duty(pwm_channel_enum ch, uint32 duty)
+{
+    s_pwm_duty[ch] = (duty > PWM_DUTY_MAX) ? PWM_DUTY_MAX : duty;
+}
+
+/*==================================================================================================================
+ *                                              ADC
+ *==================================================================================================================*/
+
+void adc_init(adc_channel_enum ch, adc_resolution_enum resolution)
+{
+    (void)ch;
+    (void)resolution;
+}
+
+uint16 adc_convert(adc_channel_enum ch)
+{
+    return adc_mean_filter_convert(ch, 1);
+}
+
+uint16 adc_mean_filter_convert(adc_channel_enum ch, uint8 count)
+{
+    switch (ch)
+    {
+        case INDUCTOR_LEFT_X_CH:    return SimModel_ReadInductor(SIM_INDUCTOR_LX, count);
+        case INDUCTOR_LEFT_Y_CH:    return SimModel_ReadInductor(SIM_INDUCTOR_LY, count);
+        case INDUCTOR_RIGHT_X_CH:   return SimModel_ReadInductor(SIM_INDUCTOR_RX, count);
+        case INDUCTOR_RIGHT_Y_CH:   return SimModel_ReadInductor(SIM_INDUCTOR_RY, count);
+        case BATTERY_ADC_CH:        return SimModel_ReadBattery();
+        default:                    return 0;
+    }
+}
+
+/*==================================================================================================================
+ *                                              编码器
+ *==================================================================================================================*/
+
+void encoder_dir_init(encoder_index_enum index, gpio_pin_enum dir_pin, encoder_channel_enum ch)
+{
+    (void)dir_pin;
+    (void)ch;
+    s_encoder_base[index] = (index == ENCODER_LEFT_INDEX) ? g_sim_car.enc_left : g_sim_car.enc_right;
+}
+
+int16 encoder_get_count(encoder_index_enum index)
+{
+    double count;
+
+    if (index == ENCODER_LEFT_INDEX)
+    {
+        count = g_sim_car.enc_left - s_encoder_base[index];
+#if ENCODER_LEFT_REVERSE
+        count = -count;
+#endif
+    }
+    else
+    {
+        count = g_sim_car.enc_right - s_encoder_base[index];
+#if ENCODER_RIGHT_REVERSE
+        count = -count;
+#endif
+    }
+    return (int16)count;
+}
+
+void encoder_clear_count(encoder_index_enum index)
+{
+    double total = (index == ENCODER_LEFT_INDEX) ? g_sim_car.enc_left : g_sim_car.enc_right;
+    double delta = total - s_encoder_base[index];
+
+    /* 只扣除已读出的整数部分, 小数部分留到下个周期 (与硬件计数器行为一致) */
+    s_encoder_base[index] += (double)(int32)delta;
+}
+
+/*==================================================================================================================
+ *                                              IMU660RA
+ *==================================================================================================================*/
+
+uint8 imu660ra_init(void)
+{
+    return 0;
+}
+
+void imu660ra_get_acc(void)
+{
+    imu660ra_acc_x = 0;
+    imu660ra_acc_y = 0;
+    imu660ra_acc_z = 4096;      /* ±8g 量程下 1g */
+}
+
+void imu660ra_get_gyro(void)
+{
+    imu660ra_gyro_x = 0;
+    imu660ra_gyro_y = 0;
+    imu660ra_gyro_z = SimModel_ReadGyroZ();
+}
+
+void imu660ra_get_all(imu660ra_data_struct *dat)
+{
+    imu660ra_get_acc();
+    imu660ra_get_gyro();
+    dat->acc_x  = imu660ra_acc_x;
+    dat->acc_y  = imu660ra_acc_y;
+    dat->acc_z  = imu660ra_acc_z;
+    dat->gyro_x = imu660ra_gyro_x;
+    dat->gyro_y = imu660ra_gyro_y;
+    dat->gyro_z = imu660ra_gyro_z;
+}
+
+/*==================================================================================================================
+ *                                              IAP EEPROM
+ *==================================================================================================================*/
+
+static void sim_eeprom_prepare(void)
+{
+    if (!s_eeprom_ready)
+    {
+        memset(s_eeprom, 0xFF, sizeof(s_eeprom));
+        s_eeprom_ready = 1;
+    }
+}
+
+static void sim_eeprom_flush(void)
+{
+    FILE *fp;
+
+    if (s_eeprom_file == NULL || (fp = fopen(s_eeprom_file, "wb")) == NULL)
+    {
+        return;
+    }
+    fwrite(s_eeprom, 1, sizeof(s_eeprom), fp);
+    fclose(fp);
+}
+
+int SimHal_SetEepromFile(const char *path)
+{
+    FILE *fp;
+
+    memset(s_eeprom, 0xFF, sizeof(s_eeprom));
+    s_eeprom_ready = 1;
+    s_eeprom_file = path;
+    if (path == NULL)
+    {
+        return 0;
+    }
+
+    if ((fp = fopen(path, "rb")) != NULL)
+    {
+        if (fread(s_eeprom, 1, sizeof(s_eeprom), fp) != sizeof(s_eeprom))
+        {
+            memset(s_eeprom, 0xFF, sizeof(s_eeprom));      /* 长度不对: 按新芯片处理 */
+        }
+        fclose(fp);
+        return 0;
+    }
+
+    /* 文件不存在: 先建一个擦除状态的镜像 */
+    if ((fp = fopen(path, "wb")) == NULL)
+    {
+        return -1;
+    }
+    fclose(fp);
+    sim_eeprom_flush();
+    return 0;
+}
+
+void iap_init(void)
+{
+    sim_eeprom_prepare();
+}
+
+void iap_read_bytes(uint32 addr, uint8 *buf, uint16 len)
+{
+    sim_eeprom_prepare();
+    while (len--)
+    {
+        *buf++ = (addr < SIM_EEPROM_SIZE) ? s_eeprom[addr] : 0xFF;
+        addr++;
+    }
+}
+
+void iap_write_bytes(uint32 addr, uint8 *buf, uint16 len)
+{
+    sim_eeprom_prepare();
+    while (len--)
+    {
+        if (addr < SIM_EEPROM_SIZE)
+        {
+            s_eeprom[addr] &= *buf;
+        }
+        addr++;
+        buf++;
+    }
+    sim_eeprom_flush();
+}
+
+void iap_erase_page(uint32 addr)
+{
+    sim_eeprom_prepare();
+    addr &= ~(uint32)(SIM_EEPROM_SECTOR - 1);
+    if (addr < SIM_EEPROM_SIZE)
+    {
+        memset(&s_eeprom[addr], 0xFF, SIM_EEPROM_SECTOR);
+    }
+    sim_eeprom_flush();
+}
+
+/*==================================================================================================================
+ *                                              串口 / 定时器 / 中断
+ *==================================================================================================================*/
+
+void uart_init(uart_index_enum index, uint32 baud, uart_tx_pin_enum tx, uart_rx_pin_enum rx)
+{
+    (void)index;
+    (void)baud;
+    (void)tx;
+    (void)rx;
+}
+
+void uart_rx_interrupt(uart_index_enum index, uint8 status)
+{
+    (void)index;
+    (void)status;
+}
+
+void uart_write_byte(uart_index_enum index, uint8 dat)
+{
+    if (s_uart_capture != NULL && index == BLUETOOTH_UART_INDEX)
+    {
+        fputc(dat, s_uart_capture);
+    }
+    if (s_debug_capture != NULL && index == CAR_DEBUG_UART_INDEX)
+    {
+        fputc(dat, s_debug_capture);
+    }
+    if (s_uart_echo)
+    {
+        fputc(dat, stderr);
+    }
+}
+
+void uart_write_buffer(uart_index_enum index, const uint8 *buff, uint32 len)
+{
+    while (len--)
+    {
+        uart_write_byte(index, *buff++);
+    }
+}
+
+void uart_write_string(uart_index_enum index, const char *str)
+{
+    while (*str)
+    {
+        uart_write_byte(index, (uint8)*str++);
+    }
+}
+
+void pit_ms_init(pit_index_enum index, uint16 ms)
+{
+    (void)index;
+    (void)ms;
+}
+
+void system_delay_ms(uint16 ms)
+{
+    (void)ms;
+}
+
+void interrupt_global_enable(void)
+{
+}
+
+void interrupt_global_disable(void)
+{
+}
@@ -0,0 +1,60 @@
+/*********************************************************************************************************************
+ * @file        sim_hal.h
+ * @brief       飞檐走壁智能车 - 主机仿真 HAL 桩控制接口 (头文件)
+ * @details     sim_hal.c 实现 zf_common_headfile.h 与 zf_device_imu660ra.h 中的外设函数,
+ *              这里只声明仿真主程序需要的额外控制接口
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-10
+ ********************************************************************************************************************/
+
+#ifndef __SIM_HAL_H__
+#define __SIM_HAL_H__
+
+#include <stdio.h>
+
+#include "zf_common_typedef.h"
+
+#define SIM_KEY_PRESS_MS        100         /* 仿真开始后启动按键保持按下的时间 (ms) */
+
+/**
+ * @brief   复位 HAL 状态 (引脚、PWM、编码器基准、仿真时钟)
+ * @param   race_mode   1 = 拨码开关置比赛模式, 0 = 调车模式
+ */
+void SimHal_Reset(uint8 race_mode);
+
+/**
+ * @brief   仿真时钟前进一个控制周期, 同时把 PWM 输出同步到车辆模型
+ */
+void SimHal_Tick(void);
+
+/**
+ * @brief   当前仿真时间 (ms)
+ */
+uint32 SimHal_GetTimeMs(void);
+
+/**
+ * @brief   是否把串口输出打印到 stderr
+ */
+void SimHal_SetUartEcho(uint8 enable);
+
+/**
+ * @brief   把蓝牙串口 (UART4) 发出的原始字节写入文件 (NULL = 不保存)
+ * @note    配合 host/telemetry_decode.c 解码遥测帧
+ */
+void SimHal_SetUartCapture(FILE *fp);
+
+/**
+ * @brief   把调试串口 (UART2) 发出的原始字节写入文件 (NULL = 不保存)
+ * @note    黑匣子导出走调试串口, 同样用 host/telemetry_decode.c 解码
+ */
+void SimHal_SetDebugCapture(FILE *fp);
+
+/**
+ * @brief   IAP EEPROM 镜像文件 (NULL = 只在内存中, 每次仿真从擦除状态开始)
+ * @note    文件存在时读入镜像, 之后每次擦写都写回文件, 参数存储可跨多次运行保留
+ * @return  0 = 成功, -1 = 文件无法写入
+ */
+int SimHal_SetEepromFile(const char *path);
+
+#endif /* __SIM_HAL_H__ */
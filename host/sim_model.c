@@ -0,0 +1,420 @@
+/*********************************************************************************************************************
+ * @file        sim_model.c
+ * @brief       飞檐走壁智能车 - 主机仿真车辆与赛道模型 (源文件)
+ * @details     赛道由"画笔"指令 (直线 / 圆弧 / 折角) 生成, 导线按折线段计算磁场,
+ *              中心线按 5mm 间距采样, 用于计算横向偏差和圈数
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-10
+ ********************************************************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include "sim_model.h"
+
+/*==================================================================================================================
+ *                                              赛道描述
+ *==================================================================================================================*/
+
+typedef enum
+{
+    SIM_SEG_LINE = 0,           /* 直线: a = 长度 (m) */
+    SIM_SEG_ARC,                /* 圆弧: a = 半径 (m), b = 转角 (度, 左转为正) */
+    SIM_SEG_CORNER              /* 折角: b = 转角 (度, 左转为正), 不产生长度 */
+} SimSegType_t;
+
+typedef struct
+{
+    SimSegType_t type;
+    double a;
+    double b;
+} SimTrackCmd_t;
+
+typedef struct
+{
+    double x, y;
+} SimPoint_t;
+
+/*
+ * 默认赛道 (逆时针闭环, 约 12.2m):
+ * 下边直道 (中部有十字) -> R0.4 圆弧 -> 右边直道 -> 90°直角 -> 上边两组 45° 折线 -> 90°直角 -> 左边直道 -> 90°直角
+ */
+static const SimTrackCmd_t s_default_track[] = {
+    { SIM_SEG_LINE,   3.0,       0.0 },
+    { SIM_SEG_ARC,    0.4,      90.0 },
+    { SIM_SEG_LINE,   1.2,       0.0 },
+    { SIM_SEG_CORNER, 0.0,      90.0 },
+    { SIM_SEG_LINE,   1.0,       0.0 },
+    { SIM_SEG_CORNER, 0.0,      45.0 },
+    { SIM_SEG_LINE,   0.3,       0.0 },
+    { SIM_SEG_CORNER, 0.0,     -90.0 },
+    { SIM_SEG_LINE,   0.3,       0.0 },
+    { SIM_SEG_CORNER, 0.0,      90.0 },
+    { SIM_SEG_LINE,   0.3,       0.0 },
+    { SIM_SEG_CORNER, 0.0,     -90.0 },
+    { SIM_SEG_LINE,   0.3,       0.0 },
+    { SIM_SEG_CORNER, 0.0,      45.0 },
+    { SIM_SEG_LINE,   2.551472,  0.0 },
+    { SIM_SEG_CORNER, 0.0,      90.0 },
+    { SIM_SEG_LINE,   1.6,       0.0 },
+    { SIM_SEG_CORNER, 0.0,      90.0 },
+    { SIM_SEG_LINE,   1.0,       0.0 },
+};
+
+/* 不属于行驶路线的附加导线 (十字路口横线) */
+static const SimPoint_t s_extra_wires[][2] = {
+    { { 1.5, -0.6 }, { 1.5, 0.6 } },
+};
+
+#define SIM_MAX_VERTICES        256
+#define SIM_MAX_ROUTE_POINTS    8192
+#define SIM_ROUTE_STEP          0.005       /* 中心线采样间距 (m) */
+#define SIM_ARC_STEP_DEG        5.0         /* 圆弧离散角度 (度) */
+#define SIM_LOCATE_WINDOW       120         /* 定位时前后搜索的采样点数 */
+#define SIM_PI                  3.14159265358979323846
+
+/*==================================================================================================================
+ *                                              模型状态
+ *==================================================================================================================*/
+
+SimCar_t      g_sim_car;
+SimProgress_t g_sim_progress;
+
+static SimPoint_t s_vertices[SIM_MAX_VERTICES];     /* 导线折线顶点 (首尾相同, 闭环) */
+static int        s_vertex_count = 0;
+
+static SimPoint_t s_route[SIM_MAX_ROUTE_POINTS];    /* 中心线采样点 */
+static SimPoint_t s_route_dir[SIM_MAX_ROUTE_POINTS];/* 采样点处切向量 */
+static int        s_route_count = 0;
+static int        s_route_index = 0;                /* 上次定位的采样点 */
+static double     s_track_length = 0.0;
+
+static double     s_adc_noise = 0.0;
+static uint32     s_rand_state = 1;
+
+/*==================================================================================================================
+ *                                              噪声 (确定性, 便于复现)
+ *==================================================================================================================*/
+
+static double sim_rand_uniform(void)
+{
+    s_rand_state = s_rand_state * 1664525u + 1013904223u;
+    return (double)(s_rand_state >> 8) / 16777216.0;
+}
+
+static double sim_rand_gauss(void)
+{
+    /* 12 个均匀分布求和近似正态分布 */
+    double sum = 0.0;
+    int i;
+
+    for (i = 0; i < 12; i++)
+    {
+        sum += sim_rand_uniform();
+    }
+    return sum - 6.0;
+}
+
+/*==================================================================================================================
+ *                                              赛道生成
+ *==================================================================================================================*/
+
+static void sim_add_vertex(double x, double y)
+{
+    if (s_vertex_count < SIM_MAX_VERTICES)
+    {
+        s_vertices[s_vertex_count].x = x;
+        s_vertices[s_vertex_count].y = y;
+        s_vertex_count++;
+    }
+}
+
+static void sim_build_track(const SimTrackCmd_t *cmds, int count)
+{
+    double x = 0.0, y = 0.0, heading = 0.0;
+    int i, j, steps;
+    double step, cx, cy, start_angle, sign;
+
+    s_vertex_count = 0;
+    sim_add_vertex(x, y);
+
+    for (i = 0; i < count; i++)
+    {
+        switch (cmds[i].type)
+        {
+            case SIM_SEG_LINE:
+                x += cmds[i].a * cos(heading);
+                y += cmds[i].a * sin(heading);
+                sim_add_vertex(x, y);
+                break;
+
+            case SIM_SEG_ARC:
+                /* 圆心在行驶方向左侧 (左转) 或右侧 (右转) */
+                sign = (cmds[i].b >= 0.0) ? 1.0 : -1.0;
+                cx = x - sign * cmds[i].a * sin(heading);
+                cy = y + sign * cmds[i].a * cos(heading);
+                start_angle = atan2(y - cy, x - cx);
+                steps = (int)ceil(fabs(cmds[i].b) / SIM_ARC_STEP_DEG);
+                step = cmds[i].b / steps * SIM_PI / 180.0;
+                for (j = 1; j <= steps; j++)
+                {
+                    x = cx + cmds[i].a * cos(start_angle + step * j);
+                    y = cy + cmds[i].a * sin(start_angle + step * j);
+                    sim_add_vertex(x, y);
+                }
+                heading += cmds[i].b * SIM_PI / 180.0;
+                break;
+
+            case SIM_SEG_CORNER:
+                heading += cmds[i].b * SIM_PI / 180.0;
+                break;
+        }
+    }
+
+    if (hypot(x - s_vertices[0].x, y - s_vertices[0].y) > 0.005)
+    {
+        fprintf(stderr, "sim: track does not close (gap %.4f m)\n", hypot(x, y));
+    }
+}
+
+static void sim_build_route(void)
+{
+    int i;
+    double seg_len, dx, dy, t;
+
+    s_route_count = 0;
+    s_track_length = 0.0;
+
+    for (i = 0; i + 1 < s_vertex_count; i++)
+    {
+        dx = s_vertices[i + 1].x - s_vertices[i].x;
+        dy = s_vertices[i + 1].y - s_vertices[i].y;
+        seg_len = hypot(dx, dy);
+        if (seg_len <= 0.0)
+        {
+            continue;
+        }
+
+        for (t = 0.0; t < seg_len && s_route_count < SIM_MAX_ROUTE_POINTS; t += SIM_ROUTE_STEP)
+        {
+            s_route[s_route_count].x = s_vertices[i].x + dx * t / seg_len;
+            s_route[s_route_count].y = s_vertices[i].y + dy * t / seg_len;
+            s_route_dir[s_route_count].x = dx / seg_len;
+            s_route_dir[s_route_count].y = dy / seg_len;
+            s_route_count++;
+        }
+        s_track_length += seg_len;
+    }
+}
+
+/*==================================================================================================================
+ *                                              磁场计算
+ *==================================================================================================================*/
+
+/**
+ * @brief   有限长直导线 A->B 在离地 h 处点 P 产生的水平磁场 (任意单位)
+ * @note    B = (1/R)(sinα2 - sinα1), 方向为 u × ρ, 导线在地面 (z=0)
+ */
+static void sim_segment_field(SimPoint_t a, SimPoint_t b, double px, double py, double h,
+                              double *bx, double *by)
+{
+    double ux, uy, len, rx, ry, t, perp_x, perp_y, r, mag;
+
+    ux = b.x - a.x;
+    uy = b.y - a.y;
+    len = hypot(ux, uy);
+    if (len <= 0.0)
+    {
+        return;
+    }
+    ux /= len;
+    uy /= len;
+
+    rx = px - a.x;
+    ry = py - a.y;
+    t = rx * ux + ry * uy;
+    perp_x = rx - t * ux;
+    perp_y = ry - t * uy;
+    r = sqrt(perp_x * perp_x + perp_y * perp_y + h * h);
+
+    mag = ((len - t) / sqrt((len - t) * (len - t) + r * r) + t / sqrt(t * t + r * r)) / r;
+
+    /* u × ρ̂ 的水平分量: (uy·ρz, -ux·ρz) / r, ρz = h */
+    *bx += mag * uy * h / r;
+    *by += -mag * ux * h / r;
+}
+
+static void sim_field_at(double px, double py, double *bx, double *by)
+{
+    int i;
+    unsigned k;
+
+    *bx = 0.0;
+    *by = 0.0;
+
+    for (i = 0; i + 1 < s_vertex_count; i++)
+    {
+        sim_segment_field(s_vertices[i], s_vertices[i + 1], px, py, SIM_SENSOR_HEIGHT, bx, by);
+    }
+    for (k = 0; k < sizeof(s_extra_wires) / sizeof(s_extra_wires[0]); k++)
+    {
+        sim_segment_field(s_extra_wires[k][0], s_extra_wires[k][1], px, py, SIM_SENSOR_HEIGHT, bx, by);
+    }
+}
+
+/*==================================================================================================================
+ *                                              定位
+ *==================================================================================================================*/
+
+static void sim_locate(int full_search)
+{
+    int i, k, from, to, best;
+    double best_d2, d2, dx, dy, s_new, ds;
+
+    best = s_route_index;
+    best_d2 = 1e30;
+
+    from = full_search ? 0 : s_route_index - SIM_LOCATE_WINDOW;
+    to   = full_search ? s_route_count - 1 : s_route_index + SIM_LOCATE_WINDOW;
+
+    for (k = from; k <= to; k++)
+    {
+        i = ((k % s_route_count) + s_route_count) % s_route_count;
+        dx = g_sim_car.x - s_route[i].x;
+        dy = g_sim_car.y - s_route[i].y;
+        d2 = dx * dx + dy * dy;
+        if (d2 < best_d2)
+        {
+            best_d2 = d2;
+            best = i;
+        }
+    }
+
+    s_route_index = best;
+    dx = g_sim_car.x - s_route[best].x;
+    dy = g_sim_car.y - s_route[best].y;
+    g_sim_progress.xte = s_route_dir[best].x * dy - s_route_dir[best].y * dx;
+
+    s_new = best * SIM_ROUTE_STEP;
+    if (!full_search)
+    {
+        ds = s_new - g_sim_progress.s;
+        if (ds >  s_track_length / 2) ds -= s_track_length;
+        if (ds < -s_track_length / 2) ds += s_track_length;
+        g_sim_progress.travelled += ds;
+    }
+    g_sim_progress.s = s_new;
+}
+
+/*==================================================================================================================
+ *                                              对外接口
+ *==================================================================================================================*/
+
+void SimModel_Init(double adc_noise, uint32 seed)
+{
+    sim_build_track(s_default_track, (int)(sizeof(s_default_track) / sizeof(s_default_track[0])));
+    sim_build_route();
+
+    s_adc_noise  = adc_noise;
+    s_rand_state = seed ? seed : 1;
+
+    g_sim_car.x = s_route[0].x;
+    g_sim_car.y = s_route[0].y;
+    g_sim_car.heading = atan2(s_route_dir[0].y, s_route_dir[0].x);
+    g_sim_car.v_left = g_sim_car.v_right = 0.0;
+    g_sim_car.omega = 0.0;
+    g_sim_car.duty_left = g_sim_car.duty_right = g_sim_car.duty_fan = 0.0;
+    g_sim_car.enc_left = g_sim_car.enc_right = 0.0;
+    g_sim_car.battery_v = SIM_BATTERY_OCV;
+
+    g_sim_progress.s = 0.0;
+    g_sim_progress.xte = 0.0;
+    g_sim_progress.travelled = 0.0;
+    s_route_index = 0;
+    sim_locate(1);
+}
+
+void SimModel_Step(void)
+{
+    int i;
+    double dt = SIM_CONTROL_DT / SIM_PHYSICS_SUBSTEPS;
+    double v_scale, target_l, target_r, v, current;
+
+    for (i = 0; i < SIM_PHYSICS_SUBSTEPS; i++)
+    {
+        /* 电池端电压随负载下降 */
+        current = (fabs(g_sim_car.duty_left) + fabs(g_sim_car.duty_right)) / 10000.0 * SIM_MOTOR_CURRENT_MAX
+                + g_sim_car.duty_fan / 10000.0 * SIM_FAN_CURRENT_MAX;
+        g_sim_car.battery_v = SIM_BATTERY_OCV - SIM_BATTERY_RES * current;
+
+        /* 一阶电机模型: 稳态轮速与占空比、电压成正比 */
+        v_scale  = SIM_WHEEL_SPEED_MAX * g_sim_car.battery_v / 12.0 / 10000.0;
+        target_l = g_sim_car.duty_left  * v_scale;
+        target_r = g_sim_car.duty_right * v_scale;
+        g_sim_car.v_left  += (target_l - g_sim_car.v_left)  * dt / SIM_MOTOR_TAU;
+        g_sim_car.v_right += (target_r - g_sim_car.v_right) * dt / SIM_MOTOR_TAU;
+
+        /* 差速运动学 */
+        v = (g_sim_car.v_left + g_sim_car.v_right) / 2.0;
+        g_sim_car.omega = (g_sim_car.v_right - g_sim_car.v_left) / SIM_TRACK_WIDTH;
+        g_sim_car.heading += g_sim_car.omega * dt;
+        g_sim_car.x += v * cos(g_sim_car.heading) * dt;
+        g_sim_car.y += v * sin(g_sim_car.heading) * dt;
+
+        g_sim_car.enc_left  += g_sim_car.v_left  * dt / SIM_METERS_PER_COUNT;
+        g_sim_car.enc_right += g_sim_car.v_right * dt / SIM_METERS_PER_COUNT;
+    }
+
+    sim_locate(0);
+}
+
+double SimModel_TrackLength(void)
+{
+    return s_track_length;
+}
+
+uint16 SimModel_ReadInductor(SimInductor_t which, uint8 count)
+{
+    double c = cos(g_sim_car.heading), s = sin(g_sim_car.heading);
+    double lateral, px, py, bx, by, proj, adc;
+
+    lateral = (which == SIM_INDUCTOR_LX || which == SIM_INDUCTOR_LY) ? SIM_SENSOR_LATERAL : -SIM_SENSOR_LATERAL;
+    px = g_sim_car.x + SIM_SENSOR_FORWARD * c - lateral * s;
+    py = g_sim_car.y + SIM_SENSOR_FORWARD * s + lateral * c;
+
+    sim_field_at(px, py, &bx, &by);
+
+    /* 横向电感轴线沿车体 y 方向, 纵向电感轴线沿车体 x 方向 */
+    if (which == SIM_INDUCTOR_LX || which == SIM_INDUCTOR_RX)
+    {
+        proj = -bx * s + by * c;
+    }
+    else
+    {
+        proj = bx * c + by * s;
+    }
+
+    adc = SIM_ADC_OFFSET + SIM_ADC_GAIN * fabs(proj);
+    if (s_adc_noise > 0.0)
+    {
+        adc += sim_rand_gauss() * s_adc_noise / sqrt(count ? count : 1);
+    }
+    if (adc < 0.0)    adc = 0.0;
+    if (adc > 4095.0) adc = 4095.0;
+    return (uint16)adc;
+}
+
+uint16 SimModel_ReadBattery(void)
+{
+    return (uint16)(g_sim_car.battery_v / 11.0 / 3.3 * 4095.0);
+}
+
+int16 SimModel_ReadGyroZ(void)
+{
+    /* ±2000dps 量程: 16.4 LSB/(°/s); 控制代码约定右转为正 */
+    double raw = -g_sim_car.omega * 180.0 / SIM_PI * 16.4;
+
+    if (raw >  32767.0) raw =  32767.0;
+    if (raw < -32767.0) raw = -32767.0;
+    return (int16)raw;
+}
@@ -0,0 +1,117 @@
+/*********************************************************************************************************************
+ * @file        sim_model.h
+ * @brief       飞檐走壁智能车 - 主机仿真车辆与赛道模型 (头文件)
+ * @details     差速小车运动学 + 一阶电机模型 + 电磁线磁场 (Biot-Savart 有限长导线) + 传感器合成
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-10
+ *
+ * @note        坐标约定: 世界坐标 x/y (m), 航向角逆时针为正 (rad)
+ *              车体坐标: 前进方向为 +x, 左侧为 +y
+ ********************************************************************************************************************/
+
+#ifndef __SIM_MODEL_H__
+#define __SIM_MODEL_H__
+
+#include "zf_common_typedef.h"
+
+/*==================================================================================================================
+ *                                              模型参数
+ *==================================================================================================================*/
+
+#define SIM_CONTROL_DT          0.005       /* 控制周期 (s), 与 CONTROL_PERIOD_MS 一致 */
+#define SIM_PHYSICS_SUBSTEPS    5           /* 每个控制周期内的物理积分步数 */
+
+#define SIM_TRACK_WIDTH         0.155       /* 左右轮距 (m) */
+#define SIM_METERS_PER_COUNT    0.00005     /* 每个编码器脉冲对应里程 (m), 速度50 ≈ 0.5m/s */
+#define SIM_WHEEL_SPEED_MAX     5.0         /* 满占空比、标称电压下的轮速 (m/s) */
+#define SIM_MOTOR_TAU           0.08        /* 电机一阶时间常数 (s) */
+
+#define SIM_SENSOR_FORWARD      0.20        /* 电感前瞻距离 (m, 相对轮轴中心) */
+#define SIM_SENSOR_LATERAL      0.08        /* 左右电感组横向偏移 (m) */
+#define SIM_SENSOR_HEIGHT       0.05        /* 电感离地高度 (m) */
+#define SIM_ADC_OFFSET          200.0       /* 无信号时的 ADC 底噪 */
+#define SIM_ADC_GAIN            85.0        /* 磁场强度 -> ADC 增益 */
+
+#define SIM_BATTERY_OCV         12.3        /* 电池开路电压 (V) */
+#define SIM_BATTERY_RES         0.08        /* 电池内阻 (Ω) */
+#define SIM_MOTOR_CURRENT_MAX   3.0         /* 单电机满占空比电流 (A) */
+#define SIM_FAN_CURRENT_MAX     5.0         /* 风扇满占空比电流 (A) */
+
+#define SIM_CRASH_DISTANCE      0.30        /* 横向偏离超过此值判定冲出赛道 (m) */
+
+/*==================================================================================================================
+ *                                              数据结构
+ *==================================================================================================================*/
+
+typedef enum
+{
+    SIM_INDUCTOR_LX = 0,
+    SIM_INDUCTOR_LY,
+    SIM_INDUCTOR_RX,
+    SIM_INDUCTOR_RY
+} SimInductor_t;
+
+typedef struct
+{
+    double x, y;                /* 轮轴中心位置 (m) */
+    double heading;             /* 航向角 (rad, 逆时针为正) */
+    double v_left, v_right;     /* 左右轮线速度 (m/s) */
+    double omega;               /* 偏航角速度 (rad/s, 逆时针为正) */
+    double duty_left;           /* 左电机占空比 (带方向, -10000~10000) */
+    double duty_right;          /* 右电机占空比 */
+    double duty_fan;            /* 风扇占空比 (0~10000) */
+    double enc_left;            /* 左编码器累计脉冲 (含小数, 前进为正) */
+    double enc_right;           /* 右编码器累计脉冲 */
+    double battery_v;           /* 电池端电压 (V) */
+} SimCar_t;
+
+typedef struct
+{
+    double s;                   /* 沿赛道中心线的弧长位置 (m) */
+    double xte;                 /* 横向偏差 (m, 车在线左侧为正) */
+    double travelled;           /* 沿赛道累计前进距离 (m) */
+} SimProgress_t;
+
+extern SimCar_t      g_sim_car;
+extern SimProgress_t g_sim_progress;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   建立默认赛道并把小车放到起点
+ * @param   adc_noise   ADC 噪声标准差 (LSB), 0 = 无噪声
+ * @param   seed        噪声随机种子
+ */
+void SimModel_Init(double adc_noise, uint32 seed);
+
+/**
+ * @brief   物理推进一个控制周期
+ */
+void SimModel_Step(void);
+
+/**
+ * @brief   赛道中心线总长 (m)
+ */
+double SimModel_TrackLength(void);
+
+/**
+ * @brief   合成单个电感的 ADC 读数
+ * @param   which       电感编号
+ * @param   count       均值滤波次数 (用于缩小噪声)
+ */
+uint16 SimModel_ReadInductor(SimInductor_t which, uint8 count);
+
+/**
+ * @brief   合成电池分压采样 ADC 读数 (1/11 分压, 3.3V 参考)
+ */
+uint16 SimModel_ReadBattery(void);
+
+/**
+ * @brief   合成陀螺仪 Z 轴原始值 (±2000dps 量程, 右转为正)
+ */
+int16 SimModel_ReadGyroZ(void);
+
+#endif /* __SIM_MODEL_H__ */
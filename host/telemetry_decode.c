@@ -0,0 +1,209 @@
+/*********************************************************************************************************************
+ * @file        telemetry_decode.c
+ * @brief       飞檐走壁智能车 - 二进制遥测解码工具 (上位机)
+ * @details     从蓝牙串口原始字节流中找出遥测帧, 校验 CRC 后按字段输出 CSV
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-15
+ *
+ * @note        编译 (仓库根目录):
+ *              gcc -O2 -Wall -DCAR_HOST_BUILD -Ihost/hal -Iuser -I. -o telemetry_decode host/telemetry_decode.c
+ *
+ *              用法:
+ *              ./telemetry_decode [FILE]           不给文件时从 stdin 读取
+ *              CSV 输出到 stdout, 帧数 / CRC 错误 / 丢帧统计输出到 stderr
+ *              本帧未包含的字段留空; 字节流中夹杂的文本 (如 $PRF 报告) 会被跳过
+ *              黑匣子导出 (调试串口 UART2, 见 user/blackbox.h) 也是同样的帧, 直接用本工具转换;
+ *              这时 seq 为记录序号 (从最早一条开始), tick 为控制周期计数 (×5ms 即时间)
+ *
+ *              帧格式见 user/telemetry.h
+ ********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "telemetry.h"
+
+/*==================================================================================================================
+ *                                              帧解析
+ *==================================================================================================================*/
+
+static const uint8 s_field_size[TEL_FIELD_NUM] = TELEMETRY_FIELD_SIZES;
+
+/* 与 Telemetry_Crc16 相同: CRC-16/CCITT-FALSE */
+static uint16 decode_crc16(const uint8 *dat, int len)
+{
+    uint16 crc = 0xFFFF;
+    int i;
+
+    while (len--)
+    {
+        crc ^= (uint16)(*dat++) << 8;
+        for (i = 0; i < 8; i++)
+        {
+            crc = (crc & 0x8000) ? (uint16)((crc << 1) ^ 0x1021) : (uint16)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16 get_u16(const uint8 *p)
+{
+    return (uint16)(p[0] | (p[1] << 8));
+}
+
+static int get_payload_len(uint16 mask)
+{
+    int i, len = 0;
+
+    for (i = 0; i < TEL_FIELD_NUM; i++)
+    {
+        if (mask & TEL_MASK(i))
+        {
+            len += s_field_size[i];
+        }
+    }
+    return len;
+}
+
+static void print_header(void)
+{
+    printf("seq,mask,tick,ind_err,left_mag,right_mag,ind_sum,enc_left,enc_right,dir_out,"
+           "pwm_left,pwm_right,element,elem_state,battery_v,pitch_deg,yaw_deg,"
+           "raw_lx,raw_ly,raw_rx,raw_ry,norm_lx,norm_ly,norm_rx,norm_ry\n");
+}
+
+/* 输出一帧; 未包含的字段输出空列 */
+static void print_frame(uint8 seq, uint16 mask, const uint8 *p)
+{
+    printf("%u,0x%04X", seq, mask);
+
+    if (mask & TEL_MASK(TEL_FIELD_TICK))     { printf(",%u", get_u16(p)); p += 2; }
+    else                                     { printf(","); }
+    if (mask & TEL_MASK(TEL_FIELD_IND_ERR))  { printf(",%d", (int16)get_u16(p)); p += 2; }
+    else                                     { printf(","); }
+    if (mask & TEL_MASK(TEL_FIELD_IND_MAG))  { printf(",%u,%u,%u", p[0], p[1], p[2]); p += 3; }
+    else                                     { printf(",,,"); }
+    if (mask & TEL_MASK(TEL_FIELD_ENCODER))  { printf(",%d,%d", (int16)get_u16(p), (int16)get_u16(p + 2)); p += 4; }
+    else                                     { printf(",,"); }
+    if (mask & TEL_MASK(TEL_FIELD_DIR_OUT))  { printf(",%d", (int16)get_u16(p)); p += 2; }
+    else                                     { printf(","); }
+    if (mask & TEL_MASK(TEL_FIELD_PWM))      { printf(",%d,%d", (int16)get_u16(p), (int16)get_u16(p + 2)); p += 4; }
+    else                                     { printf(",,"); }
+    if (mask & TEL_MASK(TEL_FIELD_ELEMENT))  { printf(",%u,%u", p[0], p[1]); p += 2; }
+    else                                     { printf(",,"); }
+    if (mask & TEL_MASK(TEL_FIELD_BATTERY))  { printf(",%.2f", get_u16(p) / 100.0); p += 2; }
+    else                                     { printf(","); }
+    if (mask & TEL_MASK(TEL_FIELD_ATTITUDE)) { printf(",%.2f,%.2f", (int16)get_u16(p) / 100.0, (int16)get_u16(p + 2) / 100.0); p += 4; }
+    else                                     { printf(",,"); }
+    if (mask & TEL_MASK(TEL_FIELD_IND_RAW))  { printf(",%u,%u,%u,%u", get_u16(p), get_u16(p + 2), get_u16(p + 4), get_u16(p + 6)); p += 8; }
+    else                                     { printf(",,,,"); }
+    if (mask & TEL_MASK(TEL_FIELD_IND_NORM)) { printf(",%u,%u,%u,%u", p[0], p[1], p[2], p[3]); p += 4; }
+    else                                     { printf(",,,,"); }
+
+    printf("\n");
+}
+
+/*==================================================================================================================
+ *                                              主函数
+ *==================================================================================================================*/
+
+int main(int argc, char **argv)
+{
+    FILE *fp = stdin;
+    uint8 *buf = NULL;
+    size_t cap = 0, n = 0, i = 0;
+    long frames = 0, crc_errors = 0, seq_gaps = 0, skipped = 0;
+    int last_seq = -1;
+
+    if (argc > 2)
+    {
+        fprintf(stderr, "usage: %s [FILE]\n", argv[0]);
+        return 1;
+    }
+    if (argc == 2 && (fp = fopen(argv[1], "rb")) == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    /* 全部读入内存 (遥测文件通常只有几百 KB) */
+    for (;;)
+    {
+        size_t got;
+
+        if (n == cap)
+        {
+            cap = cap ? cap * 2 : 65536;
+            if ((buf = realloc(buf, cap)) == NULL)
+            {
+                fprintf(stderr, "out of memory\n");
+                return 1;
+            }
+        }
+        got = fread(buf + n, 1, cap - n, fp);
+        if (got == 0)
+        {
+            break;
+        }
+        n += got;
+    }
+    if (fp != stdin)
+    {
+        fclose(fp);
+    }
+
+    print_header();
+    while (i + TELEMETRY_HEADER_LEN <= n)
+    {
+        uint8 seq, len;
+        uint16 mask;
+        size_t total;
+
+        if (buf[i] != TELEMETRY_SYNC0 || buf[i + 1] != TELEMETRY_SYNC1)
+        {
+            i++;
+            skipped++;
+            continue;
+        }
+
+        seq  = buf[i + 2];
+        len  = buf[i + 3];
+        mask = get_u16(&buf[i + 4]);
+        total = TELEMETRY_HEADER_LEN + len + TELEMETRY_CRC_LEN;
+
+        /* 长度与掩码不符: 不是帧头, 只是数据里恰好出现了同步字 */
+        if (len > TELEMETRY_PAYLOAD_MAX || (mask & ~TEL_MASK_ALL) || get_payload_len(mask) != len)
+        {
+            i++;
+            skipped++;
+            continue;
+        }
+        if (i + total > n)
+        {
+            break;
+        }
+        if (decode_crc16(&buf[i + 2], len + 4) != get_u16(&buf[i + TELEMETRY_HEADER_LEN + len]))
+        {
+            crc_errors++;
+            i++;
+            skipped++;
+            continue;
+        }
+
+        if (last_seq >= 0 && seq != (uint8)(last_seq + 1))
+        {
+            seq_gaps += (uint8)(seq - last_seq - 1);
+        }
+        last_seq = seq;
+
+        print_frame(seq, mask, &buf[i + TELEMETRY_HEADER_LEN]);
+        frames++;
+        i += total;
+    }
+
+    fprintf(stderr, "frames %ld, crc errors %ld, lost frames %ld, skipped bytes %ld\n",
+            frames, crc_errors, seq_gaps, skipped + (long)(n - i));
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,537 @@
+/*********************************************************************************************************************
+ * @file        trace_replay.c
+ * @brief       飞檐走壁智能车 - 记录回放工具 (上位机)
+ * @details     把实车记录的逐周期原始数据 (黑匣子导出经 telemetry_decode 转成的 CSV) 重新送入
+ *              电感解算 (Inductor_Process) 和固件的控制链 (System_ControlStep: 元素识别、转向、速度环),
+ *              输出带时间戳的元素识别事件和逐周期控制输出; 修改元素阈值后对一批实车记录回放比较即可回归测试
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-28
+ *
+ * @note        编译 (仓库根目录):
+ *              gcc -O2 -Wall -DCAR_HOST_BUILD -Ihost/hal -Iuser -I. -o trace_replay \
+ *                  host/sim_hal.c host/sim_model.c host/trace_replay.c \
+ *                  user/pid.c user/inductor.c user/element.c user/system.c user/motor.c \
+ *                  user/encoder.c user/battery.c user/fan.c user/bluetooth.c user/key.c \
+ *                  user/adc_scan.c user/profiler.c user/attitude.c user/telemetry.c \
+ *                  user/oled.c user/debug_display.c user/track_map.c user/pose.c \
+ *                  user/steer.c user/inductor_cal.c user/param_store.c user/param_registry.c \
+ *                  user/speed_ctrl.c user/blackbox.c -lm
+ *              (与 vehicle_sim 相同的源文件, 参数表会引用各模块的参数)
+ *
+ *              用法:
+ *              ./trace_replay [--speed N] [--kp N] [--ki N] [--kd N] [--cal a:b,c:d,e:f,g:h] [--set 名称=数值]...
+ *                             [--csv FILE] FILE...
+ *              stdout 输出事件 CSV (元素切换、紧急状态进入/退出), 每个文件一行汇总输出到 stderr;
+ *              --csv 把每个周期的解算结果和控制输出写成 CSV
+ *              --speed 目标速度 (默认 50, 与 $GO 相同), --kp/--ki/--kd 方向环增益 ×10 (默认 car_config.h)
+ *              控制链与增益都在 g_system 中 (与固件同一份), --set 与 --speed/--kp 作用于同一组变量, --set 在后
+ *              --cal 电感校准 (LX、LY、RX、RY 的 最小值:最大值), 默认 car_config.h 中的初始值;
+ *                    记录中有 norm_* 列时逐周期比较归一化结果, 不一致的周期数 (norm_diff) 说明校准与实车不同
+ *              --set 修改可调参数, 与蓝牙 $SET 相同 (例如 --set cross_high=85 或 --set dir_kp=30,
+ *                    参数表见 param_registry.c), 可重复
+ *
+ *              输入: 首行为列名的 CSV, 按列名取数 (列顺序不限, 多余的列忽略)
+ *              - 必需: tick, raw_lx, raw_ly, raw_rx, raw_ry (黑匣子默认字段已包含)
+ *              - 可选: enc_left, enc_right (里程, 缺省为 0), pitch_deg (缺省 0), yaw_deg (差分得到转角和角速度),
+ *                      element (与回放结果逐周期比较, 输出 elem_diff)
+ *              - tick 回退 (下一段导出/下一次发车) 时重新初始化, 按新的一段回放;
+ *                tick 不连续 (记录分频 > 1) 时照常回放并计数 gaps, 元素内的周期计数会偏短
+ *              - 黑匣子写满后最早的记录被覆盖, 记录不是从发车开始时元素状态机从空闲起步,
+ *                开头一小段的识别结果可能与实车不同 (elem_diff 主要来自这里)
+ *
+ *              回归测试: 元素阈值 (ZIGZAG_ERROR_JUMP_THRESHOLD、CROSS_BOTH_HIGH_THRESHOLD 等) 用 --set 修改
+ *              (zz_jump、cross_high ...), 或修改 element.h 中的默认值后重新编译, 对同一批记录回放,
+ *              与修改前的事件输出 diff 即可看到识别结果的变化
+ *              赛道记忆 (TrackMap) 保持关闭, 基础速度 = 目标速度 × 元素速度倍率
+ ********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "system.h"
+#include "inductor.h"
+#include "element.h"
+#include "pose.h"
+#include "param_registry.h"
+
+/*==================================================================================================================
+ *                                              配置
+ *==================================================================================================================*/
+
+#define REPLAY_LINE_MAX         1024
+#define REPLAY_COL_MAX          64
+#define REPLAY_ELEMENT_TYPES    6
+#define REPLAY_SET_MAX          16
+
+/* 按列名取数的输入列 */
+enum
+{
+    COL_TICK = 0,
+    COL_RAW_LX, COL_RAW_LY, COL_RAW_RX, COL_RAW_RY,
+    COL_NORM_LX, COL_NORM_LY, COL_NORM_RX, COL_NORM_RY,
+    COL_ENC_LEFT, COL_ENC_RIGHT,
+    COL_PITCH, COL_YAW,
+    COL_ELEMENT,
+    COL_NUM
+};
+
+static const char *s_col_names[COL_NUM] = {
+    "tick",
+    "raw_lx", "raw_ly", "raw_rx", "raw_ry",
+    "norm_lx", "norm_ly", "norm_rx", "norm_ry",
+    "enc_left", "enc_right",
+    "pitch_deg", "yaw_deg",
+    "element"
+};
+
+static const char *s_element_names[REPLAY_ELEMENT_TYPES] = {
+    "none", "straight", "zigzag", "turn90", "hexagon", "cross"
+};
+
+typedef struct
+{
+    int     speed;
+    int     kp_x10, ki_x10, kd_x10;
+    uint16  cal_min[4];
+    uint16  cal_max[4];
+    FILE   *csv;                        /* 逐周期输出 (NULL = 不输出) */
+    char   *set[REPLAY_SET_MAX];        /* --set 名称=数值 */
+    int     set_num;
+} ReplayConfig_t;
+
+typedef struct
+{
+    long    records;
+    int     segments;
+    long    gaps;                       /* tick 不连续次数 */
+    long    elem_diff;                  /* 与记录中 element 列不一致的周期数 */
+    long    norm_diff;                  /* 归一化结果与记录不一致的周期数 */
+    long    offline_ticks;
+    long    emergency_ticks;
+    int     entries[REPLAY_ELEMENT_TYPES];
+} ReplayStats_t;
+
+/*==================================================================================================================
+ *                                              回放状态
+ *==================================================================================================================*/
+
+static int32  s_tick_first;
+static int32  s_tick_last;
+static int16  s_yaw_last;
+static uint8  s_emergency_last;
+
+/**
+ * @brief   一段记录开始: 与发车时相同的复位 (System_ResetControl, 增益保持)
+ */
+static void replay_reset(int32 tick)
+{
+    System_ResetControl();
+
+    s_tick_first = tick;
+    s_tick_last = tick;
+    s_yaw_last = 0x7FFF;                /* 第一条记录转角变化为 0 */
+    s_emergency_last = 0;
+}
+
+/*==================================================================================================================
+ *                                              CSV 解析
+ *==================================================================================================================*/
+
+/**
+ * @brief   按逗号切分一行 (保留空字段)
+ * @return  字段数
+ */
+static int replay_split(char *line, char **fields)
+{
+    int n = 0;
+    char *p = line;
+
+    fields[n++] = p;
+    while (*p != '\0' && *p != '\n' && *p != '\r')
+    {
+        if (*p == ',')
+        {
+            *p = '\0';
+            if (n < REPLAY_COL_MAX)
+            {
+                fields[n++] = p + 1;
+            }
+        }
+        p++;
+    }
+    *p = '\0';
+    return n;
+}
+
+/**
+ * @brief   取一列数值
+ * @return  1 = 有值, 0 = 没有这一列或为空
+ */
+static int replay_get(char **fields, int nfields, int col, double *value)
+{
+    char *end;
+
+    if (col < 0 || col >= nfields || fields[col][0] == '\0')
+    {
+        return 0;
+    }
+    *value = strtod(fields[col], &end);
+    return end != fields[col];
+}
+
+/*==================================================================================================================
+ *                                              单个周期回放
+ *==================================================================================================================*/
+
+static void replay_event(const char *file, const ReplayStats_t *st, int32 tick, const char *event,
+                         const char *from, const char *to)
+{
+    printf("%s,%d,%ld,%ld,%s,%s,%s,%d,%u,%u,%u\n",
+           file, st->segments, (long)(tick - s_tick_first) * CONTROL_PERIOD_MS, (long)tick,
+           event, from, to, (int)g_inductor.vector.error,
+           g_inductor.vector.left_magnitude, g_inductor.vector.right_magnitude, g_inductor.vector.sum);
+}
+
+static void replay_tick(const ReplayConfig_t *cfg, const char *file, ReplayStats_t *st,
+                        char **fields, int nfields, const int *col, int32 tick)
+{
+    InductorRaw_t raw;
+    ElementType_t element_last;
+    double v;
+    int16 enc_left = 0, enc_right = 0, pitch = 0, yaw, yaw_delta = 0, gyro_z;
+    uint8 emergency;
+
+    raw.left_x  = replay_get(fields, nfields, col[COL_RAW_LX], &v) ? (uint16)v : 0;
+    raw.left_y  = replay_get(fields, nfields, col[COL_RAW_LY], &v) ? (uint16)v : 0;
+    raw.right_x = replay_get(fields, nfields, col[COL_RAW_RX], &v) ? (uint16)v : 0;
+    raw.right_y = replay_get(fields, nfields, col[COL_RAW_RY], &v) ? (uint16)v : 0;
+    if (replay_get(fields, nfields, col[COL_ENC_LEFT], &v))  enc_left = (int16)v;
+    if (replay_get(fields, nfields, col[COL_ENC_RIGHT], &v)) enc_right = (int16)v;
+    if (replay_get(fields, nfields, col[COL_PITCH], &v))     pitch = (int16)v;     /* 与 pitch / 100 相同, 向零取整 */
+
+    /* 偏航角 (°, 两位小数) 差分得到本周期转角 (0.01°) 和陀螺仪角速度 (原始值) */
+    if (replay_get(fields, nfields, col[COL_YAW], &v))
+    {
+        yaw = (int16)(v * 100.0 + (v >= 0 ? 0.5 : -0.5));
+        if (s_yaw_last != 0x7FFF)
+        {
+            int32 d = (int32)yaw - s_yaw_last;
+            if (d > 18000)  d -= 36000;
+            if (d < -18000) d += 36000;
+            yaw_delta = (int16)d;
+        }
+        s_yaw_last = yaw;
+    }
+    gyro_z = (int16)((int32)yaw_delta * (1000 / CONTROL_PERIOD_MS) * ATTITUDE_GYRO_LSB_X10 / 1000);
+
+    /* 与 System_Control 相同的顺序: 电感 → 位姿 → 控制链 (元素 → 转向 → 速度环) */
+    Inductor_Process(&raw);
+    Pose_Update(enc_left, enc_right, yaw_delta);
+
+    element_last = Element_GetType();
+    g_system.pitch_angle = pitch;
+    System_ControlStep(enc_left, enc_right, g_inductor.vector.error, gyro_z, yaw_delta);
+    emergency = Element_IsEmergency();
+
+    /* 事件与统计 */
+    if (Element_GetType() != element_last && Element_GetType() < REPLAY_ELEMENT_TYPES)
+    {
+        st->entries[Element_GetType()]++;
+        replay_event(file, st, tick, "element",
+                     element_last < REPLAY_ELEMENT_TYPES ? s_element_names[element_last] : "?",
+                     s_element_names[Element_GetType()]);
+    }
+    if (emergency != s_emergency_last)
+    {
+        replay_event(file, st, tick, "emergency", emergency ? "off" : "on", emergency ? "on" : "off");
+        s_emergency_last = emergency;
+    }
+    if (emergency)
+    {
+        st->emergency_ticks++;
+    }
+    if (!g_inductor.vector.is_online)
+    {
+        st->offline_ticks++;
+    }
+    if (replay_get(fields, nfields, col[COL_ELEMENT], &v) && (int)v != (int)Element_GetType())
+    {
+        st->elem_diff++;
+    }
+    if (replay_get(fields, nfields, col[COL_NORM_LX], &v))
+    {
+        double ly = 0, rx = 0, ry = 0;
+
+        replay_get(fields, nfields, col[COL_NORM_LY], &ly);
+        replay_get(fields, nfields, col[COL_NORM_RX], &rx);
+        replay_get(fields, nfields, col[COL_NORM_RY], &ry);
+        if ((int)v != g_inductor.norm.left_x || (int)ly != g_inductor.norm.left_y ||
+            (int)rx != g_inductor.norm.right_x || (int)ry != g_inductor.norm.right_y)
+        {
+            st->norm_diff++;
+        }
+    }
+
+    if (cfg->csv != NULL)
+    {
+        fprintf(cfg->csv, "%s,%d,%ld,%ld,%d,%u,%u,%u,%u,%d,%d,%d,%u,%d,%d,%d,%d,%d,%d,%d\n",
+                file, st->segments, (long)(tick - s_tick_first) * CONTROL_PERIOD_MS, (long)tick,
+                (int)g_inductor.vector.error, g_inductor.vector.left_magnitude, g_inductor.vector.right_magnitude,
+                g_inductor.vector.sum, g_inductor.vector.is_online,
+                (int)Element_GetType(), (int)g_element.state, (int)emergency, (Element_GetSpeedScale() * 100 + 128) >> 8,
+                (int)g_system.direction_offset, (int)g_system.direction_output, (int)gyro_z,
+                (int)g_system.speed_left_target, (int)g_system.speed_right_target,
+                (int)g_system.motor_left_pwm, (int)g_system.motor_right_pwm);
+    }
+}
+
+/*==================================================================================================================
+ *                                              单个文件回放
+ *==================================================================================================================*/
+
+static int replay_file(const ReplayConfig_t *cfg, const char *file)
+{
+    static char line[REPLAY_LINE_MAX];
+    char *fields[REPLAY_COL_MAX];
+    int col[COL_NUM];
+    int nfields, i, k;
+    ReplayStats_t st;
+    double v;
+    int32 tick;
+    FILE *fp = fopen(file, "r");
+
+    if (fp == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", file);
+        return -1;
+    }
+
+    /* 列名 → 列号 */
+    if (fgets(line, sizeof(line), fp) == NULL)
+    {
+        fprintf(stderr, "%s: empty file\n", file);
+        fclose(fp);
+        return -1;
+    }
+    nfields = replay_split(line, fields);
+    for (k = 0; k < COL_NUM; k++)
+    {
+        col[k] = -1;
+        for (i = 0; i < nfields; i++)
+        {
+            if (!strcmp(fields[i], s_col_names[k]))
+            {
+                col[k] = i;
+                break;
+            }
+        }
+    }
+    for (k = COL_TICK; k <= COL_RAW_RY; k++)
+    {
+        if (col[k] < 0)
+        {
+            fprintf(stderr, "%s: missing column %s\n", file, s_col_names[k]);
+            fclose(fp);
+            return -1;
+        }
+    }
+
+    memset(&st, 0, sizeof(st));
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        nfields = replay_split(line, fields);
+        if (!replay_get(fields, nfields, col[COL_TICK], &v))
+        {
+            continue;
+        }
+        tick = (int32)v;
+
+        /* 第一条或 tick 回退: 新的一段 */
+        if (st.records == 0 || tick <= s_tick_last)
+        {
+            st.segments++;
+            replay_reset(tick);
+        }
+        else if (tick != s_tick_last + 1)
+        {
+            st.gaps++;
+        }
+        s_tick_last = tick;
+
+        replay_tick(cfg, file, &st, fields, nfields, col, tick);
+        st.records++;
+    }
+    fclose(fp);
+
+    fprintf(stderr, "%s: records %ld, segments %d, gaps %ld, offline %ld, emergency %ld, elem_diff %ld, norm_diff %ld, entries",
+            file, st.records, st.segments, st.gaps, st.offline_ticks, st.emergency_ticks, st.elem_diff, st.norm_diff);
+    for (k = 1; k < REPLAY_ELEMENT_TYPES; k++)
+    {
+        fprintf(stderr, " %s:%d", s_element_names[k], st.entries[k]);
+    }
+    fprintf(stderr, "\n");
+    return 0;
+}
+
+/*==================================================================================================================
+ *                                              主函数
+ *==================================================================================================================*/
+
+static void replay_usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [--speed N] [--kp N] [--ki N] [--kd N] [--cal a:b,c:d,e:f,g:h] [--set name=value]...\n"
+            "          [--csv FILE] FILE...\n", prog);
+}
+
+static int replay_parse_cal(const char *text, ReplayConfig_t *cfg)
+{
+    unsigned v[8];
+    int k;
+
+    if (sscanf(text, "%u:%u,%u:%u,%u:%u,%u:%u", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7]) != 8)
+    {
+        return -1;
+    }
+    for (k = 0; k < 4; k++)
+    {
+        if (v[2 * k] >= v[2 * k + 1] || v[2 * k + 1] > 4095)
+        {
+            return -1;
+        }
+        cfg->cal_min[k] = (uint16)v[2 * k];
+        cfg->cal_max[k] = (uint16)v[2 * k + 1];
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    ReplayConfig_t cfg;
+    int i, k, files = 0, fail = 0, have_cal = 0;
+
+    cfg.speed  = 50;
+    cfg.kp_x10 = (int)(PID_DIRECTION_KP * 10 + 0.5f);
+    cfg.ki_x10 = (int)(PID_DIRECTION_KI * 10 + 0.5f);
+    cfg.kd_x10 = (int)(PID_DIRECTION_KD * 10 + 0.5f);
+    cfg.csv = NULL;
+    cfg.set_num = 0;
+
+    /* 先解析选项, 文件名留在 argv 中按顺序回放 */
+    for (i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strncmp(arg, "--", 2) != 0)
+        {
+            files++;
+            continue;
+        }
+        if (val == NULL)
+        {
+            replay_usage(argv[0]);
+            return 1;
+        }
+        argv[i++] = NULL;
+
+        if      (!strcmp(arg, "--speed")) cfg.speed = atoi(val);
+        else if (!strcmp(arg, "--kp"))    cfg.kp_x10 = atoi(val);
+        else if (!strcmp(arg, "--ki"))    cfg.ki_x10 = atoi(val);
+        else if (!strcmp(arg, "--kd"))    cfg.kd_x10 = atoi(val);
+        else if (!strcmp(arg, "--cal"))
+        {
+            if (replay_parse_cal(val, &cfg))
+            {
+                replay_usage(argv[0]);
+                return 1;
+            }
+            have_cal = 1;
+        }
+        else if (!strcmp(arg, "--set") && cfg.set_num < REPLAY_SET_MAX)
+        {
+            cfg.set[cfg.set_num++] = argv[i];
+        }
+        else if (!strcmp(arg, "--csv"))
+        {
+            if ((cfg.csv = fopen(val, "w")) == NULL)
+            {
+                fprintf(stderr, "cannot write %s\n", val);
+                return 1;
+            }
+        }
+        else
+        {
+            replay_usage(argv[0]);
+            return 1;
+        }
+        argv[i] = NULL;
+    }
+    if (files == 0)
+    {
+        replay_usage(argv[0]);
+        return 1;
+    }
+
+    Inductor_Init();
+    Pose_Init();
+    System_InitControl();
+
+    /* --speed / --kp / --ki / --kd 与蓝牙 $GO / $P / $I / $D 相同, 之后的 --set 可再覆盖 */
+    System_SetTargetSpeed((int16)cfg.speed);
+    g_system.dir_kp_base = PID_GainFromX10((int16)cfg.kp_x10);
+    g_system.dir_ki_base = PID_GainFromX10((int16)cfg.ki_x10);
+    g_system.dir_kd_base = PID_GainFromX10((int16)cfg.kd_x10);
+    System_ParamChanged();
+
+    if (have_cal)
+    {
+        for (k = 0; k < 4; k++)
+        {
+            Inductor_SetCalibration((uint8)k, cfg.cal_min[k], cfg.cal_max[k]);
+        }
+    }
+    for (k = 0; k < cfg.set_num; k++)
+    {
+        char *eq = strchr(cfg.set[k], '=');
+        uint8 index;
+
+        if (eq == NULL)
+        {
+            replay_usage(argv[0]);
+            return 1;
+        }
+        *eq = '\0';
+        index = ParamRegistry_Find(cfg.set[k]);
+        if (index == 0xFF)
+        {
+            fprintf(stderr, "unknown parameter %s\n", cfg.set[k]);
+            return 1;
+        }
+        *eq = '=';
+        ParamRegistry_CmdSet(cfg.set[k]);               /* 与 $SET 相同的解析和限幅 */
+    }
+
+    printf("file,seg,t_ms,tick,event,from,to,error,left_mag,right_mag,sum\n");
+    if (cfg.csv != NULL)
+    {
+        fprintf(cfg.csv, "file,seg,t_ms,tick,error,left_mag,right_mag,sum,online,element,elem_state,emergency,"
+                         "speed_scale,dir_offset,dir_out,gyro_z,target_left,target_right,pwm_left,pwm_right\n");
+    }
+
+    for (i = 1; i < argc; i++)
+    {
+        if (argv[i] != NULL && replay_file(&cfg, argv[i]))
+        {
+            fail = 1;
+        }
+    }
+
+    if (cfg.csv != NULL)
+    {
+        fclose(cfg.csv);
+    }
+    return fail;
+}
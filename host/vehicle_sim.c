@@ -0,0 +1,450 @@
+/*********************************************************************************************************************
+ * @file        vehicle_sim.c
+ * @brief       飞檐走壁智能车 - 主机闭环仿真主程序
+ * @details     把 user/ 下的控制代码 (PID、电感、元素、System_Control 等) 与 HAL 桩、车辆模型
+ *              链接在 PC 上运行, 统计圈速、横向偏差和偏离恢复时间, 并支持方向环参数与目标速度扫描
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-10
+ *
+ * @note        编译 (仓库根目录):
+ *              gcc -O2 -Wall -DCAR_HOST_BUILD -DSTEER_ERROR_SIGN=1 -Ihost/hal -Iuser -I. -o vehicle_sim \
+ *                  host/sim_hal.c host/sim_model.c host/vehicle_sim.c \
+ *                  user/pid.c user/inductor.c user/element.c user/system.c user/motor.c \
+ *                  user/encoder.c user/battery.c user/fan.c user/bluetooth.c user/key.c \
+ *                  user/adc_scan.c user/profiler.c user/attitude.c user/telemetry.c \
+ *                  user/oled.c user/debug_display.c user/track_map.c user/pose.c \
+ *                  user/steer.c user/inductor_cal.c user/param_store.c user/param_registry.c \
+ *                  user/speed_ctrl.c user/blackbox.c -lm
+ *              模型中左侧电感在车身左侧, 方向环须按 STEER_ERROR_SIGN = 1 编译 (固件默认 -1, 见 car_config.h)
+ *
+ *              用法:
+ *              ./vehicle_sim [--laps N] [--speed a[:b:step]] [--kp a[:b:step]] [--kd a[:b:step]]
+ *                            [--ki N] [--noise LSB] [--seed N] [--trace FILE] [--telemetry FILE]
+ *                            [--track] [--eeprom FILE] [--blackbox FILE] [--verbose]
+ *              kp / kd 为 ×10 整数 (与蓝牙 P/D 命令一致), 每组参数输出一行 CSV;
+ *              不给 --kp / --kd / --speed 时使用固件默认值 (Kp 5.0, Kd 3.0, 速度 50), 这组默认增益
+ *              在仿真中跑不完一圈 (结果为 stall), 仿真常用 --kp 4 --kd 60;
+ *              --trace 把每个控制周期的车辆状态写成 CSV, 便于画轨迹
+ *              --telemetry 把蓝牙串口发出的原始字节 (二进制遥测帧) 写入文件, 用 telemetry_decode 解码
+ *              --track 发车前开启赛道记忆学习 (与 $TRK:1 相同), 第一圈低速学习, 之后按速度表行驶,
+ *                      每圈圈速输出到 stderr
+ *              --eeprom 参数存储使用文件镜像: 每组参数发车前 (System_Init) 从镜像加载, 跑完后执行一次 $SAVE,
+ *                      镜像跨多次运行保留 (不给时每次从擦除状态开始, 不影响仿真结果)
+ *              --blackbox 每组参数跑完后停车, 把黑匣子经调试串口导出的字节写入文件, 用 telemetry_decode 解码
+ ********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "sim_model.h"
+#include "sim_hal.h"
+#include "system.h"
+#include "element.h"
+#include "track_map.h"
+#include "key.h"
+#include "blackbox.h"
+
+#if STEER_ERROR_SIGN != 1
+#error "vehicle_sim: 车辆模型的电感几何只能在 STEER_ERROR_SIGN = 1 下跟线, 请加 -DSTEER_ERROR_SIGN=1 编译"
+#endif
+
+/*==================================================================================================================
+ *                                              配置与统计
+ *==================================================================================================================*/
+
+#define SIM_START_TIMEOUT_MS    5000        /* 等待倒计时结束的最长时间 */
+#define SIM_STALL_TIMEOUT_MS    3000        /* 超过此时间没有前进视为卡死 */
+#define SIM_STALL_DISTANCE      0.05        /* 判定"有前进"的最小距离 (m) */
+#define SIM_EXCURSION_ENTER     0.050       /* 横向偏差超过此值视为一次偏离 (m) */
+#define SIM_EXCURSION_EXIT      0.020       /* 横向偏差回到此值以内视为恢复 (m) */
+#define SIM_ELEMENT_TYPES       6
+#define SIM_DUMP_MAX_LOOPS      10000       /* 等待黑匣子导出完成的最多主循环次数 */
+
+typedef struct
+{
+    int from, to, step;
+} SimRange_t;
+
+typedef struct
+{
+    int         laps;
+    SimRange_t  speed;
+    SimRange_t  kp_x10;
+    SimRange_t  kd_x10;
+    int         ki_x10;
+    double      noise;
+    uint32      seed;
+    int         verbose;
+    FILE       *trace;                  /* 逐周期轨迹输出 (NULL = 不输出) */
+    FILE       *telemetry;              /* 蓝牙串口原始字节输出 (NULL = 不输出) */
+    int         track;                  /* 发车前开启赛道记忆学习 */
+    const char *eeprom;                 /* IAP EEPROM 镜像文件 (NULL = 不使用) */
+    FILE       *blackbox;               /* 调试串口 (黑匣子导出) 原始字节输出 (NULL = 不输出) */
+} SimConfig_t;
+
+typedef struct
+{
+    int     laps_done;
+    int     crashed;                    /* 0 = 正常, 1 = 冲出赛道, 2 = 卡死/超时 */
+    double  lap_time_sum;
+    double  lap_time_best;
+    double  xte_abs_sum;
+    double  xte_abs_max;
+    long    xte_samples;
+    int     excursions;                 /* 偏离次数 */
+    double  recover_sum_ms;             /* 偏离恢复总时间 */
+    int     element_entries[SIM_ELEMENT_TYPES];
+    double  element_time_ms[SIM_ELEMENT_TYPES];
+} SimResult_t;
+
+static const char *s_element_names[SIM_ELEMENT_TYPES] = {
+    "none", "straight", "zigzag", "turn90", "hexagon", "cross"
+};
+
+/*==================================================================================================================
+ *                                              命令行解析
+ *==================================================================================================================*/
+
+static int sim_parse_range(const char *text, SimRange_t *range)
+{
+    int n = sscanf(text, "%d:%d:%d", &range->from, &range->to, &range->step);
+
+    if (n == 1)
+    {
+        range->to = range->from;
+        range->step = 1;
+    }
+    else if (n != 3 || range->step <= 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+static void sim_usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [--laps N] [--speed a[:b:step]] [--kp a[:b:step]] [--kd a[:b:step]]\n"
+            "          [--ki N] [--noise LSB] [--seed N] [--trace FILE] [--telemetry FILE] [--track]\n"
+            "          [--eeprom FILE] [--blackbox FILE] [--verbose]\n", prog);
+}
+
+static int sim_parse_args(int argc, char **argv, SimConfig_t *cfg)
+{
+    int i;
+
+    cfg->laps = 3;
+    cfg->speed.from  = cfg->speed.to  = 50;                                  cfg->speed.step  = 1;
+    cfg->kp_x10.from = cfg->kp_x10.to = (int)(PID_DIRECTION_KP * 10 + 0.5f); cfg->kp_x10.step = 1;
+    cfg->kd_x10.from = cfg->kd_x10.to = (int)(PID_DIRECTION_KD * 10 + 0.5f); cfg->kd_x10.step = 1;
+    cfg->ki_x10 = (int)(PID_DIRECTION_KI * 10 + 0.5f);
+    cfg->noise = 8.0;
+    cfg->seed = 1;
+    cfg->verbose = 0;
+    cfg->trace = NULL;
+    cfg->telemetry = NULL;
+    cfg->track = 0;
+    cfg->eeprom = NULL;
+    cfg->blackbox = NULL;
+
+    for (i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (!strcmp(arg, "--verbose"))
+        {
+            cfg->verbose = 1;
+            continue;
+        }
+        if (!strcmp(arg, "--track"))
+        {
+            cfg->track = 1;
+            continue;
+        }
+        if (val == NULL)
+        {
+            return -1;
+        }
+        i++;
+
+        if      (!strcmp(arg, "--laps"))  cfg->laps = atoi(val);
+        else if (!strcmp(arg, "--ki"))    cfg->ki_x10 = atoi(val);
+        else if (!strcmp(arg, "--noise")) cfg->noise = atof(val);
+        else if (!strcmp(arg, "--seed"))  cfg->seed = (uint32)strtoul(val, NULL, 0);
+        else if (!strcmp(arg, "--trace")) { if ((cfg->trace = fopen(val, "w")) == NULL) return -1; }
+        else if (!strcmp(arg, "--telemetry")) { if ((cfg->telemetry = fopen(val, "wb")) == NULL) return -1; }
+        else if (!strcmp(arg, "--eeprom")) cfg->eeprom = val;
+        else if (!strcmp(arg, "--blackbox")) { if ((cfg->blackbox = fopen(val, "wb")) == NULL) return -1; }
+        else if (!strcmp(arg, "--speed")) { if (sim_parse_range(val, &cfg->speed))  return -1; }
+        else if (!strcmp(arg, "--kp"))    { if (sim_parse_range(val, &cfg->kp_x10)) return -1; }
+        else if (!strcmp(arg, "--kd"))    { if (sim_parse_range(val, &cfg->kd_x10)) return -1; }
+        else return -1;
+    }
+    return (cfg->laps > 0) ? 0 : -1;
+}
+
+/*==================================================================================================================
+ *                                              单次仿真
+ *==================================================================================================================*/
+
+static void sim_run(const SimConfig_t *cfg, int speed, int kp_x10, int kd_x10, SimResult_t *res)
+{
+    double track_len, start_travelled = 0.0, lap_start_ms = 0.0, stall_ref = 0.0, excursion_start = 0.0;
+    double xte_abs, now_ms;
+    uint32 tick, max_ticks, start_ms = 0, stall_ms = 0;
+    int running = 0, in_excursion = 0, laps;
+    ElementType_t last_element = ELEM_NONE;
+
+    memset(res, 0, sizeof(*res));
+    res->lap_time_best = 1e9;
+
+    SimModel_Init(cfg->noise, cfg->seed);
+    SimHal_Reset(1);
+    SimHal_SetUartEcho((uint8)cfg->verbose);
+
+    System_Init();
+    System_SetTargetSpeed((int16)speed);
+    System_PIDCallback((int16)kp_x10, (int16)cfg->ki_x10, (int16)kd_x10);
+    if (cfg->track)
+    {
+        TrackMap_SetMode(TRACK_MODE_LEARN);
+    }
+    System_Start();
+
+    track_len = SimModel_TrackLength();
+    max_ticks = (uint32)((SIM_START_TIMEOUT_MS + cfg->laps * 60000.0) / CONTROL_PERIOD_MS);
+
+    for (tick = 0; tick < max_ticks; tick++)
+    {
+        /* 与单片机一致: 定时中断中每 2 次扫描一次按键, 然后执行控制; 主循环处理其余任务 */
+        SimModel_Step();
+        if (tick % 2 == 0)
+        {
+            key_scan();
+        }
+        System_Control();
+        System_TaskLoop();
+        SimHal_Tick();
+
+        now_ms = (double)SimHal_GetTimeMs();
+
+        if (!running)
+        {
+            if (key_get_car_state() == CAR_STATE_RUNNING)
+            {
+                running = 1;
+                start_ms = SimHal_GetTimeMs();
+                stall_ms = start_ms;
+                lap_start_ms = now_ms;
+                start_travelled = g_sim_progress.travelled;
+                stall_ref = start_travelled;
+            }
+            else if (now_ms > SIM_START_TIMEOUT_MS)
+            {
+                res->crashed = 2;
+                break;
+            }
+            continue;
+        }
+
+        if (cfg->trace != NULL)
+        {
+            fprintf(cfg->trace, "%d,%d,%d,%.0f,%.4f,%.4f,%.2f,%.4f,%.1f,%d,%d,%d,%d,%d,%d\n",
+                    speed, kp_x10, kd_x10, now_ms - start_ms, g_sim_car.x, g_sim_car.y,
+                    g_sim_car.heading * 57.2958, g_sim_progress.xte, g_sim_progress.travelled - start_travelled,
+                    Inductor_GetError(), g_inductor.vector.left_magnitude, g_inductor.vector.right_magnitude,
+                    g_system.motor_left_pwm, g_system.motor_right_pwm, (int)g_element.current_element);
+        }
+
+        /* 横向偏差统计 */
+        xte_abs = fabs(g_sim_progress.xte);
+        res->xte_abs_sum += xte_abs;
+        res->xte_samples++;
+        if (xte_abs > res->xte_abs_max)
+        {
+            res->xte_abs_max = xte_abs;
+        }
+        if (!in_excursion && xte_abs > SIM_EXCURSION_ENTER)
+        {
+            in_excursion = 1;
+            excursion_start = now_ms;
+            res->excursions++;
+        }
+        else if (in_excursion && xte_abs < SIM_EXCURSION_EXIT)
+        {
+            in_excursion = 0;
+            res->recover_sum_ms += now_ms - excursion_start;
+        }
+
+        /* 元素状态机统计 */
+        if (g_element.current_element < SIM_ELEMENT_TYPES)
+        {
+            res->element_time_ms[g_element.current_element] += CONTROL_PERIOD_MS;
+            if (g_element.current_element != last_element)
+            {
+                res->element_entries[g_element.current_element]++;
+            }
+            last_element = g_element.current_element;
+        }
+
+        if (xte_abs > SIM_CRASH_DISTANCE)
+        {
+            res->crashed = 1;
+            break;
+        }
+
+        /* 卡死检测 */
+        if (g_sim_progress.travelled - stall_ref > SIM_STALL_DISTANCE)
+        {
+            stall_ref = g_sim_progress.travelled;
+            stall_ms = SimHal_GetTimeMs();
+        }
+        else if (SimHal_GetTimeMs() - stall_ms > SIM_STALL_TIMEOUT_MS)
+        {
+            res->crashed = 2;
+            break;
+        }
+
+        /* 圈数统计 */
+        laps = (int)((g_sim_progress.travelled - start_travelled) / track_len);
+        if (laps > res->laps_done)
+        {
+            res->laps_done = laps;
+            if (cfg->track)
+            {
+                fprintf(stderr, "speed %d lap %d: %.3f s (track mode %d, bins %u, events %u, anchors %u)\n",
+                        speed, laps, (now_ms - lap_start_ms) / 1000.0, (int)g_track.mode,
+                        g_track.lap_bins, g_track.event_num, g_track.anchor_count);
+            }
+            res->lap_time_sum += now_ms - lap_start_ms;
+            if (now_ms - lap_start_ms < res->lap_time_best)
+            {
+                res->lap_time_best = now_ms - lap_start_ms;
+            }
+            lap_start_ms = now_ms;
+            if (res->laps_done >= cfg->laps)
+            {
+                break;
+            }
+        }
+    }
+
+    if (tick >= max_ticks)
+    {
+        res->crashed = 2;
+    }
+}
+
+/*==================================================================================================================
+ *                                              结果输出
+ *==================================================================================================================*/
+
+static void sim_print_header(void)
+{
+    int i;
+
+    printf("speed,kp_x10,kd_x10,laps,result,lap_mean_s,lap_best_s,xte_mean_mm,xte_max_mm,excursions,recover_mean_ms");
+    for (i = 1; i < SIM_ELEMENT_TYPES; i++)
+    {
+        printf(",%s_n,%s_mean_ms", s_element_names[i], s_element_names[i]);
+    }
+    printf("\n");
+}
+
+static void sim_print_result(int speed, int kp_x10, int kd_x10, const SimResult_t *res)
+{
+    static const char *result_names[] = { "ok", "crash", "stall" };
+    int i;
+
+    printf("%d,%d,%d,%d,%s,%.3f,%.3f,%.1f,%.1f,%d,%.0f",
+           speed, kp_x10, kd_x10, res->laps_done, result_names[res->crashed],
+           res->laps_done ? res->lap_time_sum / res->laps_done / 1000.0 : 0.0,
+           res->laps_done ? res->lap_time_best / 1000.0 : 0.0,
+           res->xte_samples ? res->xte_abs_sum / res->xte_samples * 1000.0 : 0.0,
+           res->xte_abs_max * 1000.0,
+           res->excursions,
+           res->excursions ? res->recover_sum_ms / res->excursions : 0.0);
+    for (i = 1; i < SIM_ELEMENT_TYPES; i++)
+    {
+        printf(",%d,%.0f", res->element_entries[i],
+               res->element_entries[i] ? res->element_time_ms[i] / res->element_entries[i] : 0.0);
+    }
+    printf("\n");
+}
+
+/*==================================================================================================================
+ *                                              主函数
+ *==================================================================================================================*/
+
+int main(int argc, char **argv)
+{
+    SimConfig_t cfg;
+    SimResult_t res;
+    int speed, kp, kd;
+
+    if (sim_parse_args(argc, argv, &cfg))
+    {
+        sim_usage(argv[0]);
+        return 1;
+    }
+
+    if (cfg.trace != NULL)
+    {
+        fprintf(cfg.trace, "speed,kp_x10,kd_x10,t_ms,x,y,heading_deg,xte,travelled,error,left_mag,right_mag,pwm_left,pwm_right,element\n");
+    }
+
+    SimHal_SetUartCapture(cfg.telemetry);
+    SimHal_SetDebugCapture(cfg.blackbox);
+    if (SimHal_SetEepromFile(cfg.eeprom))
+    {
+        fprintf(stderr, "cannot write %s\n", cfg.eeprom);
+        return 1;
+    }
+    sim_print_header();
+    for (speed = cfg.speed.from; speed <= cfg.speed.to; speed += cfg.speed.step)
+    {
+        for (kp = cfg.kp_x10.from; kp <= cfg.kp_x10.to; kp += cfg.kp_x10.step)
+        {
+            for (kd = cfg.kd_x10.from; kd <= cfg.kd_x10.to; kd += cfg.kd_x10.step)
+            {
+                sim_run(&cfg, speed, kp, kd, &res);
+                if (cfg.eeprom != NULL)
+                {
+                    /* 停车后保存 (与 $SAVE 相同) */
+                    key_stop_car();
+                    System_CmdCallback(BT_CMD_SAVE, 0);
+                }
+                if (cfg.blackbox != NULL)
+                {
+                    /* 停车后主循环冻结并分批导出黑匣子 */
+                    int loops;
+
+                    key_stop_car();
+                    for (loops = 0; loops < SIM_DUMP_MAX_LOOPS && BlackBox_GetState() != BLACKBOX_DONE; loops++)
+                    {
+                        System_TaskLoop();
+                    }
+                }
+                sim_print_result(speed, kp, kd, &res);
+                fflush(stdout);
+            }
+        }
+    }
+    if (cfg.trace != NULL)
+    {
+        fclose(cfg.trace);
+    }
+    if (cfg.telemetry != NULL)
+    {
+        fclose(cfg.telemetry);
+    }
+    if (cfg.blackbox != NULL)
+    {
+        fclose(cfg.blackbox);
+    }
+    return 0;
+}
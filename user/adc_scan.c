@@ -0,0 +1,243 @@
+/*********************************************************************************************************************
+ * @file        adc_scan.c
+ * @brief       飞檐走壁智能车 - ADC DMA 后台扫描模块 (源文件)
+ * @details     DMA 双缓冲连续扫描电感/电池通道, 中断中解析硬件平均值
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-12
+ ********************************************************************************************************************/
+
+#include "adc_scan.h"
+
+/*==================================================================================================================
+ *                                              缓冲区参数
+ *==================================================================================================================*/
+
+#define ADC_SCAN_CVT_NUM        (1 << ADC_SCAN_CVT_SHIFT)              // 每帧每通道转换次数
+#define ADC_SCAN_BLOCK_SIZE     (ADC_SCAN_CVT_NUM * 2 + 3)             // 单通道数据块: N个结果 + 通道号 + 平均值
+#define ADC_SCAN_BUFFER_SIZE    (ADC_SCAN_BLOCK_SIZE * ADC_SCAN_CHANNEL_NUM)
+
+// DMA_ADC_CFG2.CVTIMESEL: 0xxx = 1次, 1000 = 2次, 1001 = 4次 ... 1111 = 256次
+#if ADC_SCAN_CVT_SHIFT == 0
+#define ADC_SCAN_CFG2_VALUE     0x00
+#else
+#define ADC_SCAN_CFG2_VALUE     (0x08 | (ADC_SCAN_CVT_SHIFT - 1))
+#endif
+
+#define ADC_SCAN_NO_SLOT        0xFF
+
+/*==================================================================================================================
+ *                                              通道映射表
+ *==================================================================================================================*/
+
+typedef struct
+{
+    uint8            adc_num;       // 原始通道号 (DMA 通道选择 / 数据块中的通道号)
+    adc_channel_enum pin_ch;        // 逐飞库通道枚举 (仅主机仿真使用)
+} AdcScanMap_t;
+
+// 顺序与 AdcScanChannel_t 一致
+static const AdcScanMap_t code s_scan_map[ADC_SCAN_CHANNEL_NUM] = {
+    { INDUCTOR_LEFT_X_ADC_NUM,  INDUCTOR_LEFT_X_CH  },
+    { INDUCTOR_LEFT_Y_ADC_NUM,  INDUCTOR_LEFT_Y_CH  },
+    { INDUCTOR_RIGHT_X_ADC_NUM, INDUCTOR_RIGHT_X_CH },
+    { INDUCTOR_RIGHT_Y_ADC_NUM, INDUCTOR_RIGHT_Y_CH },
+    { BATTERY_ADC_NUM,          BATTERY_ADC_CH      },
+};
+
+/*==================================================================================================================
+ *                                              模块变量
+ *==================================================================================================================*/
+
+static uint8  xdata s_dma_buffer[2][ADC_SCAN_BUFFER_SIZE];     // DMA 双缓冲区
+static uint8  s_dma_index = 0;                                  // DMA 当前写入的缓冲区
+static uint8  s_slot_of_channel[16];                            // 原始通道号 -> AdcScanChannel_t
+static uint16 s_frame[ADC_SCAN_CHANNEL_NUM];                    // 最近一帧各通道平均值
+static vuint16 s_frame_count = 0;                               // 已完成帧数
+
+/*==================================================================================================================
+ *                                              内部函数
+ *==================================================================================================================*/
+
+#ifdef CAR_HOST_BUILD
+/**
+ * @brief   主机仿真: 按 DMA 数据格式生成一帧 (只填通道号和平均值, 逐次结果区不使用)
+ */
+static void adc_scan_host_fill(uint8 xdata *buffer)
+{
+    uint8 i;
+    uint16 value;
+    uint8 xdata *p = buffer;
+
+    for (i = 0; i < ADC_SCAN_CHANNEL_NUM; i++)
+    {
+        p += ADC_SCAN_CVT_NUM * 2;
+        value = adc_mean_filter_convert(s_scan_map[i].pin_ch,
+                                        (uint8)(ADC_SCAN_CVT_NUM > 255 ? 255 : ADC_SCAN_CVT_NUM));
+        p[0] = s_scan_map[i].adc_num;
+        p[1] = (uint8)(value >> 8);
+        p[2] = (uint8)(value & 0xFF);
+        p += 3;
+    }
+}
+#endif
+
+/**
+ * @brief   设置 DMA 接收地址并触发一帧扫描
+ */
+static void adc_scan_start(uint8 xdata *buffer)
+{
+#ifndef CAR_HOST_BUILD
+    DMA_ADC_RXAH = (uint8)((uint16)buffer >> 8);
+    DMA_ADC_RXAL = (uint8)((uint16)buffer);
+    DMA_ADC_CR   = 0xC0;                // ENADC = 1, TRIG = 1
+#else
+    (void)buffer;                       // 主机仿真在完成中断中同步生成数据
+#endif
+}
+
+/**
+ * @brief   解析一帧 DMA 数据, 取出各通道的硬件平均值
+ */
+static void adc_scan_parse(const uint8 xdata *buffer)
+{
+    uint8 i;
+    uint8 slot;
+    const uint8 xdata *p = buffer;
+
+    for (i = 0; i < ADC_SCAN_CHANNEL_NUM; i++)
+    {
+        // 跳过逐次转换结果, 指向 [通道号] [平均值H] [平均值L]
+        p += ADC_SCAN_CVT_NUM * 2;
+
+        slot = s_slot_of_channel[p[0] & 0x0F];
+        if (slot != ADC_SCAN_NO_SLOT)
+        {
+            s_frame[slot] = ((uint16)p[1] << 8) | p[2];
+        }
+        p += 3;
+    }
+
+    s_frame_count++;
+}
+
+/*==================================================================================================================
+ *                                              初始化
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化 ADC DMA 扫描并启动第一帧
+ */
+void AdcScan_Init(void)
+{
+    uint8 i;
+    uint16 channel_mask = 0;
+
+    for (i = 0; i < 16; i++)
+    {
+        s_slot_of_channel[i] = ADC_SCAN_NO_SLOT;
+    }
+    for (i = 0; i < ADC_SCAN_CHANNEL_NUM; i++)
+    {
+        s_slot_of_channel[s_scan_map[i].adc_num & 0x0F] = i;
+        channel_mask |= (uint16)1 << s_scan_map[i].adc_num;
+        s_frame[i] = 0;
+    }
+    s_frame_count = 0;
+    s_dma_index = 0;
+
+#ifndef CAR_HOST_BUILD
+    DMA_ADC_STA   = 0x00;
+    DMA_ADC_CFG   = 0x80;                           // ADCIE = 1, 中断优先级 0, 总线优先级 0
+    DMA_ADC_CHSW0 = (uint8)(channel_mask >> 8);     // CH15 ~ CH8
+    DMA_ADC_CHSW1 = (uint8)(channel_mask & 0xFF);   // CH7 ~ CH0
+    DMA_ADC_CFG2  = ADC_SCAN_CFG2_VALUE;
+#else
+    (void)channel_mask;
+#endif
+
+    adc_scan_start(s_dma_buffer[s_dma_index]);
+}
+
+/*==================================================================================================================
+ *                                              DMA 完成中断
+ *==================================================================================================================*/
+
+/**
+ * @brief   ADC DMA 完成中断处理
+ */
+void AdcScan_DmaIRQHandler(void)
+{
+    uint8 xdata *done;
+
+#ifndef CAR_HOST_BUILD
+    DMA_ADC_STA = 0x00;                 // 清 ADCIF
+#endif
+
+    // 先切换缓冲区重新触发, 让 ADC 尽快继续工作, 再解析刚完成的一帧
+    done = s_dma_buffer[s_dma_index];
+    s_dma_index ^= 1;
+    adc_scan_start(s_dma_buffer[s_dma_index]);
+
+#ifdef CAR_HOST_BUILD
+    adc_scan_host_fill(done);
+#endif
+
+    adc_scan_parse(done);
+}
+
+/*==================================================================================================================
+ *                                              读取接口
+ *==================================================================================================================*/
+
+/**
+ * @brief   读取最近一帧全部通道的平均值
+ */
+void AdcScan_GetFrame(uint16 *values)
+{
+    uint8 i;
+
+#ifdef CAR_HOST_BUILD
+    // 主机仿真没有后台 DMA, 读取时模拟一次扫描完成
+    AdcScan_DmaIRQHandler();
+#endif
+
+    interrupt_global_disable();
+    for (i = 0; i < ADC_SCAN_CHANNEL_NUM; i++)
+    {
+        values[i] = s_frame[i];
+    }
+    interrupt_global_enable();
+}
+
+/**
+ * @brief   读取单个通道最近一帧的平均值
+ */
+uint16 AdcScan_GetValue(AdcScanChannel_t channel)
+{
+    uint16 value;
+
+#ifdef CAR_HOST_BUILD
+    AdcScan_DmaIRQHandler();
+#endif
+
+    interrupt_global_disable();
+    value = s_frame[channel];
+    interrupt_global_enable();
+
+    return value;
+}
+
+/**
+ * @brief   已完成的扫描帧数
+ */
+uint16 AdcScan_GetFrameCount(void)
+{
+    uint16 count;
+
+    interrupt_global_disable();
+    count = s_frame_count;
+    interrupt_global_enable();
+
+    return count;
+}
@@ -0,0 +1,81 @@
+/*********************************************************************************************************************
+ * @file        adc_scan.h
+ * @brief       飞檐走壁智能车 - ADC DMA 后台扫描模块 (头文件)
+ * @details     使用 STC32G 的 ADC DMA 连续扫描 4 路电感和电池通道, 结果写入双缓冲区,
+ *              控制中断只需读取最近一帧的平均值, 不再阻塞等待 ADC 转换
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-12
+ *
+ * @note        DMA 数据格式 (每个使能通道按通道号从小到大依次排列):
+ *              [第1次结果 H/L] ... [第N次结果 H/L] [通道号] [平均值 H/L]
+ *              N = 2^ADC_SCAN_CVT_SHIFT, 每通道共 2N + 3 字节
+ *
+ *              工作流程: DMA 写缓冲区 A -> 完成中断 (DMA_ADC_VECTOR = 48) -> 立即启动写缓冲区 B
+ *                        -> 解析 A 中各通道平均值 -> ... 如此往复, ADC 始终在后台工作
+ ********************************************************************************************************************/
+
+#ifndef __ADC_SCAN_H__
+#define __ADC_SCAN_H__
+
+#include "car_config.h"
+
+/*==================================================================================================================
+ *                                              通道编号
+ *==================================================================================================================*/
+
+/**
+ * @brief   扫描结果中的通道位置
+ */
+typedef enum
+{
+    ADC_SCAN_LEFT_X = 0,        // 左横向电感
+    ADC_SCAN_LEFT_Y,            // 左纵向电感
+    ADC_SCAN_RIGHT_X,           // 右横向电感
+    ADC_SCAN_RIGHT_Y,           // 右纵向电感
+    ADC_SCAN_BATTERY,           // 电池分压
+    ADC_SCAN_CHANNEL_NUM
+} AdcScanChannel_t;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化 ADC DMA 扫描并启动第一帧
+ * @note    需在 Inductor_Init / Battery_Init 之后调用 (引脚与 ADC 电源由 adc_init 配置)
+ *          启动后 ADC 被 DMA 独占, 不能再调用 adc_convert / adc_mean_filter_convert
+ * @return  void
+ */
+void AdcScan_Init(void);
+
+/**
+ * @brief   ADC DMA 完成中断处理
+ * @details 清标志, 切换到另一块缓冲区重新触发扫描, 然后解析刚完成的一帧
+ *          在 isr.c 的 DMA_ADC 中断 (interrupt 48) 中调用
+ * @return  void
+ */
+void AdcScan_DmaIRQHandler(void);
+
+/**
+ * @brief   读取最近一帧全部通道的平均值
+ * @param   values  输出数组, 长度 ADC_SCAN_CHANNEL_NUM, 按 AdcScanChannel_t 排列
+ * @note    关中断拷贝, 保证各通道来自同一帧
+ * @return  void
+ */
+void AdcScan_GetFrame(uint16 *values);
+
+/**
+ * @brief   读取单个通道最近一帧的平均值
+ * @param   channel 通道位置
+ * @return  uint16  ADC 值 (12bit)
+ */
+uint16 AdcScan_GetValue(AdcScanChannel_t channel);
+
+/**
+ * @brief   已完成的扫描帧数 (回绕计数, 用于确认 DMA 在持续工作)
+ * @return  uint16
+ */
+uint16 AdcScan_GetFrameCount(void);
+
+#endif // __ADC_SCAN_H__
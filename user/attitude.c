@@ -0,0 +1,367 @@
+/*********************************************************************************************************************
+ * @file        attitude.c
+ * @brief       飞檐走壁智能车 - 姿态解算模块 (源文件)
+ * @details     整数互补滤波 + CORDIC atan2 + 静止零偏学习
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-14
+ ********************************************************************************************************************/
+
+#include "attitude.h"
+
+/*==================================================================================================================
+ *                                              内部定点格式
+ *==================================================================================================================*/
+
+// 内部角度 = 0.01° × 2^ATT_Q, 保留小数部分, 避免每次积分截断造成漂移
+#define ATT_Q                   8
+#define ATT_HALF_TURN_Q         ((int32)18000 << ATT_Q)
+#define ATT_FULL_TURN_Q         ((int32)36000 << ATT_Q)
+
+// 陀螺仪 (原始值 × 16) -> 每毫秒角度增量 (内部格式), Q14 系数
+// = 100 × 256 / (16 × 1000 × LSB) × 16384
+#define ATT_GYRO_K              ((16L * 16384L * 10L * 100L) / (1000L * ATTITUDE_GYRO_LSB_X10))
+
+// 加速度模长平方的有效范围
+#define ATT_ACC_GATE_LO         ((uint32)(ATTITUDE_ACC_1G * (100L - ATTITUDE_ACC_GATE_PCT) / 100) * \
+                                 (uint32)(ATTITUDE_ACC_1G * (100L - ATTITUDE_ACC_GATE_PCT) / 100))
+#define ATT_ACC_GATE_HI         ((uint32)(ATTITUDE_ACC_1G * (100L + ATTITUDE_ACC_GATE_PCT) / 100) * \
+                                 (uint32)(ATTITUDE_ACC_1G * (100L + ATTITUDE_ACC_GATE_PCT) / 100))
+
+#define ATT_CORDIC_ITER         12
+
+/*==================================================================================================================
+ *                                              全局变量
+ *==================================================================================================================*/
+
+AttitudeData_t g_attitude;
+
+static int32 s_pitch_q = 0;             // 内部格式角度
+static int32 s_roll_q  = 0;
+static int32 s_yaw_q   = 0;
+static int32 s_bias_q4[3];              // 陀螺仪零偏 (原始值 × 16)
+static int16 s_last_gyro[3];            // 上一次陀螺仪原始值 (零偏未学习时用于静止判定)
+static uint16 s_still_ms = 0;           // 静止持续时间
+static uint8 s_initialized = 0;         // 是否已用加速度计初始化角度
+
+// atan(2^-i), 单位 0.01°
+static const int16 code s_atan_table[ATT_CORDIC_ITER] = {
+    4500, 2657, 1404, 713, 358, 179, 90, 45, 22, 11, 6, 3
+};
+
+/*==================================================================================================================
+ *                                              工具函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   整数 atan2 (CORDIC 向量模式)
+ * @note    先把向量转到右半平面, 再逐次旋转 ±atan(2^-i) 使 y 趋于 0, 累加的旋转角即为结果
+ */
+int16 Attitude_Atan2(int32 y, int32 x)
+{
+    int32 tmp;
+    int16 angle = 0;
+    uint8 i;
+
+    if (x == 0 && y == 0)
+    {
+        return 0;
+    }
+
+    // 放大后再迭代, 减少移位截断误差
+    x <<= 6;
+    y <<= 6;
+
+    // 左半平面先旋转 ±90°
+    if (x < 0)
+    {
+        tmp = x;
+        if (y >= 0)
+        {
+            x = y;
+            y = -tmp;
+            angle = 9000;
+        }
+        else
+        {
+            x = -y;
+            y = tmp;
+            angle = -9000;
+        }
+    }
+
+    for (i = 0; i < ATT_CORDIC_ITER; i++)
+    {
+        if (y > 0)
+        {
+            tmp = x + (y >> i);
+            y   = y - (x >> i);
+            angle += s_atan_table[i];
+        }
+        else
+        {
+            tmp = x - (y >> i);
+            y   = y + (x >> i);
+            angle -= s_atan_table[i];
+        }
+        x = tmp;
+    }
+
+    return angle;
+}
+
+/**
+ * @brief   向量模近似 (alpha max + beta min, 误差 < 7%)
+ */
+static int32 attitude_hypot(int32 a, int32 b)
+{
+    a = ABS_VALUE(a);
+    b = ABS_VALUE(b);
+    return (a > b) ? (a + ((b * 3) >> 3)) : (b + ((a * 3) >> 3));
+}
+
+/**
+ * @brief   内部格式角度归一化到 ±180°
+ */
+static int32 attitude_wrap(int32 angle)
+{
+    while (angle > ATT_HALF_TURN_Q)
+    {
+        angle -= ATT_FULL_TURN_Q;
+    }
+    while (angle < -ATT_HALF_TURN_Q)
+    {
+        angle += ATT_FULL_TURN_Q;
+    }
+    return angle;
+}
+
+/**
+ * @brief   陀螺仪角速度 -> 角度增量
+ * @param   rate_q4     扣除零偏后的角速度 (原始值 × 16)
+ * @param   dt_ms       积分时间
+ * @return  int32       角度增量 (内部格式)
+ */
+static int32 attitude_gyro_delta(int32 rate_q4, uint8 dt_ms)
+{
+    return ((rate_q4 * ATT_GYRO_K) >> 14) * dt_ms;
+}
+
+/*==================================================================================================================
+ *                                              静止检测与零偏学习
+ *==================================================================================================================*/
+
+/**
+ * @brief   判断陀螺仪某轴是否接近参考值
+ */
+static uint8 attitude_gyro_near(int16 value, int16 ref)
+{
+    int32 diff = (int32)value - ref;
+    return (ABS_VALUE(diff) < ATTITUDE_STILL_GYRO_THRESH);
+}
+
+/**
+ * @brief   静止检测
+ * @note    零偏学习前: 与上一次采样比较 (角速度基本不变)
+ *          零偏学习后: 与零偏比较 (角速度基本为 0)
+ */
+static void attitude_detect_still(const imu660ra_data_struct *imu, uint8 dt_ms)
+{
+    uint8 still;
+
+    if (g_attitude.bias_valid)
+    {
+        still = attitude_gyro_near(imu->gyro_x, g_attitude.gyro_bias_x) &&
+                attitude_gyro_near(imu->gyro_y, g_attitude.gyro_bias_y) &&
+                attitude_gyro_near(imu->gyro_z, g_attitude.gyro_bias_z);
+    }
+    else
+    {
+        still = attitude_gyro_near(imu->gyro_x, s_last_gyro[0]) &&
+                attitude_gyro_near(imu->gyro_y, s_last_gyro[1]) &&
+                attitude_gyro_near(imu->gyro_z, s_last_gyro[2]);
+    }
+    still = still && g_attitude.acc_valid;
+
+    s_last_gyro[0] = imu->gyro_x;
+    s_last_gyro[1] = imu->gyro_y;
+    s_last_gyro[2] = imu->gyro_z;
+
+    if (!still)
+    {
+        s_still_ms = 0;
+    }
+    else if (s_still_ms < ATTITUDE_STILL_TIME_MS)
+    {
+        s_still_ms += dt_ms;
+    }
+    g_attitude.is_still = (s_still_ms >= ATTITUDE_STILL_TIME_MS);
+}
+
+/**
+ * @brief   零偏学习 (一阶低通)
+ */
+static void attitude_learn_bias(const imu660ra_data_struct *imu)
+{
+    if (!g_attitude.bias_valid)
+    {
+        // 第一次直接取当前值, 之后逐步平滑
+        s_bias_q4[0] = (int32)imu->gyro_x << 4;
+        s_bias_q4[1] = (int32)imu->gyro_y << 4;
+        s_bias_q4[2] = (int32)imu->gyro_z << 4;
+        g_attitude.bias_valid = 1;
+    }
+    else
+    {
+        s_bias_q4[0] += (((int32)imu->gyro_x << 4) - s_bias_q4[0]) >> ATTITUDE_BIAS_SHIFT;
+        s_bias_q4[1] += (((int32)imu->gyro_y << 4) - s_bias_q4[1]) >> ATTITUDE_BIAS_SHIFT;
+        s_bias_q4[2] += (((int32)imu->gyro_z << 4) - s_bias_q4[2]) >> ATTITUDE_BIAS_SHIFT;
+    }
+
+    g_attitude.gyro_bias_x = (int16)(s_bias_q4[0] >> 4);
+    g_attitude.gyro_bias_y = (int16)(s_bias_q4[1] >> 4);
+    g_attitude.gyro_bias_z = (int16)(s_bias_q4[2] >> 4);
+}
+
+/*==================================================================================================================
+ *                                              姿态更新
+ *==================================================================================================================*/
+
+/**
+ * @brief   一次姿态更新
+ * @param   imu         IMU 原始数据
+ * @param   dt_ms       距上次更新的时间
+ * @param   learn_bias  是否允许学习零偏
+ */
+static void attitude_step(const imu660ra_data_struct *imu, uint8 dt_ms, uint8 learn_bias)
+{
+    int32 ax = imu->acc_x;
+    int32 ay = imu->acc_y;
+    int32 az = imu->acc_z;
+    int32 acc_pitch_q, acc_roll_q;
+    int32 yaw_diff;
+    uint32 mag2;
+    int16 last_yaw;
+
+    /*-------------------------------------------------
+     * Step 1: 加速度计角度 + 有效性判定
+     *-------------------------------------------------*/
+    mag2 = (uint32)(ax * ax) + (uint32)(ay * ay) + (uint32)(az * az);
+    g_attitude.acc_valid = (mag2 > ATT_ACC_GATE_LO && mag2 < ATT_ACC_GATE_HI);
+
+    acc_pitch_q = (int32)Attitude_Atan2(ax, az) << ATT_Q;
+    acc_roll_q  = (int32)Attitude_Atan2(ay, attitude_hypot(ax, az)) << ATT_Q;
+
+    /*-------------------------------------------------
+     * Step 2: 静止检测与零偏学习
+     *-------------------------------------------------*/
+    attitude_detect_still(imu, dt_ms);
+    if (learn_bias && g_attitude.is_still)
+    {
+        attitude_learn_bias(imu);
+    }
+
+    /*-------------------------------------------------
+     * Step 3: 陀螺仪积分 + 加速度计修正
+     *-------------------------------------------------*/
+    if (!s_initialized)
+    {
+        // 第一次更新直接使用加速度计角度
+        s_pitch_q = acc_pitch_q;
+        s_roll_q  = acc_roll_q;
+        s_yaw_q   = 0;
+        s_initialized = 1;
+    }
+    else
+    {
+        s_pitch_q += attitude_gyro_delta(s_bias_q4[1] - ((int32)imu->gyro_y << 4), dt_ms);
+        s_roll_q  += attitude_gyro_delta(((int32)imu->gyro_x << 4) - s_bias_q4[0], dt_ms);
+        s_yaw_q   += attitude_gyro_delta(((int32)imu->gyro_z << 4) - s_bias_q4[2], dt_ms);
+
+        if (g_attitude.acc_valid)
+        {
+            s_pitch_q += attitude_wrap(acc_pitch_q - s_pitch_q) >> ATTITUDE_ACC_WEIGHT_SHIFT;
+            s_roll_q  += attitude_wrap(acc_roll_q  - s_roll_q)  >> ATTITUDE_ACC_WEIGHT_SHIFT;
+        }
+
+        s_pitch_q = attitude_wrap(s_pitch_q);
+        s_roll_q  = attitude_wrap(s_roll_q);
+        s_yaw_q   = attitude_wrap(s_yaw_q);
+    }
+
+    /*-------------------------------------------------
+     * Step 4: 输出
+     *-------------------------------------------------*/
+    last_yaw = g_attitude.yaw;
+    g_attitude.pitch = (int16)(s_pitch_q >> ATT_Q);
+    g_attitude.roll  = (int16)(s_roll_q  >> ATT_Q);
+    g_attitude.yaw   = (int16)(s_yaw_q   >> ATT_Q);
+
+    // 偏航变化量 (跨越 ±180° 时取短弧)
+    yaw_diff = (int32)g_attitude.yaw - last_yaw;
+    if (yaw_diff > 18000)
+    {
+        yaw_diff -= 36000;
+    }
+    else if (yaw_diff < -18000)
+    {
+        yaw_diff += 36000;
+    }
+    g_attitude.yaw_delta = (int16)yaw_diff;
+}
+
+/**
+ * @brief   初始化姿态解算模块
+ */
+void Attitude_Init(void)
+{
+    uint8 i;
+
+    for (i = 0; i < 3; i++)
+    {
+        s_bias_q4[i] = 0;
+        s_last_gyro[i] = 0;
+    }
+    s_pitch_q = 0;
+    s_roll_q  = 0;
+    s_yaw_q   = 0;
+    s_still_ms = 0;
+    s_initialized = 0;
+
+    g_attitude.pitch = 0;
+    g_attitude.roll  = 0;
+    g_attitude.yaw   = 0;
+    g_attitude.yaw_delta = 0;
+    g_attitude.gyro_bias_x = 0;
+    g_attitude.gyro_bias_y = 0;
+    g_attitude.gyro_bias_z = 0;
+    g_attitude.is_still   = 0;
+    g_attitude.bias_valid = 0;
+    g_attitude.acc_valid  = 0;
+}
+
+/**
+ * @brief   控制周期姿态更新
+ */
+void Attitude_Update(const imu660ra_data_struct *imu)
+{
+    attitude_step(imu, CONTROL_PERIOD_MS, 0);
+}
+
+/**
+ * @brief   停车时姿态更新
+ */
+void Attitude_UpdateIdle(const imu660ra_data_struct *imu, uint8 dt_ms)
+{
+    attitude_step(imu, dt_ms, 1);
+}
+
+/**
+ * @brief   偏航角清零
+ */
+void Attitude_ResetYaw(void)
+{
+    s_yaw_q = 0;
+    g_attitude.yaw = 0;
+    g_attitude.yaw_delta = 0;
+}
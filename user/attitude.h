@@ -0,0 +1,98 @@
+/*********************************************************************************************************************
+ * @file        attitude.h
+ * @brief       飞檐走壁智能车 - 姿态解算模块 (头文件)
+ * @details     陀螺仪 + 加速度计互补滤波, 输出俯仰/横滚/偏航角, 静止时自动学习陀螺仪零偏
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-14
+ *
+ * @note        算法说明:
+ *              1. 陀螺仪积分得到角度增量 (扣除零偏), 短时间内准确但会漂移
+ *              2. 加速度计 atan2 得到重力方向角度, 长时间准确但受振动影响
+ *              3. 每次更新: angle += gyro * dt;  angle += (acc_angle - angle) / 64
+ *              4. 加速度模长偏离 1g 太多 (冲击/振动) 时只用陀螺仪
+ *              5. 偏航角没有加速度计参考, 仅靠陀螺仪积分 (零偏学习后漂移很小)
+ *
+ *              atan2 使用 CORDIC 移位迭代实现, 无除法、无浮点
+ *
+ *              坐标约定 (与原 acc_x / acc_z 公式一致):
+ *              - pitch = atan2(acc_x, acc_z), 角速度 = -gyro_y
+ *              - roll  = atan2(acc_y, |acc_xz|), 角速度 = gyro_x
+ *              - yaw   = ∫gyro_z, 正 = 右转
+ *
+ *              角度单位: 0.01° (9000 = 90°)
+ ********************************************************************************************************************/
+
+#ifndef __ATTITUDE_H__
+#define __ATTITUDE_H__
+
+#include "car_config.h"
+#include "zf_device_imu660ra.h"
+
+/*==================================================================================================================
+ *                                              姿态数据结构体
+ *==================================================================================================================*/
+
+/**
+ * @brief   姿态数据
+ */
+typedef struct
+{
+    int16 pitch;                // 俯仰角 (0.01°), 正 = 抬头
+    int16 roll;                 // 横滚角 (0.01°)
+    int16 yaw;                  // 偏航角 (0.01°, -18000 ~ +18000), 正 = 右转
+    int16 yaw_delta;            // 本次更新的偏航角变化量 (0.01°)
+
+    int16 gyro_bias_x;          // 陀螺仪零偏 (原始值)
+    int16 gyro_bias_y;
+    int16 gyro_bias_z;
+
+    uint8 is_still;             // 当前是否静止
+    uint8 bias_valid;           // 零偏是否已学习
+    uint8 acc_valid;            // 本次加速度计是否参与修正
+} AttitudeData_t;
+
+extern AttitudeData_t g_attitude;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化姿态解算模块
+ * @note    第一次更新时直接用加速度计角度作为初值, 避免滤波器从 0 慢慢收敛
+ * @return  void
+ */
+void Attitude_Init(void);
+
+/**
+ * @brief   控制周期姿态更新 (在 System_Control 中调用)
+ * @param   imu     本周期 IMU 原始数据
+ * @note    运行中不学习零偏, 防止把缓慢转弯误当成零偏
+ * @return  void
+ */
+void Attitude_Update(const imu660ra_data_struct *imu);
+
+/**
+ * @brief   停车时姿态更新 (停车时在控制中断中调用, 与 Attitude_Update 同一上下文)
+ * @param   imu     IMU 原始数据
+ * @param   dt_ms   距上次更新的时间 (ms)
+ * @note    静止超过 ATTITUDE_STILL_TIME_MS 后学习陀螺仪零偏
+ * @return  void
+ */
+void Attitude_UpdateIdle(const imu660ra_data_struct *imu, uint8 dt_ms);
+
+/**
+ * @brief   偏航角清零 (以当前朝向为 0)
+ * @return  void
+ */
+void Attitude_ResetYaw(void);
+
+/**
+ * @brief   整数 atan2 (CORDIC)
+ * @param   y, x    任意缩放的向量分量 (|x|, |y| < 2^22)
+ * @return  int16   角度 (0.01°, -18000 ~ +18000)
+ */
+int16 Attitude_Atan2(int32 y, int32 x);
+
+#endif // __ATTITUDE_H__
@@ -8,15 +8,51 @@
  ********************************************************************************************************************/
 
 #include "battery.h"
-#include "motor.h"      // 用于紧急停机
+#include "motor.h"      // 用于紧急停机、负载电流估计
+#include "fan.h"        // 负载电流估计
+#include "adc_scan.h"   // DMA 扫描模式下从后台扫描结果取值
+#include "bluetooth.h"
+
+/*==================================================================================================================
+ *                                              全局变量
+ *==================================================================================================================*/
+
+BatteryData_t g_battery;
 
 /*==================================================================================================================
  *                                              私有变量
  *==================================================================================================================*/
 
-static float s_battery_voltage = 12.0f;     // 当前电池电压
+// ADC 值 → mV: V = adc / 4095 × 3.3V × 11, 预先算成 Q16 系数 (4095 × 系数 < 2^32)
+#define BATTERY_MV_PER_LSB_Q16  (((uint32)BATTERY_ADC_REF_MV * BATTERY_DIVIDER_RATIO * 65536UL + 2047) / 4095)
+// 占空比 → mA (Q16): 满占空比 MOTOR_PWM_DUTY_MAX / FAN_DUTY_MAX 对应 BATTERY_MOTOR_MA / BATTERY_FAN_MA
+#define BATTERY_MOTOR_MA_Q16    ((uint32)BATTERY_MOTOR_MA * 65536UL / MOTOR_PWM_DUTY_MAX)
+#define BATTERY_FAN_MA_Q16      ((uint32)BATTERY_FAN_MA * 65536UL / FAN_DUTY_MAX)
+
+static int32 s_volt_fast = 0;               // 快滤波电压 (Q8 mV)
+static int32 s_volt_slow = 0;               // 慢滤波电压 (Q8 mV)
+static int32 s_curr_fast = 0;               // 快滤波电流 (Q8 mA)
+static int32 s_curr_slow = 0;               // 慢滤波电流 (Q8 mA)
+static uint8 s_sampled = 0;                 // 1 = 已有第一个采样 (滤波器已初始化)
+static int32 s_rint_q4 = (int32)BATTERY_RINT_INIT_MOHM << 4;    // 内阻 (Q4 mΩ)
+static uint16 s_battery_volt_x100 = 0;      // 慢滤波电压 × 100 (遥测缓存)
 static BatteryStatus_t s_battery_status = BATTERY_OK;   // 当前电池状态
 static uint8 s_alarm_counter = 0;           // 报警计数器 (用于闪烁)
+static uint16 s_comp_scale = 4096;          // 电压补偿倍率 (Q12)
+static uint16 s_comp_inverse = 4096;        // 补偿倍率的倒数 (Q12), 速度环据此收紧输出限幅
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   Q8 滤波值 → uint16 (四舍五入, 负数按 0)
+ */
+static uint16 battery_q8_to_u16(int32 value)
+{
+    value = (value + 128) >> 8;
+    return (uint16)LIMIT_RANGE(value, 0L, 65535L);
+}
 
 /*==================================================================================================================
  *                                              电池初始化
@@ -34,41 +70,207 @@ void Battery_Init(void)
     gpio_init(BUZZER_PIN, GPO, 0, GPO_PUSH_PULL);
     BUZZER_OFF();
     
-    // 初始化电压 (读取一次)
-    s_battery_voltage = Battery_GetVoltage();
+    // 滤波器在第一个采样时初始化 (DMA 扫描此时尚未启动)
+    s_sampled = 0;
+    g_battery.voltage_mv = 0;
+    g_battery.fast_mv = 0;
+    g_battery.current_ma = 0;
+    g_battery.rint_mohm = BATTERY_RINT_INIT_MOHM;
+    g_battery.ocv_mv = 0;
+    g_battery.predict_mv = 0;
+    g_battery.peak_ma = 0;
+    g_battery.sag_count = 0;
+    g_battery.sag_min_mv = 0xFFFF;
+    g_battery.sag_active = 0;
     s_battery_status  = BATTERY_OK;
 }
 
 /*==================================================================================================================
- *                                              获取电池电压
+ *                                              电压采样与滤波
  *==================================================================================================================*/
 
 /**
- * @brief   获取电池电压
+ * @brief   电压采样与滤波、压降检测
  * @note    计算公式:
  *          ADC_Value (12bit) -> 0~4095 对应 0~3.3V
- *          V_adc = ADC_Value / 4095 * 3.3V
- *          V_battery = V_adc * 11 (分压系数)
+ *          V_battery (mV) = ADC_Value × 3300 × 11 / 4095 = ADC_Value × BATTERY_MV_PER_LSB_Q16 >> 16
+ *          负载电流 = (|左电机| + |右电机|) × 电机满载电流 + 风扇 × 风扇满载电流, 再乘补偿倍率 (实际占空比)
  */
-float Battery_GetVoltage(void)
+void Battery_Update(void)
 {
     uint16 adc_value;
-    float voltage;
+    int32 mv;
+    int32 ma;
+    int16 pwm_left, pwm_right;
+    uint16 fast_mv;
+    uint16 slow_mv;
+    
+#if ADC_SCAN_DMA_ENABLE
+    // ADC 由 DMA 后台扫描独占, 直接取最近一帧的平均值
+    adc_value = AdcScan_GetValue(ADC_SCAN_BATTERY);
+#else
+    adc_value = adc_convert(BATTERY_ADC_CH);
+#endif
+    mv = (int32)(((uint32)adc_value * BATTERY_MV_PER_LSB_Q16) >> 16);
+    
+    // 标称占空比 → 电流, 乘补偿倍率得到实际占空比下的电流
+    pwm_left  = Motor_GetPWM(0);
+    pwm_right = Motor_GetPWM(1);
+    if (pwm_left < 0)  pwm_left  = -pwm_left;
+    if (pwm_right < 0) pwm_right = -pwm_right;
+    ma = (int32)((((uint32)pwm_left + (uint32)pwm_right) * BATTERY_MOTOR_MA_Q16 +
+                  (uint32)Fan_GetDuty() * BATTERY_FAN_MA_Q16) >> 16);
+    ma = (ma * s_comp_scale) >> 12;
+    
+    if (!s_sampled)
+    {
+        s_volt_fast = mv << 8;
+        s_volt_slow = mv << 8;
+        s_curr_fast = ma << 8;
+        s_curr_slow = ma << 8;
+        s_sampled = 1;
+    }
+    else
+    {
+        s_volt_fast += ((mv << 8) - s_volt_fast) >> BATTERY_FAST_SHIFT;
+        s_volt_slow += ((mv << 8) - s_volt_slow) >> BATTERY_SLOW_SHIFT;
+        s_curr_fast += ((ma << 8) - s_curr_fast) >> BATTERY_FAST_SHIFT;
+        s_curr_slow += ((ma << 8) - s_curr_slow) >> BATTERY_SLOW_SHIFT;
+    }
+    
+    fast_mv = battery_q8_to_u16(s_volt_fast);
+    slow_mv = battery_q8_to_u16(s_volt_slow);
+    g_battery.fast_mv    = fast_mv;
+    g_battery.voltage_mv = slow_mv;
+    g_battery.current_ma = battery_q8_to_u16(s_curr_fast);
+    if (g_battery.current_ma > g_battery.peak_ma)
+    {
+        g_battery.peak_ma = g_battery.current_ma;
+    }
+    
+    // 负载压降: 快滤波明显低于慢滤波 (起步、加速、上墙时电流突增)
+    if ((int32)fast_mv + BATTERY_SAG_MV < (int32)slow_mv)
+    {
+        if (!g_battery.sag_active)
+        {
+            g_battery.sag_active = 1;
+            g_battery.sag_count++;
+        }
+        if (fast_mv < g_battery.sag_min_mv)
+        {
+            g_battery.sag_min_mv = fast_mv;
+        }
+    }
+    else
+    {
+        g_battery.sag_active = 0;
+    }
+}
+
+/**
+ * @brief   获取电池电压 (慢滤波, mV)
+ */
+uint16 Battery_GetVoltageMv(void)
+{
+    uint16 mv;
+    
+    interrupt_global_disable();
+    mv = g_battery.voltage_mv;
+    interrupt_global_enable();
+    
+    return mv;
+}
+
+/**
+ * @brief   获取电池电压 (× 100)
+ */
+uint16 Battery_GetVoltageX100(void)
+{
+    return s_battery_volt_x100;
+}
+
+/*==================================================================================================================
+ *                                              内阻估计与电压补偿
+ *==================================================================================================================*/
+
+/**
+ * @brief   内阻估计与低压预测 (主循环, 含除法)
+ * @param   v_fast/v_slow/i_fast/i_slow   滤波器快照 (Q8)
+ * @param   peak_ma                       实测最大负载电流 (mA)
+ * @note    两个滤波器时间常数相同的电压、电流之间是同一个线性关系 V = 开路电压 − 内阻 × I,
+ *          开路电压在慢滤波时间常数内不变, 因此 (慢电压 − 快电压) / (快电流 − 慢电流) = 内阻
+ */
+static void battery_update_rint(int32 v_fast, int32 v_slow, int32 i_fast, int32 i_slow, uint16 peak_ma)
+{
+    int32 di = i_fast - i_slow;
+    int32 r_q4;
+    int32 ocv;
+    int32 predict;
+    
+    if (di >= ((int32)BATTERY_RINT_MIN_DI_MA << 8) || di <= -((int32)BATTERY_RINT_MIN_DI_MA << 8))
+    {
+        // Q8 mV × 16 / mA = Q12 Ω, × 1000 >> 8 = Q4 mΩ
+        r_q4 = (((v_slow - v_fast) * 16 / (di >> 8)) * 1000) >> 8;
+        if (r_q4 >= ((int32)BATTERY_RINT_MIN_MOHM << 4) && r_q4 <= ((int32)BATTERY_RINT_MAX_MOHM << 4))
+        {
+            s_rint_q4 += (r_q4 - s_rint_q4) >> BATTERY_RINT_SHIFT;
+        }
+    }
+    
+    ocv = (v_slow >> 8) + ((s_rint_q4 * (i_slow >> 8)) >> 4) / 1000;
+    predict = ocv - ((s_rint_q4 * peak_ma) >> 4) / 1000;
     
-    // 采样 10 次取平均 (提高稳定性)
-    adc_value = adc_mean_filter_convert(BATTERY_ADC_CH, 10);
+    g_battery.rint_mohm  = (uint16)((s_rint_q4 + 8) >> 4);
+    g_battery.ocv_mv     = (uint16)LIMIT_RANGE(ocv, 0L, 65535L);
+    g_battery.predict_mv = (uint16)LIMIT_RANGE(predict, 0L, 65535L);
+}
+
+/**
+ * @brief   更新补偿倍率及其倒数 (主循环, 含两次除法)
+ */
+static void battery_update_comp(uint16 mv)
+{
+#if BATTERY_COMP_ENABLE
+    int32 scale;
+    int32 inverse;
     
-    // 计算实际电压
-    // V = adc_value / 4095 * 3.3 * 11
-    // 简化: V = adc_value * 3.3 * 11 / 4095
-    //       V = adc_value * 36.3 / 4095
-    //       V = adc_value * 0.008867...
-    voltage = (float)adc_value * (float)BATTERY_ADC_REF_MV / 4095.0f / 1000.0f * BATTERY_DIVIDER_RATIO;
+    // 读数异常 (ADC 扫描尚未启动、分压断线) 时不补偿
+    if (mv < BATTERY_NOMINAL_MV / 2)
+    {
+        scale = 4096;
+    }
+    else
+    {
+        scale = ((int32)BATTERY_NOMINAL_MV << 12) / mv;
+        scale = LIMIT_RANGE(scale, (int32)BATTERY_COMP_MIN_X100 * 4096 / 100,
+                                   (int32)BATTERY_COMP_MAX_X100 * 4096 / 100);
+    }
     
-    // 更新缓存值
-    s_battery_voltage = voltage;
+    inverse = (1L << 24) / scale;       // 向下取整, 补偿后不超过电机限幅
     
-    return voltage;
+    interrupt_global_disable();
+    s_comp_scale = (uint16)scale;
+    s_comp_inverse = (uint16)inverse;
+    interrupt_global_enable();
+#else
+    (void)mv;
+#endif
+}
+
+/**
+ * @brief   获取电压补偿倍率
+ */
+uint16 Battery_GetCompScale(void)
+{
+    return s_comp_scale;
+}
+
+/**
+ * @brief   获取电压补偿倍率的倒数
+ */
+uint16 Battery_GetCompInverse(void)
+{
+    return s_comp_inverse;
 }
 
 /*==================================================================================================================
@@ -92,10 +294,33 @@ BatteryStatus_t Battery_GetStatus(void)
  */
 void Battery_Check(void)
 {
-    float voltage;
+    int32 v_fast, v_slow, i_fast, i_slow;
+    uint16 peak_ma;
+    uint8 sampled;
+    uint16 voltage;
     
-    // 读取电压
-    voltage = Battery_GetVoltage();
+    // 滤波器快照 (控制中断中更新)
+    interrupt_global_disable();
+    v_fast  = s_volt_fast;
+    v_slow  = s_volt_slow;
+    i_fast  = s_curr_fast;
+    i_slow  = s_curr_slow;
+    peak_ma = g_battery.peak_ma;
+    sampled = s_sampled;
+    interrupt_global_enable();
+    
+    if (!sampled)
+    {
+        return;
+    }
+    
+    voltage = battery_q8_to_u16(v_slow);
+    battery_update_rint(v_fast, v_slow, i_fast, i_slow, peak_ma);
+    battery_update_comp(voltage);
+    
+    interrupt_global_disable();
+    s_battery_volt_x100 = voltage / 10;
+    interrupt_global_enable();
     
     // 判断状态
     if (voltage < BATTERY_CRITICAL_THRES)
@@ -105,9 +330,9 @@ void Battery_Check(void)
         Motor_Stop();               // 停止电机
         Battery_AlarmBuzzer(2);     // 快速报警
     }
-    else if (voltage < BATTERY_LOW_THRESHOLD)
+    else if (voltage < BATTERY_LOW_THRESHOLD || g_battery.predict_mv < BATTERY_CRITICAL_THRES)
     {
-        // 低电压警告
+        // 低电压警告 (或以实测最大负载电流计算会跌破严重阈值, 提前警告)
         s_battery_status = BATTERY_LOW;
         Battery_AlarmBuzzer(1);     // 慢速报警
     }
@@ -119,6 +344,50 @@ void Battery_Check(void)
     }
 }
 
+/**
+ * @brief   发送电池状态
+ */
+void Battery_SendReport(void)
+{
+    char line[72];
+    char *p;
+    uint16 fast_mv, current_ma, sag_count, sag_min;
+    
+    interrupt_global_disable();
+    fast_mv    = g_battery.fast_mv;
+    current_ma = g_battery.current_ma;
+    sag_count  = g_battery.sag_count;
+    sag_min    = g_battery.sag_min_mv;
+    interrupt_global_enable();
+    
+    p = line;
+    *p++ = 'B';
+    *p++ = 'A';
+    *p++ = 'T';
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, Battery_GetVoltageMv());
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, fast_mv);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, current_ma);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_battery.rint_mohm);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_battery.ocv_mv);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_battery.predict_mv);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, sag_count);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, (sag_min == 0xFFFF) ? 0 : sag_min);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, (uint16)s_battery_status);
+    *p++ = '\r';
+    *p++ = '\n';
+    *p   = '\0';
+    Bluetooth_SendString(line);
+}
+
 /*==================================================================================================================
  *                                              蜂鸣器报警
  *==================================================================================================================*/
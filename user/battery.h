@@ -1,7 +1,7 @@
 /*********************************************************************************************************************
  * @file        battery.h
  * @brief       飞檐走壁智能车 - 电池监测模块 (头文件)
- * @details     电压采样与低压保护
+ * @details     电压采样 (全整数 mV)、快慢两级滤波、负载压降检测、内阻估计与低压预测、低压保护
  * @author      智能车竞赛代码
  * @version     1.0
  * @date        2026-02-01
@@ -9,6 +9,19 @@
  * @note        电路: 电阻分压 (200k + 20k) + 100nF滤波
  *              分压比: 20 / (200 + 20) = 1/11
  *              计算: 实际电压 = ADC电压 × 11
+ *
+ *              - 采样: DMA 扫描模式下由控制中断每 5ms 调用 Battery_Update (只读扫描结果, 没有除法),
+ *                      非 DMA 模式下由主循环调用; ADC 值乘 Q16 常数换算为 mV, 不用浮点
+ *              - 滤波: 快滤波 (约 20ms) 跟随负载变化, 慢滤波 (约 320ms) 作为对外发布的电压,
+ *                      状态判断、电压补偿、显示和遥测都用慢滤波值
+ *              - 压降: 快滤波电压比慢滤波低出 BATTERY_SAG_MV 即为一次负载压降, 记录次数和最低电压
+ *              - 内阻: 负载电流由电机/风扇占空比推算 (BATTERY_MOTOR_MA / BATTERY_FAN_MA),
+ *                      快慢滤波的电压差 / 电流差 即内阻 (开路电压在 0.3s 内不变), 起步、加减速时更新;
+ *                      开路电压 = 电压 + 内阻 × 电流, 最大负载电压 = 开路电压 − 内阻 × 实测最大电流
+ *                      (上电以来快滤波电流的最大值), 后者低于 BATTERY_CRITICAL_THRES 时提前进入低压警告,
+ *                      而不是等跑到一半被停机; 还没跑过时最大电流为 0, 只按 BATTERY_LOW_THRESHOLD 判断
+ *              - 发送 $BAT 回复 "BAT 电压 快滤波电压 电流 内阻 开路电压 最大负载电压 压降次数 最低电压 状态"
+ *                (电压 mV, 电流 mA, 内阻 mΩ)
  ********************************************************************************************************************/
 
 #ifndef __BATTERY_H__
@@ -23,10 +36,29 @@
 typedef enum
 {
     BATTERY_OK = 0,         // 电池正常
-    BATTERY_LOW,            // 低电压警告 (<11.0V)
+    BATTERY_LOW,            // 低电压警告 (<11.0V, 或预测实测最大负载时 <10.5V)
     BATTERY_CRITICAL        // 严重低电压 (<10.5V)
 } BatteryStatus_t;
 
+/**
+ * @brief   电池监测数据 (调试可读, 由 Battery_Update / Battery_Check 更新)
+ */
+typedef struct
+{
+    uint16 voltage_mv;          // 慢滤波电压 (mV), 0 = 尚未采样
+    uint16 fast_mv;             // 快滤波电压 (mV)
+    uint16 current_ma;          // 估计负载电流 (mA, 快滤波)
+    uint16 rint_mohm;           // 估计内阻 (mΩ)
+    uint16 ocv_mv;              // 估计开路电压 (mV)
+    uint16 predict_mv;          // 预测实测最大负载时的电压 (mV)
+    uint16 peak_ma;             // 实测最大负载电流 (mA, 快滤波, 上电以来)
+    uint16 sag_count;           // 负载压降次数
+    uint16 sag_min_mv;          // 压降期间最低电压 (mV, 快滤波), 0xFFFF = 没有压降
+    uint8  sag_active;          // 1 = 正处于负载压降中
+} BatteryData_t;
+
+extern BatteryData_t g_battery;
+
 /*==================================================================================================================
  *                                              函数声明
  *==================================================================================================================*/
@@ -38,10 +70,40 @@ typedef enum
 void Battery_Init(void);
 
 /**
- * @brief   获取电池电压
- * @return  float   实际电池电压 (V)
+ * @brief   电压采样与滤波、压降检测
+ * @return  void
+ * @note    DMA 扫描模式下在控制中断中每 5ms 调用, 非 DMA 模式下在主循环中调用; 没有除法
+ */
+void Battery_Update(void);
+
+/**
+ * @brief   获取电池电压 (慢滤波)
+ * @return  uint16  电压 (mV), 0 = 尚未采样
+ */
+uint16 Battery_GetVoltageMv(void);
+
+/**
+ * @brief   获取电池电压 (慢滤波, 遥测格式)
+ * @return  uint16  电压 × 100 (1150 = 11.50V)
+ * @note    由 Battery_Check 每 100ms 更新, 只读缓存值, 可在中断中调用
+ */
+uint16 Battery_GetVoltageX100(void);
+
+/**
+ * @brief   获取电压补偿倍率
+ * @return  uint16  标称电压 / 滤波后电压 (Q12, 4096 = 1.0), 已限制在 BATTERY_COMP_MIN/MAX_X100 之间
+ * @note    由 Battery_Check 每 100ms 更新, 只读缓存值, 可在中断中调用;
+ *          BATTERY_COMP_ENABLE = 0 时恒为 4096
  */
-float Battery_GetVoltage(void);
+uint16 Battery_GetCompScale(void);
+
+/**
+ * @brief   获取电压补偿倍率的倒数
+ * @return  uint16  1 / Battery_GetCompScale() (Q12, 向下取整)
+ * @note    速度环用它把 "补偿后占空比上限" 换算成 "标称占空比上限", 让抗饱和看到补偿后的限幅;
+ *          与 Battery_GetCompScale 同时更新, 可在中断中调用
+ */
+uint16 Battery_GetCompInverse(void);
 
 /**
  * @brief   获取电池状态
@@ -51,13 +113,21 @@ BatteryStatus_t Battery_GetStatus(void);
 
 /**
  * @brief   电池检测任务 (周期调用)
- * @details 检测电压, 低于阈值时蜂鸣器报警
+ * @details 估计内阻、开路电压和最大负载电压
+ *          检测电压, 低于阈值 (或预测会低于严重阈值) 时蜂鸣器报警
  *          严重低电压时停机保护
+ *          更新电压补偿倍率 (电机/风扇输出使用)
  * @return  void
  * @note    建议每100ms调用一次
  */
 void Battery_Check(void);
 
+/**
+ * @brief   发送电池状态 "BAT ..." (格式见文件头)
+ * @return  void
+ */
+void Battery_SendReport(void);
+
 /**
  * @brief   蜂鸣器报警 (用于低电压警告)
  * @param   pattern     报警模式 (0=停止, 1=慢闪, 2=快闪)
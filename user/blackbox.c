@@ -0,0 +1,297 @@
+/*********************************************************************************************************************
+ * @file        blackbox.c
+ * @brief       飞檐走壁智能车 - 黑匣子记录模块 (源文件)
+ * @details     定长记录环形缓冲区 (控制中断写入) + 冻结 + 调试串口分批导出
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-27
+ ********************************************************************************************************************/
+
+#include "blackbox.h"
+#include "telemetry.h"
+#include "bluetooth.h"      // 导出头的数字格式化
+
+/*==================================================================================================================
+ *                                              私有变量
+ *==================================================================================================================*/
+
+#if BLACKBOX_ENABLE
+#define BLACKBOX_RAM_SIZE       BLACKBOX_BUF_SIZE
+#else
+#define BLACKBOX_RAM_SIZE       1                   // 关闭时不占用 RAM
+#endif
+
+static uint8 xdata s_buf[BLACKBOX_RAM_SIZE];        // 记录环形缓冲区
+
+static volatile uint8 s_state = BLACKBOX_IDLE;      // BlackBoxState_t (控制中断中会修改)
+static uint8  s_reason = BLACKBOX_REASON_NONE;      // 冻结原因
+static uint16 s_mask = BLACKBOX_DEFAULT_MASK;       // 记录字段
+static uint8  s_decimation = BLACKBOX_DECIMATION;   // 记录分频
+static uint8  s_decimation_cnt = 0;
+
+static uint8  s_rec_size = 0;                       // 每条记录字节数
+static uint16 s_capacity = 0;                       // 缓冲区可容纳的记录条数
+static uint16 s_end = 0;                            // 缓冲区使用的字节数 (容量 × 记录长度)
+static uint16 s_write = 0;                          // 下一条记录的写入位置 (字节)
+static uint16 s_count = 0;                          // 有效记录条数
+static uint16 s_post_total = 0;                     // 触发后需要记录的条数
+static uint16 s_post_count = 0;                     // 触发后已记录的条数
+
+static uint16 s_dump_pos = 0;                       // 下一条导出的记录序号 (0 = 最早一条)
+static uint16 s_dump_offset = 0;                    // 下一条导出的记录位置 (字节)
+static uint8  s_running_last = 0;                   // 上次主循环任务时的运行状态 (检测发车/停车)
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   发送导出头 "BBX 条数 分频 原因 触发后条数"
+ */
+static void blackbox_send_header(void)
+{
+    char line[40];
+    char *p;
+
+    p = line;
+    *p++ = 'B';
+    *p++ = 'B';
+    *p++ = 'X';
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, s_count);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, s_decimation);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, s_reason);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, s_post_count);
+    *p++ = '\r';
+    *p++ = '\n';
+    *p   = '\0';
+    uart_write_string(CAR_DEBUG_UART_INDEX, line);
+}
+
+/**
+ * @brief   把一条记录按遥测帧格式发出
+ */
+static void blackbox_send_record(uint8 seq, const uint8 xdata *rec)
+{
+    uint8 frame[TELEMETRY_FRAME_MAX];
+    uint16 crc;
+    uint8 i;
+
+    frame[0] = TELEMETRY_SYNC0;
+    frame[1] = TELEMETRY_SYNC1;
+    frame[2] = seq;
+    frame[3] = s_rec_size;
+    frame[4] = (uint8)(s_mask & 0xFF);
+    frame[5] = (uint8)(s_mask >> 8);
+    for (i = 0; i < s_rec_size; i++)
+    {
+        frame[TELEMETRY_HEADER_LEN + i] = rec[i];
+    }
+    crc = Telemetry_Crc16(&frame[2], (uint8)(s_rec_size + 4));
+    frame[TELEMETRY_HEADER_LEN + s_rec_size]     = (uint8)(crc & 0xFF);
+    frame[TELEMETRY_HEADER_LEN + s_rec_size + 1] = (uint8)(crc >> 8);
+
+    uart_write_buffer(CAR_DEBUG_UART_INDEX, frame, (uint32)(TELEMETRY_HEADER_LEN + s_rec_size + TELEMETRY_CRC_LEN));
+}
+
+/**
+ * @brief   发车: 清空缓冲区并开始记录 (主循环)
+ */
+static void blackbox_start(void)
+{
+    uint8 rec_size = Telemetry_GetPayloadLen(s_mask);
+    uint16 capacity;
+
+    interrupt_global_disable();
+    s_state = BLACKBOX_IDLE;
+    interrupt_global_enable();
+
+    if (!BLACKBOX_ENABLE || s_decimation == 0 || rec_size == 0)
+    {
+        return;
+    }
+
+    capacity = BLACKBOX_RAM_SIZE / rec_size;
+
+    interrupt_global_disable();
+    s_rec_size = rec_size;
+    s_capacity = capacity;
+    s_end = capacity * rec_size;
+    s_write = 0;
+    s_count = 0;
+    s_post_total = (uint16)((uint32)capacity * BLACKBOX_POST_PERCENT / 100);
+    s_post_count = 0;
+    s_reason = BLACKBOX_REASON_NONE;
+    s_decimation_cnt = s_decimation - 1;        // 发车后第一个周期就记录
+    s_state = BLACKBOX_RECORDING;
+    interrupt_global_enable();
+}
+
+/*==================================================================================================================
+ *                                              对外接口
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化黑匣子
+ */
+void BlackBox_Init(void)
+{
+    s_state = BLACKBOX_IDLE;
+    s_reason = BLACKBOX_REASON_NONE;
+    s_mask = BLACKBOX_DEFAULT_MASK;
+    s_decimation = BLACKBOX_DECIMATION;
+    s_count = 0;
+}
+
+/**
+ * @brief   控制周期记录
+ */
+void BlackBox_Record(void)
+{
+    if (s_state != BLACKBOX_RECORDING && s_state != BLACKBOX_TRIGGERED)
+    {
+        return;
+    }
+
+    s_decimation_cnt++;
+    if (s_decimation_cnt < s_decimation)
+    {
+        return;
+    }
+    s_decimation_cnt = 0;
+
+    Telemetry_PackFields(&s_buf[s_write], s_mask);
+    s_write += s_rec_size;
+    if (s_write >= s_end)
+    {
+        s_write = 0;
+    }
+    if (s_count < s_capacity)
+    {
+        s_count++;
+    }
+
+    if (s_state == BLACKBOX_TRIGGERED)
+    {
+        s_post_count++;
+        if (s_post_count >= s_post_total)
+        {
+            s_state = BLACKBOX_FROZEN;
+        }
+    }
+}
+
+/**
+ * @brief   触发: 再记录一段后冻结
+ */
+void BlackBox_Trigger(uint8 reason)
+{
+    interrupt_global_disable();
+    if (s_state == BLACKBOX_RECORDING)
+    {
+        s_reason = reason;
+        s_post_count = 0;
+        s_state = (s_post_total > 0) ? BLACKBOX_TRIGGERED : BLACKBOX_FROZEN;
+    }
+    interrupt_global_enable();
+}
+
+/**
+ * @brief   立即冻结
+ */
+void BlackBox_Freeze(uint8 reason)
+{
+    interrupt_global_disable();
+    if (s_state == BLACKBOX_RECORDING || s_state == BLACKBOX_TRIGGERED)
+    {
+        if (s_reason == BLACKBOX_REASON_NONE)
+        {
+            s_reason = reason;                  // 已触发时保留触发原因
+        }
+        s_state = BLACKBOX_FROZEN;
+    }
+    interrupt_global_enable();
+}
+
+/**
+ * @brief   重新导出当前缓冲区
+ */
+void BlackBox_Dump(void)
+{
+    if (s_state == BLACKBOX_DONE || s_state == BLACKBOX_DUMPING)
+    {
+        s_state = BLACKBOX_FROZEN;              // 由 BlackBox_Task 从头导出
+    }
+}
+
+/**
+ * @brief   设置记录分频
+ */
+void BlackBox_SetDecimation(uint8 decimation)
+{
+    s_decimation = decimation;
+}
+
+/**
+ * @brief   主循环任务
+ */
+void BlackBox_Task(uint8 running)
+{
+    uint8 n;
+
+    if (running)
+    {
+        // 发车 (按键倒计时结束或 $GO): 从头记录
+        if (!s_running_last)
+        {
+            blackbox_start();
+        }
+        s_running_last = 1;
+        return;
+    }
+    s_running_last = 0;
+
+    // 停车: 按键停车等不经过 System_Stop 的情况也在这里冻结
+    BlackBox_Freeze(BLACKBOX_REASON_STOP);
+
+    if (s_state == BLACKBOX_FROZEN)
+    {
+        blackbox_send_header();
+        s_dump_pos = 0;
+        s_dump_offset = (s_count < s_capacity) ? 0 : s_write;     // 写满后最早一条就在写入位置
+        s_state = BLACKBOX_DUMPING;
+    }
+
+    if (s_state != BLACKBOX_DUMPING)
+    {
+        return;
+    }
+
+    for (n = 0; n < BLACKBOX_DUMP_FRAMES && s_dump_pos < s_count; n++)
+    {
+        blackbox_send_record((uint8)s_dump_pos, &s_buf[s_dump_offset]);
+        s_dump_offset += s_rec_size;
+        if (s_dump_offset >= s_end)
+        {
+            s_dump_offset = 0;
+        }
+        s_dump_pos++;
+    }
+
+    if (s_dump_pos >= s_count)
+    {
+        uart_write_string(CAR_DEBUG_UART_INDEX, "BBX END\r\n");
+        s_state = BLACKBOX_DONE;
+    }
+}
+
+/**
+ * @brief   获取记录状态
+ */
+BlackBoxState_t BlackBox_GetState(void)
+{
+    return (BlackBoxState_t)s_state;
+}
@@ -0,0 +1,115 @@
+/*********************************************************************************************************************
+ * @file        blackbox.h
+ * @brief       飞檐走壁智能车 - 黑匣子记录模块 (头文件)
+ * @details     运行中把控制周期数据按固定字段记录到 RAM 环形缓冲区, 停车后经调试串口 (UART2, 115200bps) 导出
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-27
+ *
+ * @note        蓝牙 9600bps 的遥测只能 20Hz 发一部分字段, 全速冲出赛道前后的细节看不到;
+ *              黑匣子在 RAM 中逐周期记录, 事后再慢慢导出
+ *
+ *              - 记录: 发车时清空, 每 BLACKBOX_DECIMATION 个控制周期写一条, 写满后覆盖最早的记录;
+ *                      每条记录 = 按 BLACKBOX_DEFAULT_MASK 打包的遥测字段 (Telemetry_PackFields), 定长, 不含帧头
+ *              - 冻结: 停车 (按键、$STOP、低压保护等) 时立即冻结;
+ *                      墙上丢线紧急状态时触发, 再记录 BLACKBOX_POST_PERCENT% 缓冲区容量后冻结, 保留事故前后两段
+ *              - 导出: 冻结且已停车后自动导出一次 (主循环分批发送), $BBX 可再次导出;
+ *                      先发一行文本 "BBX 条数 分频 原因 触发后条数", 然后每条记录一帧 (帧格式与遥测相同,
+ *                      见 telemetry.h, seq 为记录序号, 从最早一条开始), 最后一行 "BBX END"
+ *              - 上位机: host/telemetry_decode 直接把导出的字节流转成 CSV (tick 列 × 5ms 即时间)
+ *
+ *              $BBX:N  设置记录分频 (下次发车生效), 0 = 不记录
+ *              $BBX    重新导出当前缓冲区
+ ********************************************************************************************************************/
+
+#ifndef __BLACKBOX_H__
+#define __BLACKBOX_H__
+
+#include "car_config.h"
+
+/*==================================================================================================================
+ *                                              数据结构
+ *==================================================================================================================*/
+
+/**
+ * @brief   记录状态
+ */
+typedef enum
+{
+    BLACKBOX_IDLE = 0,          // 未记录 (上电后尚未发车, 或分频为 0)
+    BLACKBOX_RECORDING,         // 记录中
+    BLACKBOX_TRIGGERED,         // 已触发, 记录触发后的一段
+    BLACKBOX_FROZEN,            // 已冻结, 等待导出
+    BLACKBOX_DUMPING,           // 导出中
+    BLACKBOX_DONE               // 已导出 (缓冲区保留, $BBX 可再次导出)
+} BlackBoxState_t;
+
+/**
+ * @brief   冻结原因
+ */
+typedef enum
+{
+    BLACKBOX_REASON_NONE = 0,
+    BLACKBOX_REASON_STOP,       // 停车
+    BLACKBOX_REASON_EMERGENCY   // 墙上丢线紧急状态
+} BlackBoxReason_t;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化黑匣子
+ * @return  void
+ */
+void BlackBox_Init(void);
+
+/**
+ * @brief   控制周期记录
+ * @return  void
+ * @note    在 System_Control() 中遥测之后调用, 只有复制, 没有乘除法
+ */
+void BlackBox_Record(void);
+
+/**
+ * @brief   触发: 再记录一段后冻结 (已触发或已冻结时忽略)
+ * @param   reason  BlackBoxReason_t
+ * @return  void
+ * @note    可在控制中断中调用
+ */
+void BlackBox_Trigger(uint8 reason);
+
+/**
+ * @brief   立即冻结 (未在记录时忽略)
+ * @param   reason  BlackBoxReason_t
+ * @return  void
+ */
+void BlackBox_Freeze(uint8 reason);
+
+/**
+ * @brief   重新导出当前缓冲区 ($BBX, 只在停车时有效)
+ * @return  void
+ */
+void BlackBox_Dump(void);
+
+/**
+ * @brief   设置记录分频 (下次发车生效)
+ * @param   decimation  每 N 个控制周期记录一条, 0 = 不记录
+ * @return  void
+ */
+void BlackBox_SetDecimation(uint8 decimation);
+
+/**
+ * @brief   主循环任务: 发车时清空并开始记录, 停车时冻结, 冻结后分批导出
+ * @param   running     1 = 车正在运行 (key_car_should_run)
+ * @return  void
+ */
+void BlackBox_Task(uint8 running);
+
+/**
+ * @brief   获取记录状态
+ * @return  BlackBoxState_t
+ */
+BlackBoxState_t BlackBox_GetState(void);
+
+#endif // __BLACKBOX_H__
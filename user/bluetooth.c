@@ -1,7 +1,7 @@
 /*********************************************************************************************************************
  * @file        bluetooth.c
  * @brief       飞檐走壁智能车 - 蓝牙通信模块 (源文件)
- * @details     实现 UART4 蓝牙调参系统
+ * @details     实现 UART4 蓝牙调参系统, 接收按行缓冲 (可积压多条命令), 发送走环形队列 + TX DMA, 不阻塞主循环
  * @author      智能车竞赛代码
  * @version     1.0
  * @date        2026-02-01
@@ -10,23 +10,54 @@
  *              $P:1.5\n    设置 Kp = 1.5
  *              $I:0.1\n    设置 Ki = 0.1
  *              $D:0.5\n    设置 Kd = 0.5
+ *                          (Kp/Ki/Kd 上限 31.9, 更大的值按上限生效, 见 pid.h)
  *              $S:100\n    设置目标速度 = 100
  *              $GO\n       启动
  *              $STOP\n     停止
- *              $DBG\n      请求调试信息
+ *              $DBG\n      请求一帧完整的二进制遥测 (格式见 telemetry.h)
  *              $F:50\n     设置风扇占空比 50%
+ *              $PRF\n      请求控制周期耗时报告 (附 OLED 刷新统计 "OLD ...")
+ *              $PRF:1\n    发送耗时报告后清零统计
+ *              $TEL:10\n   遥测每 10 个控制周期发送一帧, 0 = 关闭
+ *              $TMK:511\n  遥测字段掩码 (十进制)
+ *              $TRK:1\n    赛道记忆: 0 = 关闭, 1 = 重新学习, 2 = 按已有地图回放, 3 = 详细报告
+ *              $TRK\n      赛道记忆状态 "TRK ..." (格式见 track_map.c)
+ *              $CAL:1\n    电感标定: 1 = 开始扫线, 0 = 提前结束并应用, 2 = 放弃
+ *              $CAL\n      电感标定结果与当前校准参数 "CAL ..." (格式见 inductor_cal.h)
+ *              $SAVE\n     保存当前参数到 EEPROM (仅停车时), 回复 "PRM ..." (格式见 param_store.h)
+ *              $SAVE:0\n   擦除已保存的参数 (下次上电使用默认值), $SAVE:2 只查询状态
+ *              $GET:名称\n         查询可调参数, 回复 "PAR 名称 当前值 下限 上限" (参数表见 param_registry.c)
+ *              $SET:名称=数值\n    修改可调参数 (例如 $SET:t90_yaw=60), 回复同 $GET
+ *              $LIST\n     列出全部可调参数 (每项一行 "PAR ...")
+ *              $BAT\n      电池状态 "BAT ..." (电压、电流、内阻、压降统计, 格式见 battery.h)
+ *              $BBX:1\n    黑匣子每 1 个控制周期记录一条 (下次发车生效), 0 = 不记录
+ *              $BBX\n      停车时经调试串口重新导出黑匣子 (格式见 blackbox.h)
  ********************************************************************************************************************/
 
 #include "bluetooth.h"
+#include "param_registry.h"
 
 /*==================================================================================================================
  *                                              私有变量
  *==================================================================================================================*/
 
-// 接收缓冲区
-static uint8 s_rx_buffer[BLUETOOTH_RX_BUF_SIZE];
-static uint8 s_rx_index = 0;
-static uint8 s_rx_complete = 0;     // 接收完成标志
+// 接收行缓冲环: 中断直接写入当前行, 收到换行后整行交给主循环, 解析时原地使用, 不拷贝不清零
+static uint8 xdata s_rx_line[BLUETOOTH_RX_LINES][BLUETOOTH_RX_LINE_SIZE];
+static uint8 s_rx_write = 0;                // 中断正在写入的行
+static uint8 s_rx_read = 0;                 // 主循环下一个要解析的行
+static volatile uint8 s_rx_count = 0;       // 已收完、待解析的行数
+static uint8 s_rx_index = 0;                // 当前行已写入的字节数
+static uint8 s_rx_discard = 0;              // 1 = 行缓冲已满, 丢弃到本行结束
+static uint16 s_rx_drop_count = 0;          // 丢弃的命令行数
+
+// 发送环形队列 (DMA 直接从这里取数据, 必须位于 xdata)
+#define BT_TX_MASK      (BLUETOOTH_TX_BUF_SIZE - 1)
+static uint8 xdata s_tx_buffer[BLUETOOTH_TX_BUF_SIZE];
+static uint16 s_tx_head = 0;                // 写入位置
+static uint16 s_tx_tail = 0;                // 发送位置 (DMA 正在发送的段从这里开始)
+static volatile uint16 s_tx_count = 0;      // 队列中的字节数 (含正在发送的)
+static volatile uint16 s_tx_dma_len = 0;    // 正在发送的段长度, 0 = DMA 空闲
+static uint16 s_tx_drop_count = 0;          // 丢弃的数据段数
 
 // 回调函数指针
 static BT_PIDCallback_t s_pid_callback = 0;
@@ -143,21 +174,25 @@ static char* find_char(char *str, char c)
  */
 void Bluetooth_Init(void)
 {
-    uint8 i;
-    
     // 初始化 UART4
     uart_init(BLUETOOTH_UART_INDEX, BLUETOOTH_BAUD_RATE, BLUETOOTH_TX_PIN, BLUETOOTH_RX_PIN);
     
     // 使能接收中断
     uart_rx_interrupt(BLUETOOTH_UART_INDEX, 1);
     
-    // 清空缓冲区
-    for (i = 0; i < BLUETOOTH_RX_BUF_SIZE; i++)
-    {
-        s_rx_buffer[i] = 0;
-    }
+    // 清空行缓冲环
+    s_rx_write = 0;
+    s_rx_read = 0;
+    s_rx_count = 0;
     s_rx_index = 0;
-    s_rx_complete = 0;
+    s_rx_discard = 0;
+    s_rx_drop_count = 0;
+    
+    s_tx_head = 0;
+    s_tx_tail = 0;
+    s_tx_count = 0;
+    s_tx_dma_len = 0;
+    s_tx_drop_count = 0;
 }
 
 /*==================================================================================================================
@@ -166,32 +201,42 @@ void Bluetooth_Init(void)
 
 /**
  * @brief   UART4 接收中断处理函数
- * @note    在 isr.c 的 UART4 中断服务函数中调用
+ * @note    在 isr.c 的 DMA_UART4 接收中断中调用 (每字节一次), 只写当前行, 不等待主循环
  */
 void Bluetooth_RxHandler(uint8 dat)
 {
-    // 如果上一帧未处理, 丢弃
-    if (s_rx_complete)
+    // 检测行结束符 '\n' / '\r'
+    if (dat == '\n' || dat == '\r')
     {
+        if (s_rx_discard)
+        {
+            s_rx_discard = 0;
+            s_rx_drop_count++;
+        }
+        else if (s_rx_index > 0)
+        {
+            s_rx_line[s_rx_write][s_rx_index] = '\0';     // 字符串结尾
+            s_rx_write = (s_rx_write + 1 < BLUETOOTH_RX_LINES) ? (s_rx_write + 1) : 0;
+            s_rx_count++;                                   // 交给主循环
+        }
+        s_rx_index = 0;
         return;
     }
     
-    // 检测帧结束符 '\n'
-    if (dat == '\n' || dat == '\r')
+    // 行缓冲全部待解析: 当前行没有位置, 整行丢弃 (不能写入主循环正在解析的行)
+    if (s_rx_index == 0 && s_rx_count >= BLUETOOTH_RX_LINES)
     {
-        if (s_rx_index > 0)
-        {
-            s_rx_buffer[s_rx_index] = '\0';     // 字符串结尾
-            s_rx_complete = 1;                   // 标记接收完成
-        }
+        s_rx_discard = 1;
     }
-    else
+    if (s_rx_discard)
     {
-        // 存入缓冲区
-        if (s_rx_index < BLUETOOTH_RX_BUF_SIZE - 1)
-        {
-            s_rx_buffer[s_rx_index++] = dat;
-        }
+        return;
+    }
+    
+    // 存入当前行, 超长部分丢弃
+    if (s_rx_index < BLUETOOTH_RX_LINE_SIZE - 1)
+    {
+        s_rx_line[s_rx_write][s_rx_index++] = dat;
     }
 }
 
@@ -267,6 +312,42 @@ static void parse_command(char *cmd_str)
         {
             cmd = BT_CMD_FAN;
         }
+        else if (str_equal(cmd_str, "PRF") || str_equal(cmd_str, "prf"))
+        {
+            cmd = BT_CMD_PROFILE;
+        }
+        else if (str_equal(cmd_str, "TEL") || str_equal(cmd_str, "tel"))
+        {
+            cmd = BT_CMD_TELEMETRY;
+        }
+        else if (str_equal(cmd_str, "TMK") || str_equal(cmd_str, "tmk"))
+        {
+            cmd = BT_CMD_TEL_MASK;
+        }
+        else if (str_equal(cmd_str, "TRK") || str_equal(cmd_str, "trk"))
+        {
+            cmd = BT_CMD_TRACK;
+        }
+        else if (str_equal(cmd_str, "CAL") || str_equal(cmd_str, "cal"))
+        {
+            cmd = BT_CMD_CAL;
+        }
+        else if (str_equal(cmd_str, "SAVE") || str_equal(cmd_str, "save"))
+        {
+            cmd = BT_CMD_PARAM_STORE;
+        }
+        else if (str_equal(cmd_str, "BBX") || str_equal(cmd_str, "bbx"))
+        {
+            cmd = BT_CMD_BLACKBOX;
+        }
+        else if (str_equal(cmd_str, "GET") || str_equal(cmd_str, "get"))
+        {
+            ParamRegistry_CmdGet(colon_pos + 1);
+        }
+        else if (str_equal(cmd_str, "SET") || str_equal(cmd_str, "set"))
+        {
+            ParamRegistry_CmdSet(colon_pos + 1);
+        }
         
         // 调用命令回调
         if (s_cmd_callback && cmd != BT_CMD_UNKNOWN)
@@ -289,6 +370,34 @@ static void parse_command(char *cmd_str)
         {
             cmd = BT_CMD_DEBUG;
         }
+        else if (str_equal(cmd_str, "PRF") || str_equal(cmd_str, "prf"))
+        {
+            cmd = BT_CMD_PROFILE;
+        }
+        else if (str_equal(cmd_str, "TRK") || str_equal(cmd_str, "trk"))
+        {
+            cmd = BT_CMD_TRACK_INFO;
+        }
+        else if (str_equal(cmd_str, "CAL") || str_equal(cmd_str, "cal"))
+        {
+            cmd = BT_CMD_CAL_INFO;
+        }
+        else if (str_equal(cmd_str, "SAVE") || str_equal(cmd_str, "save"))
+        {
+            cmd = BT_CMD_SAVE;
+        }
+        else if (str_equal(cmd_str, "LIST") || str_equal(cmd_str, "list"))
+        {
+            cmd = BT_CMD_PARAM_LIST;
+        }
+        else if (str_equal(cmd_str, "BAT") || str_equal(cmd_str, "bat"))
+        {
+            cmd = BT_CMD_BATTERY;
+        }
+        else if (str_equal(cmd_str, "BBX") || str_equal(cmd_str, "bbx"))
+        {
+            cmd = BT_CMD_BLACKBOX_DUMP;
+        }
         
         // 调用命令回调
         if (s_cmd_callback && cmd != BT_CMD_UNKNOWN)
@@ -307,21 +416,15 @@ static void parse_command(char *cmd_str)
  */
 void Bluetooth_Process(void)
 {
-    uint8 i;
-    
-    // 检查是否有完整帧
-    if (s_rx_complete)
+    // 依次解析所有已收完的行 (原地解析, 解析期间中断继续写入其他行)
+    while (s_rx_count > 0)
     {
-        // 解析命令
-        parse_command((char *)s_rx_buffer);
+        parse_command((char *)s_rx_line[s_rx_read]);
         
-        // 清空缓冲区, 准备下一帧
-        for (i = 0; i < BLUETOOTH_RX_BUF_SIZE; i++)
-        {
-            s_rx_buffer[i] = 0;
-        }
-        s_rx_index = 0;
-        s_rx_complete = 0;
+        s_rx_read = (s_rx_read + 1 < BLUETOOTH_RX_LINES) ? (s_rx_read + 1) : 0;
+        interrupt_global_disable();
+        s_rx_count--;
+        interrupt_global_enable();
     }
 }
 
@@ -345,30 +448,187 @@ void Bluetooth_RegisterCmdCallback(BT_CmdCallback_t callback)
     s_cmd_callback = callback;
 }
 
+/**
+ * @brief   更新 PID 参数缓存
+ */
+void Bluetooth_SetPIDCache(int16 kp_x10, int16 ki_x10, int16 kd_x10)
+{
+    s_cached_kp_x10 = kp_x10;
+    s_cached_ki_x10 = ki_x10;
+    s_cached_kd_x10 = kd_x10;
+}
+
 /*==================================================================================================================
  *                                              发送函数
  *==================================================================================================================*/
 
+/**
+ * @brief   启动 DMA 发送队列头部的连续一段
+ * @note    调用时必须已关中断 (或位于 DMA 完成中断中)
+ *          DMA 只能发送连续地址, 队列回绕时分两段发送
+ */
+static void bluetooth_tx_start(void)
+{
+    uint16 len;
+    
+    len = BLUETOOTH_TX_BUF_SIZE - s_tx_tail;        // 到缓冲区末尾的连续长度
+    if (len > s_tx_count)
+    {
+        len = s_tx_count;
+    }
+    if (len > 256)
+    {
+        len = 256;                                  // 单次 DMA 最多 256 字节 (AMT 8 位)
+    }
+    s_tx_dma_len = len;
+    
+#ifndef CAR_HOST_BUILD
+    DMA_UR4T_STA  = 0x00;
+    DMA_UR4T_CFG  = 0x80;                               // UR4TIE = 1, 中断优先级 0, 总线优先级 0
+    DMA_UR4T_AMT  = (uint8)(len - 1);                   // 传输字节数 - 1
+    DMA_UR4T_AMTH = 0x00;
+    DMA_UR4T_TXAH = (uint8)((uint16)&s_tx_buffer[s_tx_tail] >> 8);
+    DMA_UR4T_TXAL = (uint8)((uint16)&s_tx_buffer[s_tx_tail]);
+    DMA_UR4T_CR   = 0xC0;                               // ENUR4T = 1, TRIG = 1
+#else
+    // 主机仿真: 直接写入串口桩, 立即完成
+    uart_write_buffer(BLUETOOTH_UART_INDEX, &s_tx_buffer[s_tx_tail], len);
+    Bluetooth_TxDmaIRQHandler();
+#endif
+}
+
+/**
+ * @brief   UART4 TX DMA 完成中断处理
+ */
+void Bluetooth_TxDmaIRQHandler(void)
+{
+#ifndef CAR_HOST_BUILD
+    DMA_UR4T_STA = 0x00;                // 清 UR4TIF
+#endif
+    
+    s_tx_tail  = (s_tx_tail + s_tx_dma_len) & BT_TX_MASK;
+    s_tx_count -= s_tx_dma_len;
+    s_tx_dma_len = 0;
+    
+    if (s_tx_count > 0)
+    {
+        bluetooth_tx_start();
+    }
+}
+
+/**
+ * @brief   写入发送队列
+ */
+uint8 Bluetooth_SendBuffer(const uint8 *dat, uint16 len)
+{
+    uint8 ok;
+    
+    interrupt_global_disable();
+    ok = Bluetooth_SendBufferNoLock(dat, len);
+    interrupt_global_enable();
+    return ok;
+}
+
+/**
+ * @brief   写入发送队列 (调用者已关中断)
+ */
+uint8 Bluetooth_SendBufferNoLock(const uint8 *dat, uint16 len)
+{
+    uint16 i;
+    
+    if (len == 0)
+    {
+        return 1;
+    }
+    
+    // 空间不足: 整段丢弃, 不发半帧
+    if (BLUETOOTH_TX_BUF_SIZE - s_tx_count < len)
+    {
+        s_tx_drop_count++;
+        return 0;
+    }
+    
+    for (i = 0; i < len; i++)
+    {
+        s_tx_buffer[s_tx_head] = dat[i];
+        s_tx_head = (s_tx_head + 1) & BT_TX_MASK;
+    }
+    s_tx_count += len;
+    
+    if (s_tx_dma_len == 0)
+    {
+        bluetooth_tx_start();
+    }
+    
+    return 1;
+}
+
+/**
+ * @brief   获取发送队列剩余空间
+ */
+uint16 Bluetooth_GetTxFree(void)
+{
+    return BLUETOOTH_TX_BUF_SIZE - s_tx_count;
+}
+
+/**
+ * @brief   获取丢弃的数据段数
+ */
+uint16 Bluetooth_GetTxDropCount(void)
+{
+    return s_tx_drop_count;
+}
+
+/**
+ * @brief   获取因行缓冲满而丢弃的命令行数
+ */
+uint16 Bluetooth_GetRxDropCount(void)
+{
+    return s_rx_drop_count;
+}
+
 /**
  * @brief   发送调试信息
  */
 void Bluetooth_SendString(const char *str)
 {
-    uart_write_string(BLUETOOTH_UART_INDEX, str);
+    uint16 len = 0;
+    
+    while (str[len])
+    {
+        len++;
+    }
+    Bluetooth_SendBuffer((const uint8 *)str, len);
 }
 
 /**
- * @brief   发送格式化调试数据 (简化版)
+ * @brief   追加十进制整数到报告行
  */
-void Bluetooth_SendDebugData(int16 err, int16 spd_l, int16 spd_r, int16 volt_x10)
+char *Bluetooth_AppendInt(char *p, int32 value)
 {
-    // 简化版: 仅发送一个标记
-    // 实际使用时可以扩展格式化函数
-    uart_write_string(BLUETOOTH_UART_INDEX, "DBG\r\n");
-    
-    // 避免未使用参数警告
-    (void)err;
-    (void)spd_l;
-    (void)spd_r;
-    (void)volt_x10;
+    char tmp[5];
+    uint16 mag;
+    uint8 n = 0;
+
+    if (value < 0)
+    {
+        *p++ = '-';
+        mag = (uint16)(-value);
+    }
+    else
+    {
+        mag = (uint16)value;
+    }
+
+    do
+    {
+        tmp[n++] = (char)('0' + mag % 10);
+        mag /= 10;
+    } while (mag > 0);
+
+    while (n > 0)
+    {
+        *p++ = tmp[--n];
+    }
+    return p;
 }
@@ -32,6 +32,19 @@ typedef enum
     BT_CMD_STOP,            // 停止
     BT_CMD_DEBUG,           // 调试信息输出
     BT_CMD_FAN,             // 风扇控制
+    BT_CMD_PROFILE,         // 控制周期耗时报告
+    BT_CMD_TELEMETRY,       // 设置遥测分频
+    BT_CMD_TEL_MASK,        // 设置遥测字段
+    BT_CMD_TRACK,           // 赛道记忆模式
+    BT_CMD_TRACK_INFO,      // 赛道记忆状态
+    BT_CMD_CAL,             // 电感标定
+    BT_CMD_CAL_INFO,        // 电感标定结果
+    BT_CMD_SAVE,            // 保存参数到 EEPROM
+    BT_CMD_PARAM_STORE,     // 参数存储操作 (0 = 擦除, 1 = 保存, 2 = 状态)
+    BT_CMD_PARAM_LIST,      // 列出参数表 ($GET/$SET 由参数表模块直接处理)
+    BT_CMD_BATTERY,         // 电池状态报告
+    BT_CMD_BLACKBOX,        // 设置黑匣子记录分频
+    BT_CMD_BLACKBOX_DUMP,   // 重新导出黑匣子
     BT_CMD_UNKNOWN          // 未知命令
 } BluetoothCmd_t;
 
@@ -67,8 +80,8 @@ void Bluetooth_Init(void);
 
 /**
  * @brief   蓝牙数据处理任务
- * @details 解析接收缓冲区中的命令, 调用相应回调函数
- *          应在主循环中周期调用
+ * @details 依次解析行缓冲环中所有已收完的命令, 调用相应回调函数
+ *          应在主循环中周期调用 (两次调用之间最多积压 BLUETOOTH_RX_LINES 条命令)
  * @return  void
  */
 void Bluetooth_Process(void);
@@ -87,26 +100,81 @@ void Bluetooth_RegisterPIDCallback(BT_PIDCallback_t callback);
  */
 void Bluetooth_RegisterCmdCallback(BT_CmdCallback_t callback);
 
+/**
+ * @brief   更新 PID 参数缓存 (上电从 EEPROM 加载参数后调用)
+ * @param   kp_x10  Kp × 10
+ * @param   ki_x10  Ki × 10
+ * @param   kd_x10  Kd × 10
+ * @return  void
+ * @note    $P/$I/$D 只修改其中一项, 其余两项取自缓存, 缓存必须与实际生效的参数一致
+ */
+void Bluetooth_SetPIDCache(int16 kp_x10, int16 ki_x10, int16 kd_x10);
+
 /**
  * @brief   发送调试信息 (通过蓝牙)
  * @param   str     要发送的字符串
  * @return  void
+ * @note    写入发送队列后立即返回, 队列空间不足时整条丢弃 (计入丢弃计数)
  */
 void Bluetooth_SendString(const char *str);
 
 /**
- * @brief   发送格式化数据 (PID调试用)
- * @param   err         当前偏差
- * @param   spd_l       左轮速度
- * @param   spd_r       右轮速度
- * @param   volt_x10    电池电压 × 10 (例如 115 表示 11.5V)
+ * @brief   追加十进制整数到报告行 (不依赖 sprintf)
+ * @param   p       写入位置
+ * @param   value   数值 (-32768 ~ 65535, 覆盖 int16 与 uint16)
+ * @return  char*   写入后的位置 (不补 '\0')
+ * @note    各模块的文本报告共用; 字段之间的空格等分隔符由调用者写入
+ */
+char *Bluetooth_AppendInt(char *p, int32 value);
+
+/**
+ * @brief   把一段数据写入发送队列, 由 UART4 TX DMA 在后台发出
+ * @param   dat     数据
+ * @param   len     长度
+ * @return  uint8   1 = 已入队, 0 = 空间不足, 整段丢弃
+ * @note    不阻塞, 可在主循环和定时中断中调用
+ */
+uint8 Bluetooth_SendBuffer(const uint8 *dat, uint16 len);
+
+/**
+ * @brief   同 Bluetooth_SendBuffer, 但由调用者负责关中断
+ * @param   dat     数据
+ * @param   len     长度
+ * @return  uint8   1 = 已入队, 0 = 空间不足, 整段丢弃
+ * @note    用于入队与调用者自己的共享状态 (例如遥测帧序号) 必须在同一临界区内更新的场合
+ */
+uint8 Bluetooth_SendBufferNoLock(const uint8 *dat, uint16 len);
+
+/**
+ * @brief   获取发送队列剩余空间 (字节)
+ * @return  uint16
+ * @note    发送方可据此提前放弃 (例如遥测本周期不打包)
+ */
+uint16 Bluetooth_GetTxFree(void);
+
+/**
+ * @brief   获取因队列满而丢弃的数据段数
+ * @return  uint16
+ */
+uint16 Bluetooth_GetTxDropCount(void);
+
+/**
+ * @brief   获取因接收行缓冲满而丢弃的命令行数
+ * @return  uint16
+ * @note    连续发送超过 BLUETOOTH_RX_LINES 条命令且主循环来不及处理时才会丢弃
+ */
+uint16 Bluetooth_GetRxDropCount(void);
+
+/**
+ * @brief   UART4 TX DMA 完成中断处理
+ * @note    在 isr.c 的 DMA_UR4T 中断服务函数中调用, 释放已发送的数据并启动下一段
  * @return  void
  */
-void Bluetooth_SendDebugData(int16 err, int16 spd_l, int16 spd_r, int16 volt_x10);
+void Bluetooth_TxDmaIRQHandler(void);
 
 /**
  * @brief   UART4 接收中断处理函数
- * @details 在 isr.c 的 UART4 中断中调用
+ * @details 在 isr.c 的 DMA_UART4 接收中断中调用, 按行写入行缓冲环 (BLUETOOTH_RX_LINES 行)
  * @param   dat     接收到的字节
  * @return  void
  */
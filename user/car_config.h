@@ -30,6 +30,7 @@
 #define DEBUG_ENABLE            1               // 总调试开关 (编译时开启, 运行时由拨码开关控制)
 #define DEBUG_UART_ENABLE       1               // 串口调试输出
 #define DEBUG_OLED_ENABLE       1               // OLED显示调试
+#define PROFILER_ENABLE         1               // System_Control 分段耗时统计 (profiler.c)
 
 /*==================================================================================================================
  *                                              运行模式定义
@@ -100,6 +101,11 @@ typedef enum {
 #define ENCODER_LEFT_REVERSE    0
 #define ENCODER_RIGHT_REVERSE   1                   // 左右电机对称安装，通常需要取反
 
+// 里程计参数 (pose.c), 换轮胎/编码器后需重新标定
+#define POSE_UM_PER_COUNT       50                  // 每个脉冲对应里程 (μm), 推车直行 1m 读脉冲数换算
+#define POSE_TRACK_WIDTH_MM     155                 // 左右轮距 (mm), 用于差速推算航向
+#define POSE_ODO_WEIGHT_SHIFT   8                   // 差速航向修正陀螺仪积分的权重 = 1/256 (每周期, 时间常数约 1.3s)
+
 /*==================================================================================================================
  *                                              电磁循迹引脚定义
  *==================================================================================================================*/
@@ -130,16 +136,61 @@ typedef enum {
 #define INDUCTOR_RY_MIN         200             // 右纵向电感最小值
 #define INDUCTOR_RY_MAX         3800            // 右纵向电感最大值
 
+// 电感自动标定 (inductor_cal.c): 长按启动键或 $CAL:1 开始, 停车状态下把车横向来回扫过导线
+#define INDUCTOR_CAL_TIME_MS    6000            // 扫描时长 (ms), 到时自动结束并应用 ($CAL:0 提前结束)
+#define INDUCTOR_CAL_MIN_SPAN   400             // 通道最小跨度 (ADC 值), 不足认为没扫到, 该通道保留原参数
+
 /*==================================================================================================================
  *                                              电池电压监测引脚定义
  *==================================================================================================================*/
 // 电阻分压采样: 上拉200k, 下拉20k, 分压比 = 20 / (200 + 20) = 1/11
 
 #define BATTERY_ADC_CH          ADC_CH5_P15     // 电池电压采样引脚 P1.5
-#define BATTERY_DIVIDER_RATIO   11.0f           // 分压系数 (实际电压 = ADC电压 × 11)
+#define BATTERY_DIVIDER_RATIO   11              // 分压系数 (实际电压 = ADC电压 × 11)
 #define BATTERY_ADC_REF_MV      3300            // ADC参考电压 (mV)
-#define BATTERY_LOW_THRESHOLD   11.0f           // 低压保护阈值 (V)
-#define BATTERY_CRITICAL_THRES  10.5f           // 严重低压阈值 (V), 立即停机
+#define BATTERY_LOW_THRESHOLD   11000           // 低压警告阈值 (mV)
+#define BATTERY_CRITICAL_THRES  10500           // 严重低压阈值 (mV), 立即停机
+
+// 电压滤波与负载压降 (DMA 扫描模式下每个控制周期采样一次)
+#define BATTERY_FAST_SHIFT      2               // 快滤波: 时间常数 4 个周期 (20ms), 去掉纹波, 保留负载变化
+#define BATTERY_SLOW_SHIFT      6               // 慢滤波: 时间常数 64 个周期 (320ms), 用于状态判断和电压补偿
+#define BATTERY_SAG_MV          300             // 快滤波电压比慢滤波低出此值认为处于负载压降中
+
+// 负载电流估计 (按占空比推算, 用卡表在典型工况下实测后填入) 与内阻估计
+#define BATTERY_MOTOR_MA        3000            // 单个电机满占空比电流 (mA)
+#define BATTERY_FAN_MA          5000            // 风扇满占空比电流 (mA)
+#define BATTERY_RINT_INIT_MOHM  100             // 内阻初值 (mΩ)
+#define BATTERY_RINT_MIN_MOHM   10              // 内阻估计有效范围 (mΩ), 超出的样本丢弃
+#define BATTERY_RINT_MAX_MOHM   500
+#define BATTERY_RINT_MIN_DI_MA  800             // 快慢滤波电流差超过此值 (mA) 才估计内阻
+#define BATTERY_RINT_SHIFT      3               // 内阻样本一阶滤波 (每 100ms 最多一个样本)
+
+// 电压补偿: 电机/风扇占空比按 标称电压 / 实际电压 放大, 整个放电过程中同样的占空比给出同样的平均电压
+#ifndef BATTERY_COMP_ENABLE
+#define BATTERY_COMP_ENABLE     1
+#endif
+#define BATTERY_NOMINAL_MV      12000           // 标称电压 (mV): 各增益、前馈系数、风扇占空比均以此电压整定
+#define BATTERY_COMP_MIN_X100   90              // 补偿倍率下限 ×100 (满电 12.6V 时约 0.95)
+#define BATTERY_COMP_MAX_X100   130             // 补偿倍率上限 ×100 (电压读数异常时不让占空比放大过多)
+
+/*==================================================================================================================
+ *                                              ADC DMA 扫描配置
+ *==================================================================================================================*/
+// 开启后 4 路电感 + 电池通道由 ADC DMA 在后台连续扫描 (adc_scan.c),
+// 控制中断只读取最近一帧的硬件平均值, 不再阻塞等待 ADC 转换
+// 关闭 (0) 则回退到 adc_mean_filter_convert 逐通道阻塞采样
+
+#ifndef ADC_SCAN_DMA_ENABLE
+#define ADC_SCAN_DMA_ENABLE     1
+#endif
+#define ADC_SCAN_CVT_SHIFT      6               // 每帧每通道转换 2^6 = 64 次, 由硬件求平均 (可选 0~8)
+
+// DMA 通道选择寄存器使用原始通道号, 必须与上面的 ADC_CHx_Pxx 一一对应
+#define INDUCTOR_LEFT_X_ADC_NUM     8           // ADC_CH8_P00
+#define INDUCTOR_LEFT_Y_ADC_NUM     13          // ADC_CH13_P05
+#define INDUCTOR_RIGHT_X_ADC_NUM    9           // ADC_CH9_P01
+#define INDUCTOR_RIGHT_Y_ADC_NUM    14          // ADC_CH14_P06
+#define BATTERY_ADC_NUM             5           // ADC_CH5_P15
 
 /*==================================================================================================================
  *                                              蜂鸣器引脚定义
@@ -167,7 +218,13 @@ typedef enum {
 #define BLUETOOTH_TX_PIN        UART4_TX_P03    // TX = P0.3
 #define BLUETOOTH_RX_PIN        UART4_RX_P02    // RX = P0.2
 #define BLUETOOTH_BAUD_RATE     9600            // 波特率 9600bps
-#define BLUETOOTH_RX_BUF_SIZE   64              // 接收缓冲区大小
+#define BLUETOOTH_RX_LINE_SIZE  64              // 接收: 单行最大长度 (含结尾 '\0', 超长部分丢弃)
+#define BLUETOOTH_RX_LINES      4               // 接收: 行缓冲个数 (主循环来不及处理时最多积压的命令数)
+#define BLUETOOTH_TX_BUF_SIZE   512             // 发送环形队列大小 (必须为 2 的幂), DMA 后台发送
+
+// 二进制遥测 (telemetry.c), 9600bps 约 960 字节/秒
+#define TELEMETRY_DECIMATION    10              // 每 N 个控制周期发送一帧 (10 × 5ms = 50ms, 20Hz), 0 = 关闭
+#define TELEMETRY_DEFAULT_MASK  0x01FF          // 默认发送的字段 (见 telemetry.h), 全部字段一帧 33 字节
 
 /*==================================================================================================================
  *                                              调试串口引脚定义
@@ -180,6 +237,18 @@ typedef enum {
 #define CAR_DEBUG_RX_PIN        UART2_RX_P10    // RX = P1.0
 #define CAR_DEBUG_BAUD_RATE     115200          // 波特率 115200bps
 
+// 黑匣子 (blackbox.c): 运行中每 N 个控制周期把一条定长记录写入 RAM 环形缓冲区 (写满覆盖最早的),
+// 停车时冻结 (墙上丢线紧急状态触发后再记录一段再冻结), 停车后经调试串口导出, 用 host/telemetry_decode 转 CSV
+#ifndef BLACKBOX_ENABLE
+#define BLACKBOX_ENABLE         1
+#endif
+#define BLACKBOX_BUF_SIZE       4096            // 记录缓冲区 (字节, xdata)
+#define BLACKBOX_DECIMATION     1               // 每 N 个控制周期记录一条 ($BBX:N 修改, 0 = 不记录)
+#define BLACKBOX_DEFAULT_MASK   0x0769          // 记录字段 (见 telemetry.h): 周期计数、编码器、PWM、元素、姿态、
+                                                // 电感原始值和归一化值, 每条 28 字节, 4096 字节约 146 条 (0.73s)
+#define BLACKBOX_POST_PERCENT   25              // 触发后继续记录的条数 (占缓冲区容量的百分比), 之后冻结
+#define BLACKBOX_DUMP_FRAMES    4               // 导出时每次主循环发送的记录数 (115200bps 下约 13ms)
+
 /*==================================================================================================================
  *                                              负压风扇引脚定义
  *==================================================================================================================*/
@@ -196,6 +265,19 @@ typedef enum {
 #define FAN_ANGLE_THRESHOLD     15              // 开始增大吸力的俯仰角阈值 (度)
 #define FAN_ANGLE_MAX           60              // 最大倾斜角 (度)
 
+// 模型风扇控制 (fan.c Fan_Control): 按俯仰角速度预测上墙、按车速预转, 墙上保持吸力, 离墙后斜坡下降
+// FAN_MODEL_ENABLE = 0 时使用原俯仰角线性映射 (Fan_AutoAdjust)
+#ifndef FAN_MODEL_ENABLE
+#define FAN_MODEL_ENABLE        1
+#endif
+#define FAN_LEAD_MS             150             // 俯仰角预测超前时间 (ms), 约等于风扇起转时间常数
+#define FAN_SPEED_GAIN          10              // 车速预转: 每单位速度 (脉冲/周期) 增加的地面占空比
+#define FAN_SPEED_DUTY_MAX      3000            // 车速预转最多增加的占空比
+#define FAN_HOLD_MS             300             // 俯仰角回到上墙角以下后继续保持上墙吸力的时间 (ms)
+#define FAN_RAMP_DOWN           25              // 吸力下降斜率 (占空比/周期), 8000 → 3000 约 1s
+#define FAN_TAU_SHIFT           5               // 风扇转速模型: 一阶滞后, 时间常数 2^5 个周期 (160ms)
+#define FAN_BOOST_Q8            256             // 起转超调: 输出 = 目标 + 系数 × (目标 − 模型转速), Q8 (256 = 1.0)
+
 /*==================================================================================================================
  *                                              IMU660RA 引脚定义
  *==================================================================================================================*/
@@ -207,6 +289,15 @@ typedef enum {
 #define IMU_SPI_MISO_PIN        IO_P42          // SPI主入从出 P4.2
 #define IMU_SPI_CS_PIN          IO_P43          // SPI片选 P4.3
 
+// 姿态解算参数 (attitude.c)
+#define ATTITUDE_ACC_1G             4096        // 加速度计 1g 对应原始值 (±8g 量程)
+#define ATTITUDE_GYRO_LSB_X10       164         // 陀螺仪 1°/s 对应原始值 × 10 (±2000dps 量程为 16.4)
+#define ATTITUDE_ACC_WEIGHT_SHIFT   6           // 互补滤波加速度计权重 = 1/64 (每次更新)
+#define ATTITUDE_ACC_GATE_PCT       20          // 加速度模长偏离 1g 超过 20% 时不做修正 (振动/冲击)
+#define ATTITUDE_STILL_GYRO_THRESH  20          // 静止判定: 相邻两次陀螺仪原始值变化阈值
+#define ATTITUDE_STILL_TIME_MS      500         // 静止判定: 持续时间 (ms)
+#define ATTITUDE_BIAS_SHIFT         4           // 零偏学习滤波系数 = 1/16
+
 /*==================================================================================================================
  *                                              OLED 引脚定义
  *==================================================================================================================*/
@@ -215,22 +306,86 @@ typedef enum {
 #define OLED_I2C_SCL_PIN        IO_P25          // I2C时钟 P2.5
 #define OLED_I2C_SDA_PIN        IO_P24          // I2C数据 P2.4
 
+// 调试页面刷新 (DebugDisplay_Task, 每次主循环推进一步)
+#define DEBUG_OLED_REFRESH_LOOPS    20          // 每 N 次主循环开始重绘一帧 (约 10Hz)
+#define OLED_FLUSH_BUDGET_BYTES     16          // 每次主循环最多发送的 I2C 字节数 (每字节 17 个半周期延时, 约 90us/字节, 16 字节 ≈ 1.5ms)
+
+/*==================================================================================================================
+ *                                              赛道记忆参数
+ *==================================================================================================================*/
+// 第一圈低速学习, 之后按里程查表给目标速度 (track_map.c), 蓝牙 $TRK 控制
+
+#define TRACK_BIN_DIST          1000            // 每格里程 (编码器脉冲, 约 5cm)
+#define TRACK_MAX_BINS          256             // 最大格数 (元素记录用 uint8 存格号, 不能超过 256)
+#define TRACK_MAX_EVENTS        32              // 最多记录的元素数
+#define TRACK_LAP_YAW           360             // 一圈累计转角 (度)
+#define TRACK_LAP_YAW_MARGIN    15              // 累计转角达到 360 - 15 度即判定一圈结束 (陀螺仪积分不会恰好到 360)
+#define TRACK_LEARN_SPEED       40              // 学习圈目标速度上限
+
+#define TRACK_CORNER_WINDOW     4               // 急弯判定: 往前看的格数
+#define TRACK_CORNER_YAW        30              // 急弯判定: 窗口内累计转角 (度)
+#define TRACK_CORNER_PERCENT    80              // 急弯/直角弯速度 (%)
+#define TRACK_HEXAGON_PERCENT   70              // 环岛速度 (%)
+#define TRACK_BRAKE_STEP        6               // 弯前减速斜率 (每格最多 6 个百分点, 100 → 80 约 4 格 / 20cm)
+#define TRACK_ANCHOR_WINDOW     8               // 元素位置校准的搜索范围 (格)
+
+/*==================================================================================================================
+ *                                              参数存储 (IAP EEPROM)
+ *==================================================================================================================*/
+// 蓝牙调好的参数保存在片内 EEPROM (param_store.c), 上电加载, $SAVE 保存
+// STC-ISP 下载时 EEPROM 大小至少设为 PARAM_STORE_BASE_ADDR + 2 × PARAM_STORE_SECTOR_SIZE (默认 1K)
+
+#define PARAM_STORE_BASE_ADDR   0x0000          // EEPROM 区内起始偏移 (必须扇区对齐)
+#define PARAM_STORE_SECTOR_SIZE 512             // IAP 擦除扇区大小 (STC32G 为 512 字节)
+
 /*==================================================================================================================
  *                                              PID 参数默认值
  *==================================================================================================================*/
 
-// 速度环 PID (增量式)
+// 速度环 PID (speed_ctrl.c 中为位置式 PI + 前馈, SPEED_CTRL_ENABLE = 0 时为增量式)
 #define PID_SPEED_KP            2.0f
 #define PID_SPEED_KI            0.5f
 #define PID_SPEED_KD            0.0f
 #define PID_SPEED_OUT_MAX       MOTOR_PWM_DUTY_MAX
 
+// 速度控制 (speed_ctrl.c): 静态模型前馈 + PI + 条件积分 + 变化率限制; 0 = 使用原增量式 PID
+#ifndef SPEED_CTRL_ENABLE
+#define SPEED_CTRL_ENABLE       1
+#endif
+#define SPEED_FF_DUTY_X100      2000            // 前馈: 每单位速度 (脉冲/周期) 稳态占空比 ×100 (标称电压下标定)
+#define SPEED_FF_STATIC_DUTY    0               // 前馈: 起步占空比 (克服静摩擦, 目标速度非零时叠加)
+#define SPEED_MODEL_SHIFT       4               // 积分参考模型时间常数 = 2^4 个周期 (80ms, 接近电机时间常数)
+#define SPEED_SLEW_MAX          600             // 每个控制周期占空比最大变化 (600 → 约 85ms 从 0 到满)
+
 // 方向环 PID (位置式)
 #define PID_DIRECTION_KP        5.0f
 #define PID_DIRECTION_KI        0.0f
 #define PID_DIRECTION_KD        3.0f
 #define PID_DIRECTION_OUT_MAX   3000
 
+// 串级转向 (steer.c): 方向环为外环, 陀螺仪角速度为内环
+// 默认关闭: 内环使差速瞬时放大 (1 + 内环比例) 倍, 且 gyro_z 与差速同号 (右转为正) 尚未在车上确认,
+// 符号反了内环就是正反馈. 架空车轮手转车身确认符号后再打开, 并重新整定外环增益
+#ifndef STEER_CASCADE_ENABLE
+#define STEER_CASCADE_ENABLE    0
+#endif
+#define STEER_RATE_KP_X100      300             // 内环比例 (×100): 角速度误差折算成差速后的倍数
+#define STEER_FF_WINDOW         8               // 曲率前馈: 偏差趋势窗口 (8 × 5ms = 40ms)
+#define STEER_FF_GAIN           60              // 曲率前馈增益: 差速 = 偏差变化量 × 基础速度 × 增益 / 10000
+
+// 方向环偏差符号 (Inductor_Process 给出的 error 在左侧信号强时为负)
+//   -1: 原代码的 PID(0, error), 左侧信号强时左轮加速 (向右转)
+//    1: PID(error, 0), 左侧信号强时左轮减速 (向左转)
+// 固件保持 -1; 上位机仿真模型 (左侧电感在车身左侧) 以 -DSTEER_ERROR_SIGN=1 编译.
+// 改固件默认值前先按 steer.c 中的方法在车上确认
+#ifndef STEER_ERROR_SIGN
+#define STEER_ERROR_SIGN        -1
+#endif
+
+// 1 个单位差速 (左 +1, 右 -1 脉冲/周期) 对应的偏航角速度 (陀螺仪原始值), 由轮距和里程标定推出
+#define STEER_GYRO_PER_OUTPUT   ((int32)2 * POSE_UM_PER_COUNT * 5730 * ATTITUDE_GYRO_LSB_X10 / \
+                                 ((int32)CONTROL_PERIOD_MS * POSE_TRACK_WIDTH_MM * 1000))
+
 // 姿态环 PID (用于上墙平衡)
 #define PID_ATTITUDE_KP         1.0f
 #define PID_ATTITUDE_KI         0.0f
@@ -250,8 +405,4 @@ typedef enum {
 // 符号函数宏
 #define SIGN_VALUE(x)           ((x) > 0 ? 1 : ((x) < 0 ? -1 : 0))
 
-// 快速平方根 (使用整数近似, 适用于电感向量计算, 提高运算速度)
-// 输入范围: 0 ~ 20000, 精度约 5%
-uint16 fast_sqrt(uint32 val);
-
 #endif // __CAR_CONFIG_H__
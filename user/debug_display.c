@@ -14,6 +14,8 @@
 #include "element.h"
 #include "bluetooth.h"
 #include "system.h"
+#include "profiler.h"
+#include "telemetry.h"
 #include "zf_device_imu660ra.h"
 
 /*==================================================================================================================
@@ -22,6 +24,28 @@
 
 DebugData_t g_debug;
 
+/*==================================================================================================================
+ *                                              私有变量
+ *==================================================================================================================*/
+
+/* 分时刷新状态机 */
+typedef enum
+{
+    DD_STATE_WAIT = 0,      /* 等待下一帧 */
+    DD_STATE_DRAW,          /* 逐行写显存, 同时按预算发送 */
+    DD_STATE_FLUSH          /* 显存已画完, 按预算发送剩余改动 */
+} DebugDisplayState_t;
+
+static DebugDisplayState_t s_state = DD_STATE_WAIT;
+static uint8  s_wait_cnt = 0;
+static uint8  s_row = 0;
+static uint8  s_frame_calls = 0;
+
+/* 刷新统计 ($PRF 报告) */
+static uint16 s_stat_max_bytes = 0;     /* 单次调用发送的最大字节数 */
+static uint8  s_stat_frame_calls = 0;   /* 上一帧用了几次调用 */
+static uint16 s_stat_frames = 0;        /* 已完成的帧数 */
+
 /*==================================================================================================================
  *                                              初始化
  *==================================================================================================================*/
@@ -37,8 +61,10 @@ void DebugDisplay_Init(void)
     /* 显示启动画面 */
     oled_show_string(20, 2, "Smart Car");
     oled_show_string(10, 4, "Debug System");
+    oled_refresh();
     system_delay_ms(500);
     oled_clear();
+    oled_refresh();
 }
 
 /*==================================================================================================================
@@ -68,12 +94,18 @@ void DebugDisplay_Update(void)
     g_debug.gyro_z_raw  = imu660ra_gyro_z;
     
     /* 系统状态 */
-    g_debug.battery_volt_x10 = (int16)(Battery_GetVoltage() * 10);
+    g_debug.battery_volt_x10 = (int16)(Battery_GetVoltageMv() / 100);
     g_debug.element_type     = (uint8)Element_GetType();
     
     /* PWM 输出 */
     g_debug.pwm_left  = g_system.motor_left_pwm;
     g_debug.pwm_right = g_system.motor_right_pwm;
+    
+    /* 控制周期耗时 */
+    g_debug.ctrl_mean_us  = Profiler_GetMeanUs(PROF_STAGE_TOTAL);
+    g_debug.ctrl_max_us   = Profiler_GetMaxUs(PROF_STAGE_TOTAL);
+    g_debug.ctrl_overrun  = g_profiler.overrun;
+    g_debug.slowest_stage = (uint8)Profiler_GetSlowestStage();
 }
 
 /*==================================================================================================================
@@ -97,6 +129,118 @@ char DebugDisplay_GetElementChar(uint8 elem_type)
     }
 }
 
+/**
+ * @brief   向显存绘制一行
+ * @param   row     行号 (0~7)
+ * @note    只写显存, 不访问 I2C
+ */
+static void debug_display_draw_row(uint8 row)
+{
+    switch (row)
+    {
+        case 0:
+            /*-------------------------------------------------
+             * 行 0: 电感数据 (左/右模值 + 偏差)
+             * 格式: L:xx R:xx E:xxx
+             *-------------------------------------------------*/
+            oled_show_string(0, 0, "L:");
+            oled_show_uint16(12, 0, g_debug.left_magnitude);
+            
+            oled_show_string(36, 0, "R:");
+            oled_show_uint16(48, 0, g_debug.right_magnitude);
+            
+            oled_show_string(72, 0, "E:");
+            oled_show_int16(84, 0, g_debug.inductor_error);
+            break;
+            
+        case 1:
+            /*-------------------------------------------------
+             * 行 1: 编码器数据 (左右轮速度)
+             * 格式: SL:xxx SR:xxx
+             *-------------------------------------------------*/
+            oled_show_string(0, 1, "SL:");
+            oled_show_int16(18, 1, g_debug.speed_left);
+            
+            oled_show_string(60, 1, "SR:");
+            oled_show_int16(78, 1, g_debug.speed_right);
+            break;
+            
+        case 2:
+            /*-------------------------------------------------
+             * 行 2: IMU 数据 (俯仰角 + 偏航速度)
+             * 格式: Pit:xx Yaw:xxx
+             *-------------------------------------------------*/
+            oled_show_string(0, 2, "Pit:");
+            oled_show_int16(24, 2, g_debug.pitch_angle);
+            
+            oled_show_string(60, 2, "Yaw:");
+            oled_show_int16(84, 2, g_debug.yaw_rate);
+            break;
+            
+        case 3:
+            /*-------------------------------------------------
+             * 行 3: 系统状态 (电池 + 当前元素)
+             * 格式: Bat:xx.x Elem:X
+             *-------------------------------------------------*/
+            oled_show_string(0, 3, "Bat:");
+            oled_show_float_x10(24, 3, g_debug.battery_volt_x10);
+            
+            oled_show_string(72, 3, "El:");
+            oled_show_char(90, 3, DebugDisplay_GetElementChar(g_debug.element_type));
+            break;
+            
+        case 4:
+            /*-------------------------------------------------
+             * 行 4: 电感向量和 + 在线状态
+             * 格式: Sum:xxx  Online:x
+             *-------------------------------------------------*/
+            oled_show_string(0, 4, "Sum:");
+            oled_show_uint16(24, 4, g_debug.inductor_sum);
+            
+            oled_show_string(60, 4, "On:");
+            oled_show_uint16(78, 4, g_debug.is_online);
+            break;
+            
+        case 5:
+            /*-------------------------------------------------
+             * 行 5: PWM 输出
+             * 格式: PL:xxxx PR:xxxx
+             *-------------------------------------------------*/
+            oled_show_string(0, 5, "PL:");
+            oled_show_int16(18, 5, g_debug.pwm_left);
+            
+            oled_show_string(64, 5, "PR:");
+            oled_show_int16(82, 5, g_debug.pwm_right);
+            break;
+            
+        case 6:
+            /*-------------------------------------------------
+             * 行 6: 控制周期耗时 (us)
+             * 格式: Ct:xxxx Mx:xxxx
+             *-------------------------------------------------*/
+            oled_show_string(0, 6, "Ct:");
+            oled_show_uint16(18, 6, g_debug.ctrl_mean_us);
+            
+            oled_show_string(60, 6, "Mx:");
+            oled_show_uint16(78, 6, g_debug.ctrl_max_us);
+            break;
+            
+        case 7:
+            /*-------------------------------------------------
+             * 行 7: 超时次数 + 最慢阶段
+             * 格式: Ov:xx Top:XXX
+             *-------------------------------------------------*/
+            oled_show_string(0, 7, "Ov:");
+            oled_show_uint16(18, 7, g_debug.ctrl_overrun);
+            
+            oled_show_string(60, 7, "Top:");
+            oled_show_string(84, 7, Profiler_GetStageName((ProfilerStage_t)g_debug.slowest_stage));
+            break;
+        default:
+            break;
+    }
+}
+
 /**
  * @brief   OLED 显示刷新
  * @details 8 行显示布局:
@@ -104,71 +248,122 @@ char DebugDisplay_GetElementChar(uint8 elem_type)
  *          行1: SL:xxx  SR:xxx
  *          行2: Pit:xx  Yaw:xxx
  *          行3: Bat:xx.x  Elem:X
+ *          行6: Ct:xxxx  Mx:xxxx   (控制周期平均/最大耗时 us)
+ *          行7: Ov:xx  Top:XXX      (超时次数/最慢阶段)
  */
 void DebugDisplay_OledRefresh(void)
 {
-    /*-------------------------------------------------
-     * 行 0: 电感数据 (左/右模值 + 偏差)
-     * 格式: L:xx R:xx E:xxx
-     *-------------------------------------------------*/
-    oled_show_string(0, 0, "L:");
-    oled_show_uint16(12, 0, g_debug.left_magnitude);
-    
-    oled_show_string(36, 0, "R:");
-    oled_show_uint16(48, 0, g_debug.right_magnitude);
-    
-    oled_show_string(72, 0, "E:");
-    oled_show_int16(84, 0, g_debug.inductor_error);
-    
-    /*-------------------------------------------------
-     * 行 1: 编码器数据 (左右轮速度)
-     * 格式: SL:xxx SR:xxx
-     *-------------------------------------------------*/
-    oled_show_string(0, 1, "SL:");
-    oled_show_int16(18, 1, g_debug.speed_left);
-    
-    oled_show_string(60, 1, "SR:");
-    oled_show_int16(78, 1, g_debug.speed_right);
-    
-    /*-------------------------------------------------
-     * 行 2: IMU 数据 (俯仰角 + 偏航速度)
-     * 格式: Pit:xx Yaw:xxx
-     *-------------------------------------------------*/
-    oled_show_string(0, 2, "Pit:");
-    oled_show_int16(24, 2, g_debug.pitch_angle);
+    uint8 row;
     
-    oled_show_string(60, 2, "Yaw:");
-    oled_show_int16(84, 2, g_debug.yaw_rate);
-    
-    /*-------------------------------------------------
-     * 行 3: 系统状态 (电池 + 当前元素)
-     * 格式: Bat:xx.x Elem:X
-     *-------------------------------------------------*/
-    oled_show_string(0, 3, "Bat:");
-    oled_show_float_x10(24, 3, g_debug.battery_volt_x10);
-    
-    oled_show_string(72, 3, "El:");
-    oled_show_char(90, 3, DebugDisplay_GetElementChar(g_debug.element_type));
-    
-    /*-------------------------------------------------
-     * 行 4: 电感向量和 + 在线状态
-     * 格式: Sum:xxx  Online:x
-     *-------------------------------------------------*/
-    oled_show_string(0, 4, "Sum:");
-    oled_show_uint16(24, 4, g_debug.inductor_sum);
+    for (row = 0; row < OLED_PAGES; row++)
+    {
+        debug_display_draw_row(row);
+    }
     
-    oled_show_string(60, 4, "On:");
-    oled_show_uint16(78, 4, g_debug.is_online);
+    /* 以上只写显存, 这里把有变化的区间一次发出 */
+    oled_refresh();
+}
+
+/*==================================================================================================================
+ *                                              分时刷新
+ *==================================================================================================================*/
+
+/**
+ * @brief   按预算发送显存改动, 并记录统计
+ */
+static void debug_display_flush(void)
+{
+    uint16 sent;
     
-    /*-------------------------------------------------
-     * 行 5: PWM 输出
-     * 格式: PL:xxxx PR:xxxx
-     *-------------------------------------------------*/
-    oled_show_string(0, 5, "PL:");
-    oled_show_int16(18, 5, g_debug.pwm_left);
+    sent = oled_refresh_budget(OLED_FLUSH_BUDGET_BYTES);
+    if (sent > s_stat_max_bytes)
+    {
+        s_stat_max_bytes = sent;
+    }
+}
+
+/**
+ * @brief   分时刷新任务
+ * @details 一帧分为: 采集数据 → 每次调用画一行并发送一部分 → 发完剩余改动
+ *          单次调用的 I2C 传输不超过 OLED_FLUSH_BUDGET_BYTES (另加最多一个区间开销)
+ */
+void DebugDisplay_Task(void)
+{
+    switch (s_state)
+    {
+        case DD_STATE_WAIT:
+            s_wait_cnt++;
+            if (s_wait_cnt >= DEBUG_OLED_REFRESH_LOOPS)
+            {
+                s_wait_cnt = 0;
+                DebugDisplay_Update();
+                s_row = 0;
+                s_frame_calls = 0;
+                s_state = DD_STATE_DRAW;
+            }
+            break;
+            
+        case DD_STATE_DRAW:
+            s_frame_calls++;
+            debug_display_draw_row(s_row);
+            s_row++;
+            debug_display_flush();
+            if (s_row >= OLED_PAGES)
+            {
+                s_state = DD_STATE_FLUSH;
+            }
+            break;
+            
+        case DD_STATE_FLUSH:
+        default:
+            if (oled_is_dirty())
+            {
+                s_frame_calls++;
+                debug_display_flush();
+            }
+            if (!oled_is_dirty())
+            {
+                s_stat_frame_calls = s_frame_calls;
+                s_stat_frames++;
+                s_state = DD_STATE_WAIT;
+            }
+            break;
+    }
+}
+
+/**
+ * @brief   通过蓝牙发送刷新统计
+ */
+void DebugDisplay_SendReport(void)
+{
+    char line[32];
+    char *p = line;
     
-    oled_show_string(64, 5, "PR:");
-    oled_show_int16(82, 5, g_debug.pwm_right);
+    *p++ = 'O';
+    *p++ = 'L';
+    *p++ = 'D';
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, OLED_FLUSH_BUDGET_BYTES);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, s_stat_max_bytes);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, s_stat_frame_calls);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, s_stat_frames);
+    *p++ = '\r';
+    *p++ = '\n';
+    *p   = '\0';
+    Bluetooth_SendString(line);
+}
+
+/**
+ * @brief   刷新统计清零
+ */
+void DebugDisplay_ResetStats(void)
+{
+    s_stat_max_bytes = 0;
+    s_stat_frame_calls = 0;
+    s_stat_frames = 0;
 }
 
 /*==================================================================================================================
@@ -177,15 +372,9 @@ void DebugDisplay_OledRefresh(void)
 
 /**
  * @brief   蓝牙发送调试数据
- * @details 格式: $D:E,L,R,SL,SR,Pit,Bat\n
+ * @details 发送一帧包含全部字段的二进制遥测 (格式见 telemetry.h)
  */
 void DebugDisplay_BluetoothSend(void)
 {
-    /* 使用已有的蓝牙函数发送核心数据 */
-    Bluetooth_SendDebugData(
-        g_debug.inductor_error,
-        g_debug.speed_left,
-        g_debug.speed_right,
-        g_debug.battery_volt_x10
-    );
+    Telemetry_SendSnapshot();
 }
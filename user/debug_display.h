@@ -24,6 +24,15 @@
  *              【系统状态】
  *              - Bat: 电池电压, 低于 11.0V 需要充电
  *              - Elem: 当前识别到的元素 (N=无, Z=折线, T=直角, H=环岛, X=十字)
+ * 
+ *              【控制周期耗时】 - 判断 5ms 控制任务是否超时
+ *              - Ct/Mx: System_Control 平均/最大耗时 (us), 应远小于 5000
+ *              - Ov: 超时次数, 正常应为 0
+ *              - Top: 平均耗时最长的阶段 (ENC/IND/IMU/ELM/PID/MOT/FAN)
+ * 
+ *              【刷新方式】
+ *              DebugDisplay_Task() 每次主循环只画一行、只发送 OLED_FLUSH_BUDGET_BYTES 字节,
+ *              一帧分多次主循环完成, 不会长时间阻塞蓝牙命令处理和电池检测
  ********************************************************************************************************************/
 
 #ifndef __DEBUG_DISPLAY_H__
@@ -67,6 +76,12 @@ typedef struct
     int16  pwm_left;            /* 左电机 PWM */
     int16  pwm_right;           /* 右电机 PWM */
     
+    /* 控制周期耗时 */
+    uint16 ctrl_mean_us;        /* System_Control 平均耗时 (us) */
+    uint16 ctrl_max_us;         /* System_Control 最大耗时 (us) */
+    uint16 ctrl_overrun;        /* 超时次数 */
+    uint8  slowest_stage;       /* 平均耗时最长的阶段 (ProfilerStage_t) */
+    
 } DebugData_t;
 
 /* 全局调试数据 */
@@ -90,12 +105,33 @@ void DebugDisplay_Init(void);
 void DebugDisplay_Update(void);
 
 /**
- * @brief   OLED 显示刷新
+ * @brief   OLED 显示刷新 (一次画完整页并全部发送)
  * @return  void
- * @note    应在主循环中调用，刷新频率约 10Hz 即可
+ * @note    会阻塞到整页发完, 主循环中应使用 DebugDisplay_Task()
  */
 void DebugDisplay_OledRefresh(void);
 
+/**
+ * @brief   OLED 分时刷新任务
+ * @return  void
+ * @note    每次主循环调用一次, 每 DEBUG_OLED_REFRESH_LOOPS 次开始新的一帧,
+ *          每次调用最多发送 OLED_FLUSH_BUDGET_BYTES 字节, 限制主循环最坏耗时
+ */
+void DebugDisplay_Task(void);
+
+/**
+ * @brief   通过蓝牙发送刷新统计 (随 $PRF 报告发送)
+ * @details 格式: "OLD <预算> <单次最大字节数> <上一帧调用次数> <帧数>"
+ * @return  void
+ */
+void DebugDisplay_SendReport(void);
+
+/**
+ * @brief   刷新统计清零
+ * @return  void
+ */
+void DebugDisplay_ResetStats(void);
+
 /**
  * @brief   蓝牙发送调试数据
  * @return  void
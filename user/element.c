@@ -11,6 +11,7 @@
 
 #include "element.h"
 #include "inductor.h"
+#include "pose.h"
 
 /*==================================================================================================================
  *                                              全局变量
@@ -19,13 +20,39 @@
 /* 元素识别模块全局数据实例 */
 ElementData_t g_element;
 
+/* 元素识别可调参数 (Element_Init 不复位, 蓝牙修改后一直有效) */
+ElementParam_t g_element_param = {
+    ZIGZAG_ERROR_JUMP_THRESHOLD,
+    TURN90_LOW_THRESHOLD,
+    TURN90_HIGH_THRESHOLD,
+    TURN90_STEP_OUTPUT,
+    TURN90_YAW_COMPLETE_ANGLE,
+    HEXAGON_ENTRY_SUM_THRESHOLD,
+    HEXAGON_YAW_COMPLETE_ANGLE,
+    HEXAGON_DIRECTION_OFFSET,
+    CROSS_BOTH_HIGH_THRESHOLD
+};
+
+/* 各元素方向环增益倍率 (与 ElementType_t 顺序一致) */
+static const ElementGain_t code s_element_gain[] = {
+    { 100, 100 },                               /* ELEM_NONE */
+    { 100, 100 },                               /* ELEM_STRAIGHT */
+    { 100, 100 * ZIGZAG_KD_BOOST_FACTOR },      /* ELEM_ZIGZAG_45: 加大阻尼, 抑制来回摆动 */
+    { 100, 100 },                               /* ELEM_TURN_90: 以阶跃差速为主 */
+    { 100, 100 },                               /* ELEM_HEXAGON */
+    { 100, 100 }                                /* ELEM_CROSS */
+};
+
+/* 进入元素时的位姿标记 (元素内里程/转角的起点) */
+static PoseMark_t s_entry_mark;
+
 /*==================================================================================================================
  *                                              私有函数声明
  *==================================================================================================================*/
 
 static void Element_DetectZigzag(int16 error, uint8 left_mag, uint8 right_mag);
-static void Element_DetectTurn90(int16 error, uint8 left_mag, uint8 right_mag, int16 gyro_z);
-static void Element_DetectHexagon(int16 error, uint8 left_mag, uint8 right_mag, uint8 sum, int16 gyro_z, int16 encoder_delta);
+static void Element_DetectTurn90(int16 error, uint8 left_mag, uint8 right_mag);
+static void Element_DetectHexagon(int16 error, uint8 left_mag, uint8 right_mag, uint8 sum);
 static void Element_DetectCross(uint8 left_mag, uint8 right_mag, uint8 sum);
 static void Element_HandleOffline(uint8 is_online, int16 pitch_angle, int16 error);
 static int16 Element_CalcErrorJump(void);
@@ -51,8 +78,8 @@ void Element_Init(void)
     g_element.yaw_integral = 0;
     
     /* 清零里程计 */
-    g_element.distance_cnt = 0;
-    g_element.distance_target = 0;
+    g_element.distance_mm = 0;
+    g_element.running_cnt = 0;
     
     /* 清零丢线保护数据 */
     g_element.offline_cnt = 0;
@@ -68,7 +95,7 @@ void Element_Init(void)
     
     /* 默认输出 */
     g_element.direction_offset = 0;
-    g_element.speed_scale = 100;
+    g_element.speed_scale = ELEMENT_SPEED_Q8(100);
 }
 
 /*==================================================================================================================
@@ -84,9 +111,7 @@ void Element_Update(int16 inductor_error,
                     uint8 right_magnitude,
                     uint8 inductor_sum,
                     uint8 is_online,
-                    int16 gyro_z,
-                    int16 pitch_angle,
-                    int16 encoder_delta)
+                    int16 pitch_angle)
 {
     /*-------------------------------------------------
      * Step 1: 更新历史偏差 (环形缓冲区)
@@ -113,8 +138,7 @@ void Element_Update(int16 inductor_error,
         /*--- 空闲状态：扫描所有元素入口 ---*/
         case ELEM_STATE_IDLE:
             /* 优先级: 环岛 > 十字 > 直角弯 > 折线 */
-            Element_DetectHexagon(inductor_error, left_magnitude, right_magnitude, 
-                                  inductor_sum, gyro_z, encoder_delta);
+            Element_DetectHexagon(inductor_error, left_magnitude, right_magnitude, inductor_sum);
             
             if (g_element.current_element == ELEM_NONE)
             {
@@ -123,7 +147,7 @@ void Element_Update(int16 inductor_error,
             
             if (g_element.current_element == ELEM_NONE)
             {
-                Element_DetectTurn90(inductor_error, left_magnitude, right_magnitude, gyro_z);
+                Element_DetectTurn90(inductor_error, left_magnitude, right_magnitude);
             }
             
             if (g_element.current_element == ELEM_NONE)
@@ -136,44 +160,40 @@ void Element_Update(int16 inductor_error,
         case ELEM_STATE_ENTER:
             /* 直接切换到执行状态 */
             g_element.state = ELEM_STATE_RUNNING;
-            g_element.distance_cnt = 0;
+            Pose_SetMark(&s_entry_mark);
+            g_element.distance_mm = 0;
             g_element.yaw_integral = 0;
+            g_element.running_cnt = 0;
             break;
             
         /*--- 执行状态：根据元素类型执行不同动作 ---*/
         case ELEM_STATE_RUNNING:
-            /* 累计里程和角度 */
-            g_element.distance_cnt += encoder_delta;
-            g_element.yaw_integral += gyro_z / 16;  /* 简化角度积分 */
+            /* 进入元素后走过的里程和转过的角度 (位姿模块, 已标定单位) */
+            g_element.distance_mm  = Pose_DistanceSince(&s_entry_mark);
+            g_element.yaw_integral = Pose_HeadingSince(&s_entry_mark);
             
             /* 根据当前元素类型执行动作 */
             switch (g_element.current_element)
             {
                 case ELEM_ZIGZAG_45:
-                    /* 折线处理: 增大D项阻尼 (通过 direction_offset 间接实现) */
+                    /* 折线处理: 增大D项阻尼 (增益表 ZIGZAG_KD_BOOST_FACTOR, 由 System_Control 应用) */
                     /* 持续监测是否恢复直道特征 */
-                    if (ABS_VALUE(Element_CalcErrorJump()) < ZIGZAG_ERROR_JUMP_THRESHOLD / 2)
+                    if (ABS_VALUE(Element_CalcErrorJump()) < g_element_param.zigzag_jump / 2)
                     {
                         g_element.state = ELEM_STATE_EXIT;
                     }
                     break;
                     
                 case ELEM_TURN_90:
-                    /* 直角弯处理: 给出阶跃转向输出 */
-                    if (left_magnitude > right_magnitude)
-                    {
-                        /* 左转 */
-                        g_element.direction_offset = -TURN90_STEP_OUTPUT;
-                    }
-                    else
-                    {
-                        /* 右转 */
-                        g_element.direction_offset = TURN90_STEP_OUTPUT;
-                    }
+                    /* 直角弯处理: 保持入口时锁定的阶跃转向输出
+                     * (不能每周期按左右信号重新判断, 车头转过去以后两侧强弱会反过来) */
                     
-                    /* 检测转向完成: 偏差回归正常范围 */
-                    if (ABS_VALUE(inductor_error) < 30 && 
-                        left_magnitude > 30 && right_magnitude > 30)
+                    /* 检测转向完成: 偏差回归正常范围, 或车头已转过接近 90°, 或超时 (误判保护) */
+                    g_element.running_cnt++;
+                    if ((ABS_VALUE(inductor_error) < 30 && 
+                         left_magnitude > 30 && right_magnitude > 30) ||
+                        ABS_VALUE(g_element.yaw_integral) > (int32)g_element_param.turn90_yaw * 100 ||
+                        g_element.running_cnt > TURN90_TIMEOUT_TIME)
                     {
                         g_element.state = ELEM_STATE_EXIT;
                     }
@@ -184,16 +204,16 @@ void Element_Update(int16 inductor_error,
                     if (g_element.roundabout_dir == ROUNDABOUT_LEFT)
                     {
                         /* 左环岛: 持续给左偏置 */
-                        g_element.direction_offset = -800;
+                        g_element.direction_offset = -g_element_param.hexagon_offset;
                     }
                     else
                     {
                         /* 右环岛: 持续给右偏置 */
-                        g_element.direction_offset = 800;
+                        g_element.direction_offset = g_element_param.hexagon_offset;
                     }
                     
                     /* 检测出口: 角度积分超过300度 + 检测到直道特征 */
-                    if (ABS_VALUE(g_element.yaw_integral) > HEXAGON_YAW_COMPLETE_ANGLE * 16)
+                    if (ABS_VALUE(g_element.yaw_integral) > (int32)g_element_param.hexagon_yaw * 100)
                     {
                         /* 检查是否回到直道 */
                         if (ABS_VALUE(inductor_error) < 30 && inductor_sum > 40)
@@ -206,10 +226,9 @@ void Element_Update(int16 inductor_error,
                 case ELEM_CROSS:
                     /* 十字路口: 直行通过，无需特殊处理 */
                     g_element.direction_offset = 0;
-                    g_element.distance_cnt += encoder_delta;
                     
                     /* 通过里程判定退出 */
-                    if (g_element.distance_cnt > 100)
+                    if (g_element.distance_mm > CROSS_EXIT_DISTANCE)
                     {
                         g_element.state = ELEM_STATE_EXIT;
                     }
@@ -231,8 +250,8 @@ void Element_Update(int16 inductor_error,
             g_element.current_element = ELEM_NONE;
             g_element.roundabout_dir = ROUNDABOUT_NONE;
             g_element.direction_offset = 0;
-            g_element.speed_scale = 100;
-            g_element.distance_cnt = 0;
+            g_element.speed_scale = ELEMENT_SPEED_Q8(100);
+            g_element.distance_mm = 0;
             g_element.yaw_integral = 0;
             g_element.state = ELEM_STATE_IDLE;
             break;
@@ -263,13 +282,13 @@ static void Element_DetectZigzag(int16 error, uint8 left_mag, uint8 right_mag)
      * 1. 偏差跳变超过阈值
      * 2. 电感信号正常 (不是丢线造成的跳变)
      */
-    if (ABS_VALUE(jump) > ZIGZAG_ERROR_JUMP_THRESHOLD &&
+    if (ABS_VALUE(jump) > g_element_param.zigzag_jump &&
         (left_mag + right_mag) > 40)
     {
         /* 进入 45° 折线模式 */
         g_element.current_element = ELEM_ZIGZAG_45;
         g_element.state = ELEM_STATE_ENTER;
-        g_element.speed_scale = 85;  /* 适当减速 */
+        g_element.speed_scale = ELEMENT_SPEED_Q8(85);  /* 适当减速 */
     }
 }
 
@@ -281,29 +300,30 @@ static void Element_DetectZigzag(int16 error, uint8 left_mag, uint8 right_mag)
  * @brief   检测 90° 直角弯
  * @details 算法: 单侧信号接近0，另一侧满载
  */
-static void Element_DetectTurn90(int16 error, uint8 left_mag, uint8 right_mag, int16 gyro_z)
+static void Element_DetectTurn90(int16 error, uint8 left_mag, uint8 right_mag)
 {
     uint8 is_left_low, is_right_low;
     uint8 is_left_high, is_right_high;
     
     /* 判断各侧信号状态 */
-    is_left_low   = (left_mag < TURN90_LOW_THRESHOLD) ? 1 : 0;
-    is_right_low  = (right_mag < TURN90_LOW_THRESHOLD) ? 1 : 0;
-    is_left_high  = (left_mag > TURN90_HIGH_THRESHOLD) ? 1 : 0;
-    is_right_high = (right_mag > TURN90_HIGH_THRESHOLD) ? 1 : 0;
+    is_left_low   = (left_mag < g_element_param.turn90_low) ? 1 : 0;
+    is_right_low  = (right_mag < g_element_param.turn90_low) ? 1 : 0;
+    is_left_high  = (left_mag > g_element_param.turn90_high) ? 1 : 0;
+    is_right_high = (right_mag > g_element_param.turn90_high) ? 1 : 0;
     
     /*
      * 判定条件:
      * 1. 一侧信号接近0，另一侧满载
-     * 2. 陀螺仪角速度未超过阈值 (说明还未开始转向)
+     * 2. 偏航角速度未超过阈值 (说明还未开始转向)
      */
     if (((is_left_low && is_right_high) || (is_right_low && is_left_high)) &&
-        ABS_VALUE(gyro_z / 16) < TURN90_GYRO_THRESHOLD)
+        ABS_VALUE(g_pose.yaw_rate) < TURN90_GYRO_THRESHOLD)
     {
-        /* 进入 90° 直角弯模式 */
+        /* 进入 90° 直角弯模式, 按入口处信号强的一侧锁定转向 */
         g_element.current_element = ELEM_TURN_90;
         g_element.state = ELEM_STATE_ENTER;
-        g_element.speed_scale = 70;  /* 减速过弯 */
+        g_element.speed_scale = ELEMENT_SPEED_Q8(70);  /* 减速过弯 */
+        g_element.direction_offset = is_left_high ? -g_element_param.turn90_step : g_element_param.turn90_step;
     }
 }
 
@@ -315,8 +335,7 @@ static void Element_DetectTurn90(int16 error, uint8 left_mag, uint8 right_mag, i
  * @brief   检测六边形环岛
  * @details 算法: 入口处双侧信号都强 (类似十字) + 持续单侧引导
  */
-static void Element_DetectHexagon(int16 error, uint8 left_mag, uint8 right_mag, 
-                                  uint8 sum, int16 gyro_z, int16 encoder_delta)
+static void Element_DetectHexagon(int16 error, uint8 left_mag, uint8 right_mag, uint8 sum)
 {
     static uint8 entry_cnt = 0;         /* 入口特征持续计数 */
     static int16 side_accumulate = 0;   /* 单侧引导累计 */
@@ -325,8 +344,9 @@ static void Element_DetectHexagon(int16 error, uint8 left_mag, uint8 right_mag,
      * 六边形环岛入口特征:
      * 1. 双侧信号和很大 (接近十字特征)
      * 2. 持续有单侧引导倾向
+     * 信号和取完整阈值: 用阈值的一半时, 普通弯道出口 (单侧略强, 信号和约 90) 也会被当成环岛
      */
-    if (sum > HEXAGON_ENTRY_SUM_THRESHOLD / 2)
+    if (sum > g_element_param.hexagon_sum)
     {
         entry_cnt++;
         
@@ -342,7 +362,7 @@ static void Element_DetectHexagon(int16 error, uint8 left_mag, uint8 right_mag,
                 g_element.current_element = ELEM_HEXAGON;
                 g_element.roundabout_dir = ROUNDABOUT_RIGHT;
                 g_element.state = ELEM_STATE_ENTER;
-                g_element.speed_scale = 75;
+                g_element.speed_scale = ELEMENT_SPEED_Q8(75);
             }
             else if (side_accumulate < -100)
             {
@@ -350,7 +370,7 @@ static void Element_DetectHexagon(int16 error, uint8 left_mag, uint8 right_mag,
                 g_element.current_element = ELEM_HEXAGON;
                 g_element.roundabout_dir = ROUNDABOUT_LEFT;
                 g_element.state = ELEM_STATE_ENTER;
-                g_element.speed_scale = 75;
+                g_element.speed_scale = ELEMENT_SPEED_Q8(75);
             }
             
             /* 重置计数器 */
@@ -383,8 +403,8 @@ static void Element_DetectCross(uint8 left_mag, uint8 right_mag, uint8 sum)
      * 1. 双侧信号都很强
      * 2. 持续一定时间
      */
-    if (left_mag > CROSS_BOTH_HIGH_THRESHOLD && 
-        right_mag > CROSS_BOTH_HIGH_THRESHOLD)
+    if (left_mag > g_element_param.cross_high && 
+        right_mag > g_element_param.cross_high)
     {
         cross_cnt++;
         
@@ -392,7 +412,7 @@ static void Element_DetectCross(uint8 left_mag, uint8 right_mag, uint8 sum)
         {
             g_element.current_element = ELEM_CROSS;
             g_element.state = ELEM_STATE_ENTER;
-            g_element.speed_scale = 90;
+            g_element.speed_scale = ELEMENT_SPEED_Q8(90);
             cross_cnt = 0;
         }
     }
@@ -485,11 +505,23 @@ int16 Element_GetDirectionOffset(void)
 /**
  * @brief   获取速度缩放系数
  */
-uint8 Element_GetSpeedScale(void)
+uint16 Element_GetSpeedScale(void)
 {
     return g_element.speed_scale;
 }
 
+/**
+ * @brief   获取当前元素的方向环增益倍率
+ */
+const ElementGain_t code *Element_GetGain(void)
+{
+    if ((uint8)g_element.current_element >= sizeof(s_element_gain) / sizeof(s_element_gain[0]))
+    {
+        return &s_element_gain[ELEM_NONE];
+    }
+    return &s_element_gain[g_element.current_element];
+}
+
 /**
  * @brief   检查紧急状态
  */
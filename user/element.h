@@ -90,11 +90,11 @@ typedef struct
     
     /* 环岛专用数据 */
     RoundaboutDir_t roundabout_dir;     /* 环岛方向 */
-    int32           yaw_integral;       /* 偏航角积分 (用于判断转过多少度) */
+    int32           yaw_integral;       /* 进入元素后转过的角度 (0.01°, 位姿模块融合航向) */
     
     /* 里程计数据 (用于元素内定长控制) */
-    int32           distance_cnt;       /* 距离累计 (编码器脉冲数) */
-    int32           distance_target;    /* 目标距离 */
+    int32           distance_mm;        /* 进入元素后走过的里程 (mm) */
+    uint16          running_cnt;        /* 元素执行计时 (单位: 5ms周期, 用于超时退出) */
     
     /* 丢线保护数据 */
     uint8           offline_cnt;        /* 丢线计时器 (单位: 5ms周期) */
@@ -104,53 +104,94 @@ typedef struct
     /* 历史偏差 (用于跳变检测) */
     ErrorHistory_t  error_history;
     
-    /* 方向环偏置输出 (元素执行时叠加到PID输出) */
+    /* 方向环偏置输出 (元素执行时叠加到PID输出, 单位: 基础速度的 1/1024) */
     int16           direction_offset;
     
-    /* 元素内速度调整系数 (百分比, 100=不调整) */
-    uint8           speed_scale;
+    /* 元素内速度调整系数 (Q8, 256 = 不调整, 用 ELEMENT_SPEED_Q8 按百分比给出) */
+    uint16          speed_scale;
     
 } ElementData_t;
 
+/**
+ * @brief   元素方向环增益 (百分比, 相对于蓝牙/默认设置的基础增益)
+ */
+typedef struct
+{
+    uint16          kp_percent;         /* Kp 倍率 (100 = 不变) */
+    uint16          kd_percent;         /* Kd 倍率 (100 = 不变) */
+} ElementGain_t;
+
+/**
+ * @brief   元素识别可调参数 (默认值为下方宏定义, 可由蓝牙 $SET 在线修改, 见 param_registry.h)
+ */
+typedef struct
+{
+    int16           zigzag_jump;        /* ZIGZAG_ERROR_JUMP_THRESHOLD */
+    int16           turn90_low;         /* TURN90_LOW_THRESHOLD */
+    int16           turn90_high;        /* TURN90_HIGH_THRESHOLD */
+    int16           turn90_step;        /* TURN90_STEP_OUTPUT */
+    int16           turn90_yaw;         /* TURN90_YAW_COMPLETE_ANGLE */
+    int16           hexagon_sum;        /* HEXAGON_ENTRY_SUM_THRESHOLD */
+    int16           hexagon_yaw;        /* HEXAGON_YAW_COMPLETE_ANGLE */
+    int16           hexagon_offset;     /* HEXAGON_DIRECTION_OFFSET */
+    int16           cross_high;         /* CROSS_BOTH_HIGH_THRESHOLD */
+} ElementParam_t;
+
 /* 全局元素数据实例 */
 extern ElementData_t g_element;
 
+/* 元素识别可调参数 */
+extern ElementParam_t g_element_param;
+
 /*==================================================================================================================
  *                                              检测阈值参数定义
  *==================================================================================================================*/
 
+/* 元素内速度倍率: 百分比 → Q8 (编译期换算, 控制中断中只做乘法和移位) */
+#define ELEMENT_SPEED_Q8(percent)       ((uint16)(((percent) * 256 + 50) / 100))
+
 /* 
  * 45° 折线检测参数 
  * 原理: 短时间内偏差发生大幅度反向跳变
  */
 #define ZIGZAG_ERROR_JUMP_THRESHOLD     40      /* 偏差跳变阈值 (归一化偏差 -100~+100) */
 #define ZIGZAG_JUMP_TIME_WINDOW         3       /* 跳变检测时间窗口 (3 × 5ms = 15ms) */
-#define ZIGZAG_KD_BOOST_FACTOR          2       /* 折线时微分增益倍数 */
+#define ZIGZAG_KD_BOOST_FACTOR          2       /* 折线时微分增益倍数 (见增益表 s_element_gain) */
 
 /*
  * 90° 直角弯检测参数
  * 原理: 单侧电感信号接近 0，另一侧满载
+ * 阶跃差速: 原值 2000 是 PWM 计数 (满占空比 10000 的 20%), 方向偏置改为基础速度的 1/1024 后
+ *           按同一比例换算为 205, 未重新整定
  */
 #define TURN90_LOW_THRESHOLD            15      /* 低信号阈值 (向量模 0~100) */
 #define TURN90_HIGH_THRESHOLD           70      /* 高信号阈值 */
-#define TURN90_GYRO_THRESHOLD           50      /* 陀螺仪角速度阈值 (判断是否已开始转向) */
-#define TURN90_STEP_OUTPUT              2000    /* 直角弯阶跃输出量 */
+#define TURN90_GYRO_THRESHOLD           50      /* 偏航角速度阈值 (°/s, 判断是否已开始转向) */
+#define TURN90_STEP_OUTPUT              205     /* 直角弯阶跃差速 (基础速度的 1/1024, 见上方说明) */
+#define TURN90_YAW_COMPLETE_ANGLE       45      /* 直角弯内转过角度判定 (度), 超过即交还方向环 */
+#define TURN90_TIMEOUT_TIME             60      /* 直角弯最长执行时间 (60 × 5ms = 300ms), 误判时退出 */
 
 /*
  * 六边形环岛检测参数
  * 原理: 入口为十字特征 + 持续单侧引导
+ * 持续差速: 原值 800 PWM 计数 (满占空比的 8%), 与直角弯阶跃同样换算为 1/1024, 未重新整定
+ * 入口信号和: 原代码与阈值的一半比较, 现与完整阈值比较. 依据只有仿真 (普通弯道出口被当成环岛),
+ *             尚未在车上确认; 车上环岛入口识别不到时先用 $SET:hex_sum 降低阈值
  */
 #define HEXAGON_ENTRY_SUM_THRESHOLD     150     /* 入口处信号和阈值 (双侧都强) */
 #define HEXAGON_SIDE_RATIO_THRESHOLD    60      /* 单侧引导比例阈值 (%) */
 #define HEXAGON_YAW_COMPLETE_ANGLE      300     /* 环岛内转过角度判定 (度) */
-#define HEXAGON_EDGE_DISTANCE           200     /* 六边形单边预估里程 (编码器脉冲) */
+#define HEXAGON_DIRECTION_OFFSET        82      /* 环岛内持续差速 (基础速度的 1/1024) */
 
 /*
  * 十字路口检测参数
  * 原理: 两侧电感信号同时满载
+ * 退出里程: 双侧都高于阈值的区段沿赛道约 40mm (仿真磁场, 车速 70 实测), 走过 100mm 后
+ *           传感器已离开横线, 同一个十字不会被重复识别; 仍远小于仿真赛道上的元素间距 (≥ 300mm)
  */
 #define CROSS_BOTH_HIGH_THRESHOLD       80      /* 双侧高信号阈值 */
 #define CROSS_HOLD_TIME                 4       /* 持续时间 (4 × 5ms = 20ms) */
+#define CROSS_EXIT_DISTANCE             100     /* 进入后走过此里程退出 (mm) */
 
 /*
  * 丢线保护参数
@@ -176,20 +217,17 @@ void Element_Init(void);
  * @param   right_magnitude     右侧电感向量模 (0~100)
  * @param   inductor_sum        电感向量和
  * @param   is_online           是否在线 (1=在线, 0=丢线)
- * @param   gyro_z              陀螺仪Z轴角速度 (原始值)
- * @param   pitch_angle         俯仰角 (度)
- * @param   encoder_delta       本周期编码器增量 (左+右)/2
+ * @param   pitch_angle         俯仰角 (度, 姿态模块输出)
  * @return  void
- * @note    此函数在 System_Control() 中调用
+ * @note    此函数在 System_Control() 中 Pose_Update 之后调用,
+ *          元素内里程/转角和偏航角速度直接读取位姿模块 (g_pose)
  */
 void Element_Update(int16 inductor_error, 
                     uint8 left_magnitude, 
                     uint8 right_magnitude,
                     uint8 inductor_sum,
                     uint8 is_online,
-                    int16 gyro_z,
-                    int16 pitch_angle,
-                    int16 encoder_delta);
+                    int16 pitch_angle);
 
 /**
  * @brief   获取当前元素类型
@@ -199,15 +237,24 @@ ElementType_t Element_GetType(void);
 
 /**
  * @brief   获取方向环偏置量
- * @return  int16   方向偏置量 (叠加到PID输出)
+ * @return  int16   方向偏置量 (基础速度的 1/1024, 负 = 左转)
+ * @note    叠加到方向环输出前乘以当前基础速度再右移 10 位
  */
 int16 Element_GetDirectionOffset(void);
 
 /**
  * @brief   获取速度缩放系数
- * @return  uint8   速度百分比 (100 = 正常速度)
+ * @return  uint16  速度倍率 (Q8, 256 = 正常速度)
+ * @note    乘以目标速度再右移 8 位, 控制中断中不用除法
+ */
+uint16 Element_GetSpeedScale(void);
+
+/**
+ * @brief   获取当前元素的方向环增益倍率
+ * @return  const ElementGain_t*    增益倍率 (指向 ROM 表)
+ * @note    元素切换时由 System_Control 应用到方向环 PID
  */
-uint8 Element_GetSpeedScale(void);
+const ElementGain_t code *Element_GetGain(void);
 
 /**
  * @brief   检查是否处于紧急状态
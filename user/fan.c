@@ -8,6 +8,21 @@
  ********************************************************************************************************************/
 
 #include "fan.h"
+#include "battery.h"                  // 电压补偿倍率
+
+/*==================================================================================================================
+ *                                              全局变量
+ *==================================================================================================================*/
+
+FanParam_t g_fan_param = {
+    FAN_DUTY_DEFAULT,
+    FAN_DUTY_WALL,
+    FAN_ANGLE_THRESHOLD,
+    FAN_ANGLE_MAX,
+    FAN_LEAD_MS,
+    FAN_SPEED_GAIN,
+    FAN_HOLD_MS
+};
 
 /*==================================================================================================================
  *                                              私有变量
@@ -16,6 +31,62 @@
 static uint16 s_fan_duty = 0;               // 当前占空比
 static FanMode_t s_fan_mode = FAN_MODE_OFF; // 当前模式
 
+// 模型控制状态 (Fan_Control)
+static int32 s_lead_q10 = 0;                // 陀螺仪原始值 → 超前角度 (0.01°) 的系数 (Q10)
+static uint16 s_hold_cycles = 0;            // 保持时间 (控制周期)
+static int16 s_target = 0;                  // 目标占空比 (已限制下降斜率)
+static int32 s_model = 0;                   // 风扇转速模型 (Q8 占空比)
+static uint16 s_hold_cnt = 0;               // 保持剩余周期
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   俯仰角 → 占空比 (地面占空比到上墙占空比线性插值)
+ * @param   abs_pitch   俯仰角绝对值 (度)
+ */
+static uint16 fan_angle_duty(int16 abs_pitch)
+{
+    int32 temp;
+    
+    if (abs_pitch < g_fan_param.angle_low)
+    {
+        // 地面模式
+        return (uint16)g_fan_param.duty_ground;
+    }
+    if (abs_pitch >= g_fan_param.angle_high)
+    {
+        // 完全上墙, 最大吸力 (angle_high <= angle_low 时退化为阶跃, 不做插值)
+        return (uint16)g_fan_param.duty_wall;
+    }
+    
+    // 线性插值
+    // duty = DEFAULT + (WALL - DEFAULT) * (abs_pitch - THRESHOLD) / (MAX - THRESHOLD)
+    temp = (int32)(g_fan_param.duty_wall - g_fan_param.duty_ground) *
+           (int32)(abs_pitch - g_fan_param.angle_low) /
+           (int32)(g_fan_param.angle_high - g_fan_param.angle_low);
+    return (uint16)(g_fan_param.duty_ground + temp);
+}
+
+/**
+ * @brief   重算超前系数和保持周期数 (主循环)
+ */
+static void fan_update_param(void)
+{
+    int32 lead_q10;
+    uint16 hold_cycles;
+    
+    // 超前角度 (0.01°) = 原始值 × 10 / LSB_X10 (°/s) × lead_ms / 1000 × 100 = 原始值 × lead_ms / LSB_X10
+    lead_q10 = ((int32)g_fan_param.lead_ms << 10) / ATTITUDE_GYRO_LSB_X10;
+    hold_cycles = (uint16)(g_fan_param.hold_ms / CONTROL_PERIOD_MS);
+    
+    interrupt_global_disable();
+    s_lead_q10 = lead_q10;
+    s_hold_cycles = hold_cycles;
+    interrupt_global_enable();
+}
+
 /*==================================================================================================================
  *                                              风扇初始化
  *==================================================================================================================*/
@@ -31,6 +102,7 @@ void Fan_Init(void)
     // 默认关闭
     s_fan_duty = 0;
     s_fan_mode = FAN_MODE_OFF;
+    fan_update_param();
 }
 
 /*==================================================================================================================
@@ -42,6 +114,8 @@ void Fan_Init(void)
  */
 void Fan_SetDuty(uint16 duty)
 {
+    uint32 out;
+    
     // 限幅
     if (duty > FAN_DUTY_MAX)
     {
@@ -49,7 +123,14 @@ void Fan_SetDuty(uint16 duty)
     }
     
     s_fan_duty = duty;
-    pwm_set_duty(FAN_PWM_CH, duty);
+    
+    // 电压补偿: 吸力随电机电压变化, 按 标称电压 / 实际电压 放大后再限幅
+    out = ((uint32)duty * Battery_GetCompScale() + 2048) >> 12;
+    if (out > FAN_DUTY_MAX)
+    {
+        out = FAN_DUTY_MAX;
+    }
+    pwm_set_duty(FAN_PWM_CH, out);
 }
 
 /*==================================================================================================================
@@ -70,15 +151,18 @@ void Fan_SetMode(FanMode_t mode)
             break;
             
         case FAN_MODE_GROUND:
-            Fan_SetDuty(FAN_DUTY_DEFAULT);
+            Fan_SetDuty((uint16)g_fan_param.duty_ground);
             break;
             
         case FAN_MODE_WALL:
-            Fan_SetDuty(FAN_DUTY_WALL);
+            Fan_SetDuty((uint16)g_fan_param.duty_wall);
             break;
             
         case FAN_MODE_AUTO:
-            // 自动模式由 Fan_AutoAdjust 控制
+            // 自动模式由 Fan_Control / Fan_AutoAdjust 控制, 模型从当前输出开始
+            s_target = (int16)s_fan_duty;
+            s_model = (int32)s_fan_duty << 8;
+            s_hold_cnt = 0;
             break;
             
         default:
@@ -86,6 +170,18 @@ void Fan_SetMode(FanMode_t mode)
     }
 }
 
+/**
+ * @brief   按当前电压补偿重新输出 (固定占空比模式)
+ */
+void Fan_Refresh(void)
+{
+    // 自动模式每个控制周期都会重新设置, 这里只处理地面/上墙模式
+    if (s_fan_mode == FAN_MODE_GROUND || s_fan_mode == FAN_MODE_WALL)
+    {
+        Fan_SetDuty(s_fan_duty);
+    }
+}
+
 /*==================================================================================================================
  *                                              获取占空比
  *==================================================================================================================*/
@@ -115,8 +211,6 @@ uint16 Fan_GetDuty(void)
 void Fan_AutoAdjust(int16 pitch_angle)
 {
     int16 abs_pitch;
-    uint16 duty;
-    int32 temp;
     
     // 仅在自动模式下生效
     if (s_fan_mode != FAN_MODE_AUTO)
@@ -127,29 +221,109 @@ void Fan_AutoAdjust(int16 pitch_angle)
     // 取绝对值
     abs_pitch = (pitch_angle >= 0) ? pitch_angle : -pitch_angle;
     
-    // 判断是否需要增大吸力
-    if (abs_pitch < FAN_ANGLE_THRESHOLD)
+    // 设置占空比
+    Fan_SetDuty(fan_angle_duty(abs_pitch));
+}
+
+/**
+ * @brief   模型风扇控制
+ * @note    算法:
+ *          1. 预测角度 = 俯仰角 + 俯仰角速度 × 超前时间, 取 |俯仰角| 与 |预测角度| 中较大者
+ *             (只用于提前增大吸力, 离墙时的减小由保持和斜坡处理)
+ *          2. 目标 = max(角度映射占空比, 地面占空比 + 车速 × 预转增益)
+ *          3. 在墙上 (|俯仰角| ≥ 上墙角, 或 |俯仰角| ≥ 起始角且正在执行元素) 时刷新保持计时,
+ *             保持期间目标不低于上墙占空比
+ *          4. 目标下降受 FAN_RAMP_DOWN 限制, 上升不限
+ *          5. 输出 = 目标 + 超调系数 × (目标 − 模型转速), 模型转速按输出一阶滞后更新
+ */
+void Fan_Control(int16 pitch, int16 pitch_gyro, int16 speed, uint8 element_active)
+{
+    int32 predict;
+    int16 abs_pitch;
+    int16 abs_predict;
+    int32 target;
+    int32 speed_duty;
+    int32 output;
+    
+    // 仅在自动模式下生效
+    if (s_fan_mode != FAN_MODE_AUTO)
     {
-        // 地面模式
-        duty = FAN_DUTY_DEFAULT;
+        return;
     }
-    else if (abs_pitch >= FAN_ANGLE_MAX)
+    
+    /*-------------------------------------------------
+     * Step 1: 俯仰角预测 (度)
+     *-------------------------------------------------*/
+    predict = (int32)pitch + (((int32)pitch_gyro * s_lead_q10) >> 10);
+    predict = LIMIT_RANGE(predict, -18000L, 18000L);
+    abs_pitch   = (int16)(ABS_VALUE(pitch) / 100);
+    abs_predict = (int16)(ABS_VALUE(predict) / 100);
+    if (abs_predict < abs_pitch)
     {
-        // 完全上墙, 最大吸力
-        duty = FAN_DUTY_WALL;
+        abs_predict = abs_pitch;
     }
-    else
+    
+    /*-------------------------------------------------
+     * Step 2: 角度映射 + 车速预转
+     *-------------------------------------------------*/
+    target = fan_angle_duty(abs_predict);
+    speed_duty = (int32)ABS_VALUE(speed) * g_fan_param.speed_gain;
+    if (speed_duty > FAN_SPEED_DUTY_MAX)
     {
-        // 线性插值
-        // duty = DEFAULT + (WALL - DEFAULT) * (abs_pitch - THRESHOLD) / (MAX - THRESHOLD)
-        temp = (int32)(FAN_DUTY_WALL - FAN_DUTY_DEFAULT) *
-               (int32)(abs_pitch - FAN_ANGLE_THRESHOLD) /
-               (int32)(FAN_ANGLE_MAX - FAN_ANGLE_THRESHOLD);
-        duty = FAN_DUTY_DEFAULT + (uint16)temp;
+        speed_duty = FAN_SPEED_DUTY_MAX;
+    }
+    if (target < g_fan_param.duty_ground + speed_duty)
+    {
+        target = g_fan_param.duty_ground + speed_duty;
     }
     
-    // 设置占空比
-    Fan_SetDuty(duty);
+    /*-------------------------------------------------
+     * Step 3: 墙上保持
+     *-------------------------------------------------*/
+    if (abs_pitch >= g_fan_param.angle_high ||
+        (element_active && abs_pitch >= g_fan_param.angle_low))
+    {
+        s_hold_cnt = s_hold_cycles;
+    }
+    if (s_hold_cnt > 0)
+    {
+        s_hold_cnt--;
+        if (target < g_fan_param.duty_wall)
+        {
+            target = g_fan_param.duty_wall;
+        }
+    }
+    
+    /*-------------------------------------------------
+     * Step 4: 下降斜坡
+     *-------------------------------------------------*/
+    if (target < (int32)s_target - FAN_RAMP_DOWN)
+    {
+        target = (int32)s_target - FAN_RAMP_DOWN;
+    }
+    target = LIMIT_RANGE(target, 0L, (int32)FAN_DUTY_MAX);
+    s_target = (int16)target;
+    
+    /*-------------------------------------------------
+     * Step 5: 起转超调 + 转速模型
+     *-------------------------------------------------*/
+    output = target;
+    if ((target << 8) > s_model)
+    {
+        output += ((((target << 8) - s_model) >> 8) * FAN_BOOST_Q8) >> 8;
+    }
+    output = LIMIT_RANGE(output, 0L, (int32)FAN_DUTY_MAX);
+    s_model += ((output << 8) - s_model) >> FAN_TAU_SHIFT;
+    
+    Fan_SetDuty((uint16)output);
+}
+
+/**
+ * @brief   超前时间、保持时间修改后重算
+ */
+void Fan_ParamChanged(void)
+{
+    fan_update_param();
 }
 
 /*==================================================================================================================
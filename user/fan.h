@@ -9,6 +9,14 @@
  * @note        上墙时根据 IMU 俯仰角自动增大吸力
  *              地面模式: 默认占空比 (省电)
  *              上墙模式: 高占空比 (强吸附)
+ *
+ *              自动模式 (FAN_MODEL_ENABLE = 1, Fan_Control):
+ *              - 预测: 俯仰角 + 俯仰角速度 × FAN_LEAD_MS, 车头刚开始抬起就按预测角度给吸力,
+ *                      不等姿态角爬到阈值 (风扇起转要 100ms 以上, 过渡弧只有 100ms 左右)
+ *              - 预转: 地面占空比随车速增加, 高速到达墙根时风扇已在较高转速
+ *              - 保持: 在墙上 (或墙上执行元素) 时至少保持上墙占空比, 俯仰角回落后再保持 FAN_HOLD_MS
+ *              - 下降: 目标吸力每周期最多下降 FAN_RAMP_DOWN, 离墙过程中不会突然失去吸附
+ *              - 起转: 一阶模型估计风扇当前转速 (以占空比表示), 目标高于模型转速时按差值超调输出
  ********************************************************************************************************************/
 
 #ifndef __FAN_H__
@@ -28,6 +36,22 @@ typedef enum
     FAN_MODE_AUTO           // 自动模式 (根据IMU自适应)
 } FanMode_t;
 
+/**
+ * @brief   风扇可调参数 (默认值为 car_config.h 中的宏定义, 可由蓝牙 $SET 在线修改, 见 param_registry.h)
+ */
+typedef struct
+{
+    int16 duty_ground;      // 地面模式占空比 (FAN_DUTY_DEFAULT)
+    int16 duty_wall;        // 上墙模式占空比 (FAN_DUTY_WALL)
+    int16 angle_low;        // 开始增大吸力的俯仰角 (FAN_ANGLE_THRESHOLD)
+    int16 angle_high;       // 达到上墙占空比的俯仰角 (FAN_ANGLE_MAX)
+    int16 lead_ms;          // 俯仰角预测超前时间 (FAN_LEAD_MS)
+    int16 speed_gain;       // 车速预转增益 (FAN_SPEED_GAIN)
+    int16 hold_ms;          // 离墙后保持时间 (FAN_HOLD_MS)
+} FanParam_t;
+
+extern FanParam_t g_fan_param;
+
 /*==================================================================================================================
  *                                              函数声明
  *==================================================================================================================*/
@@ -40,11 +64,19 @@ void Fan_Init(void);
 
 /**
  * @brief   设置风扇占空比
- * @param   duty    占空比 (0 ~ 10000, 对应 0% ~ 100%)
+ * @param   duty    占空比 (0 ~ 10000, 对应 0% ~ 100%), 标称电压下的值
  * @return  void
+ * @note    实际占空比按电池电压补偿 (见 Battery_GetCompScale), Fan_GetDuty 返回补偿前的值
  */
 void Fan_SetDuty(uint16 duty);
 
+/**
+ * @brief   按最新的电压补偿倍率重新输出 (地面/上墙模式)
+ * @return  void
+ * @note    主循环中每次电池检测后调用; 自动模式每个控制周期重新设置, 不需要
+ */
+void Fan_Refresh(void);
+
 /**
  * @brief   设置风扇模式
  * @param   mode    风扇模式枚举
@@ -67,6 +99,23 @@ uint16 Fan_GetDuty(void);
  */
 void Fan_AutoAdjust(int16 pitch_angle);
 
+/**
+ * @brief   模型风扇控制 (预测上墙、车速预转、墙上保持、离墙斜坡)
+ * @param   pitch           俯仰角 (0.01°, g_attitude.pitch)
+ * @param   pitch_gyro      俯仰角速度 (陀螺仪原始值, 已扣除零偏, 正 = 抬头)
+ * @param   speed           车速 (编码器脉冲/周期)
+ * @param   element_active  1 = 正在执行转弯类元素 (墙上转弯时保持吸力)
+ * @return  void
+ * @note    适用于 FAN_MODE_AUTO 模式, 在控制中断中每周期调用 (代替 Fan_AutoAdjust)
+ */
+void Fan_Control(int16 pitch, int16 pitch_gyro, int16 speed, uint8 element_active);
+
+/**
+ * @brief   超前时间、保持时间修改后重算 (由参数表模块调用)
+ * @return  void
+ */
+void Fan_ParamChanged(void);
+
 /**
  * @brief   风扇紧急停止
  * @return  void
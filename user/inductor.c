@@ -11,10 +11,16 @@
  *              2. 计算向量模: magnitude = √(x² + y²)
  *              3. 差比和: error = (left - right) / (left + right) × 100
  *              4. 此方法比单电感更稳定, 对不同角度的导线都有较好响应
+ *
+ *              控制中断内不做除法 (STC32G 32 位除法很慢):
+ *              - 归一化: 每通道预先算好 Q24 倒数 100×2^24/(max-min), 校准变化时重算, 结果与原除法逐位一致
+ *              - 向量模: 逐位试商整数平方根 (只有移位/加减/比较), 超过 100 直接限幅
+ *              - 差比和: 分母 (left + right + 1) 只有 1 ~ 201 种, 查 Q16 倒数表, 结果与原除法逐位一致
+ *              精度与耗时对比见 host/inductor_bench.c
  ********************************************************************************************************************/
 
 #include "inductor.h"
-#include <math.h>   // 用于 sqrt, 但会使用快速整数平方根优化
+#include "adc_scan.h"
 
 /*==================================================================================================================
  *                                              私有变量
@@ -31,53 +37,44 @@ static uint16 s_calibration_max[4] = {
     INDUCTOR_LX_MAX, INDUCTOR_LY_MAX, INDUCTOR_RX_MAX, INDUCTOR_RY_MAX
 };
 
+// 归一化倍率 (Q24): 100 × 2^24 / (max - min), 向上取整; 由 Inductor_SetCalibration 重算
+static uint32 s_norm_scale[4];
+
+// 差比和倒数表 (Q16): ceil(100 × 65536 / (sum + 1)), sum = 0 ~ 200
+// |diff| <= sum <= 200 时 (|diff| × 表值) >> 16 与 |diff| × 100 / (sum + 1) 逐位一致
+static const uint32 code s_ratio_recip[201] = {
+    6553600UL, 3276800UL, 2184534UL, 1638400UL, 1310720UL, 1092267UL,  936229UL,  819200UL,
+     728178UL,  655360UL,  595782UL,  546134UL,  504124UL,  468115UL,  436907UL,  409600UL,
+     385506UL,  364089UL,  344927UL,  327680UL,  312077UL,  297891UL,  284940UL,  273067UL,
+     262144UL,  252062UL,  242726UL,  234058UL,  225987UL,  218454UL,  211407UL,  204800UL,
+     198594UL,  192753UL,  187246UL,  182045UL,  177125UL,  172464UL,  168042UL,  163840UL,
+     159844UL,  156039UL,  152410UL,  148946UL,  145636UL,  142470UL,  139439UL,  136534UL,
+     133747UL,  131072UL,  128502UL,  126031UL,  123653UL,  121363UL,  119157UL,  117029UL,
+     114976UL,  112994UL,  111078UL,  109227UL,  107437UL,  105704UL,  104026UL,  102400UL,
+     100825UL,   99297UL,   97815UL,   96377UL,   94980UL,   93623UL,   92305UL,   91023UL,
+      89776UL,   88563UL,   87382UL,   86232UL,   85112UL,   84021UL,   82957UL,   81920UL,
+      80909UL,   79922UL,   78960UL,   78020UL,   77102UL,   76205UL,   75329UL,   74473UL,
+      73636UL,   72818UL,   72018UL,   71235UL,   70469UL,   69720UL,   68986UL,   68267UL,
+      67563UL,   66874UL,   66198UL,   65536UL,   64888UL,   64251UL,   63628UL,   63016UL,
+      62416UL,   61827UL,   61249UL,   60682UL,   60125UL,   59579UL,   59042UL,   58515UL,
+      57997UL,   57488UL,   56988UL,   56497UL,   56014UL,   55539UL,   55073UL,   54614UL,
+      54162UL,   53719UL,   53282UL,   52852UL,   52429UL,   52013UL,   51604UL,   51200UL,
+      50804UL,   50413UL,   50028UL,   49649UL,   49276UL,   48908UL,   48546UL,   48189UL,
+      47837UL,   47490UL,   47149UL,   46812UL,   46480UL,   46153UL,   45830UL,   45512UL,
+      45198UL,   44888UL,   44583UL,   44282UL,   43984UL,   43691UL,   43402UL,   43116UL,
+      42834UL,   42556UL,   42282UL,   42011UL,   41743UL,   41479UL,   41218UL,   40960UL,
+      40706UL,   40455UL,   40207UL,   39961UL,   39719UL,   39480UL,   39244UL,   39010UL,
+      38779UL,   38551UL,   38326UL,   38103UL,   37883UL,   37665UL,   37450UL,   37237UL,
+      37026UL,   36818UL,   36613UL,   36409UL,   36208UL,   36009UL,   35813UL,   35618UL,
+      35425UL,   35235UL,   35046UL,   34860UL,   34676UL,   34493UL,   34313UL,   34134UL,
+      33957UL,   33782UL,   33609UL,   33437UL,   33268UL,   33099UL,   32933UL,   32768UL,
+      32605UL
+};
+
 // 丢线检测阈值 (向量和低于此值认为丢线)
 #define INDUCTOR_OFFLINE_THRESHOLD  20
 
-/*==================================================================================================================
- *                                              快速整数平方根 (查表+牛顿迭代)
- *==================================================================================================================*/
-
-/**
- * @brief   快速整数平方根
- * @details 使用牛顿迭代法, 3次迭代精度足够
- *          比 math.h 的 sqrt() 快约 5-10 倍
- * @param   val     输入值 (0 ~ 65535)
- * @return  uint16  平方根结果
- */
-uint16 fast_sqrt(uint32 val)
-{
-    uint32 result, temp;
-    
-    if (val == 0) return 0;
-    if (val == 1) return 1;
-    
-    // 初始估计值 (选择合适的起点加速收敛)
-    if (val < 256)
-    {
-        result = 8;     // √256 = 16, 取一半作为起点
-    }
-    else if (val < 4096)
-    {
-        result = 32;    // √4096 = 64
-    }
-    else if (val < 65536)
-    {
-        result = 128;   // √65536 = 256
-    }
-    else
-    {
-        result = 256;   // 更大的值
-    }
-    
-    // 牛顿迭代法: x_new = (x + val/x) / 2
-    // 迭代3次, 精度足够用于电感向量计算
-    temp = (result + val / result) >> 1;
-    result = (temp + val / temp) >> 1;
-    result = (result + val / result) >> 1;
-    
-    return (uint16)result;
-}
+static void inductor_update_scale(uint8 channel);
 
 /*==================================================================================================================
  *                                              电感初始化
@@ -88,6 +85,8 @@ uint16 fast_sqrt(uint32 val)
  */
 void Inductor_Init(void)
 {
+    uint8 i;
+    
     // 初始化4路ADC (使用12位分辨率, 硬件已滤波无需高速)
     adc_init(INDUCTOR_LEFT_X_CH,  INDUCTOR_ADC_RESOLUTION);
     adc_init(INDUCTOR_LEFT_Y_CH,  INDUCTOR_ADC_RESOLUTION);
@@ -110,31 +109,90 @@ void Inductor_Init(void)
     g_inductor.vector.error    = 0;
     g_inductor.vector.sum      = 0;
     g_inductor.vector.is_online = 0;
+    
+    // 归一化倍率 (校准参数变化时由 Inductor_SetCalibration 重算)
+    for (i = 0; i < 4; i++)
+    {
+        inductor_update_scale(i);
+    }
 }
 
 /*==================================================================================================================
  *                                              电感数据更新 (核心算法)
  *==================================================================================================================*/
 
+/**
+ * @brief   计算通道归一化倍率
+ * @note    只在初始化和校准变化时调用 (含除法)
+ */
+static void inductor_update_scale(uint8 channel)
+{
+    uint16 span;
+
+    if (s_calibration_max[channel] > s_calibration_min[channel])
+    {
+        span = s_calibration_max[channel] - s_calibration_min[channel];
+        s_norm_scale[channel] = ((uint32)100 << 24) / span;
+        if (((uint32)100 << 24) % span)
+        {
+            s_norm_scale[channel]++;        // 向上取整, 保证与整数除法结果一致
+        }
+    }
+    else
+    {
+        s_norm_scale[channel] = 0;          // 校准无效: 输出 0
+    }
+}
+
 /**
  * @brief   归一化单个电感值
  * @param   raw     原始ADC值
- * @param   min_val 最小校准值
- * @param   max_val 最大校准值
+ * @param   channel 通道号 (0=LX, 1=LY, 2=RX, 3=RY)
  * @return  uint8   归一化值 (0~100)
+ * @note    (raw - min) × 100 / (max - min) 的乘倒数实现: span < 4096 时 Q24 误差小于 1/span, 结果逐位一致
  */
-static uint8 normalize_inductor(uint16 raw, uint16 min_val, uint16 max_val)
+static uint8 normalize_inductor(uint16 raw, uint8 channel)
 {
-    int32 temp;
+    uint16 min_val = s_calibration_min[channel];
+    uint16 max_val = s_calibration_max[channel];
     
     // 限幅
     if (raw < min_val) raw = min_val;
     if (raw > max_val) raw = max_val;
     
-    // 归一化: (raw - min) * 100 / (max - min)
-    temp = (int32)(raw - min_val) * 100 / (int32)(max_val - min_val);
+    return (uint8)(((uint32)(raw - min_val) * s_norm_scale[channel]) >> 24);
+}
+
+/**
+ * @brief   向量模 √(x² + y²), 限幅到 100
+ * @details 逐位试商整数平方根 (向下取整), 只用移位和加减;
+ *          x² + y² >= 100² 时直接返回 100, 因此被开方数 < 2^14, 7 次迭代
+ */
+static uint8 inductor_magnitude(uint8 x, uint8 y)
+{
+    uint16 val = (uint16)((uint16)x * x + (uint16)y * y);     // 100² + 100² < 65536
+    uint16 root = 0;
+    uint16 bit = (uint16)1 << 12;           // 小于 10000 的最大 4 的幂
+    
+    if (val >= 10000)
+    {
+        return 100;
+    }
     
-    return (uint8)temp;
+    while (bit != 0)
+    {
+        if (val >= root + bit)
+        {
+            val -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint8)root;
 }
 
 /**
@@ -142,52 +200,65 @@ static uint8 normalize_inductor(uint16 raw, uint16 min_val, uint16 max_val)
  */
 void Inductor_Update(void)
 {
-    uint32 left_sq, right_sq;   // 临时变量, 计算平方和
-    int16  diff, sum;           // 差值和求和
+#if ADC_SCAN_DMA_ENABLE
+    uint16 frame[ADC_SCAN_CHANNEL_NUM];
+#endif
     
     /*-------------------------------------------------
-     * Step 1: ADC 采样 (使用均值滤波, 采样5次取平均)
+     * Step 1: ADC 采样
+     *         DMA 模式: 直接取后台扫描最近一帧的硬件平均值 (每通道 2^ADC_SCAN_CVT_SHIFT 次)
+     *         阻塞模式: 均值滤波, 每通道采样 INDUCTOR_FILTER_COUNT 次
      *         硬件已有RC滤波 (τ=4.7ms), 软件轻量处理即可
      *-------------------------------------------------*/
+#if ADC_SCAN_DMA_ENABLE
+    AdcScan_GetFrame(frame);
+    g_inductor.raw.left_x  = frame[ADC_SCAN_LEFT_X];
+    g_inductor.raw.left_y  = frame[ADC_SCAN_LEFT_Y];
+    g_inductor.raw.right_x = frame[ADC_SCAN_RIGHT_X];
+    g_inductor.raw.right_y = frame[ADC_SCAN_RIGHT_Y];
+#else
     g_inductor.raw.left_x  = adc_mean_filter_convert(INDUCTOR_LEFT_X_CH,  INDUCTOR_FILTER_COUNT);
     g_inductor.raw.left_y  = adc_mean_filter_convert(INDUCTOR_LEFT_Y_CH,  INDUCTOR_FILTER_COUNT);
     g_inductor.raw.right_x = adc_mean_filter_convert(INDUCTOR_RIGHT_X_CH, INDUCTOR_FILTER_COUNT);
     g_inductor.raw.right_y = adc_mean_filter_convert(INDUCTOR_RIGHT_Y_CH, INDUCTOR_FILTER_COUNT);
+#endif
+    
+    Inductor_Process(&g_inductor.raw);
+}
+
+/**
+ * @brief   由原始 ADC 值计算归一化值、向量模和偏差
+ */
+void Inductor_Process(const InductorRaw_t *raw)
+{
+    int16 diff, sum;            // 差值和求和
+    uint16 ratio;
+    
+    if (raw != &g_inductor.raw)
+    {
+        g_inductor.raw = *raw;
+    }
     
     /*-------------------------------------------------
      * Step 2: 归一化到 0~100
      *         消除不同电感放大倍数差异
      *-------------------------------------------------*/
-    g_inductor.norm.left_x  = normalize_inductor(g_inductor.raw.left_x,  s_calibration_min[0], s_calibration_max[0]);
-    g_inductor.norm.left_y  = normalize_inductor(g_inductor.raw.left_y,  s_calibration_min[1], s_calibration_max[1]);
-    g_inductor.norm.right_x = normalize_inductor(g_inductor.raw.right_x, s_calibration_min[2], s_calibration_max[2]);
-    g_inductor.norm.right_y = normalize_inductor(g_inductor.raw.right_y, s_calibration_min[3], s_calibration_max[3]);
+    g_inductor.norm.left_x  = normalize_inductor(g_inductor.raw.left_x,  0);
+    g_inductor.norm.left_y  = normalize_inductor(g_inductor.raw.left_y,  1);
+    g_inductor.norm.right_x = normalize_inductor(g_inductor.raw.right_x, 2);
+    g_inductor.norm.right_y = normalize_inductor(g_inductor.raw.right_y, 3);
     
     /*-------------------------------------------------
      * Step 3: 计算向量模
-     *         magnitude = √(x² + y²)
-     *         使用快速整数平方根, 提高运算速度
+     *         magnitude = √(x² + y²), 限幅到 100 便于计算 (最大约 √(100²+100²) ≈ 141)
      *-------------------------------------------------*/
-    // 左侧向量模: √(left_x² + left_y²)
-    left_sq = (uint32)g_inductor.norm.left_x * g_inductor.norm.left_x +
-              (uint32)g_inductor.norm.left_y * g_inductor.norm.left_y;
-    g_inductor.vector.left_magnitude = (uint8)fast_sqrt(left_sq);
-    
-    // 右侧向量模: √(right_x² + right_y²)
-    right_sq = (uint32)g_inductor.norm.right_x * g_inductor.norm.right_x +
-               (uint32)g_inductor.norm.right_y * g_inductor.norm.right_y;
-    g_inductor.vector.right_magnitude = (uint8)fast_sqrt(right_sq);
-    
-    // 向量模限幅 (最大约 √(100²+100²) ≈ 141, 限制到100便于计算)
-    if (g_inductor.vector.left_magnitude > 100)
-        g_inductor.vector.left_magnitude = 100;
-    if (g_inductor.vector.right_magnitude > 100)
-        g_inductor.vector.right_magnitude = 100;
+    g_inductor.vector.left_magnitude  = inductor_magnitude(g_inductor.norm.left_x,  g_inductor.norm.left_y);
+    g_inductor.vector.right_magnitude = inductor_magnitude(g_inductor.norm.right_x, g_inductor.norm.right_y);
     
     /*-------------------------------------------------
      * Step 4: 差比和算法计算偏差
      *         error = (left - right) * 100 / (left + right + 1)
-     *         +1 防止除零
+     *         +1 防止除零, 除法用倒数表代替
      *-------------------------------------------------*/
     sum  = (int16)g_inductor.vector.left_magnitude + g_inductor.vector.right_magnitude;
     diff = (int16)g_inductor.vector.left_magnitude - g_inductor.vector.right_magnitude;
@@ -208,7 +279,8 @@ void Inductor_Update(void)
         // 正值 = 左侧信号强 = 车身偏右 = 需要左转
         // 负值 = 右侧信号强 = 车身偏左 = 需要右转
         // 注意: 这里取反是为了让偏差方向与转向方向一致
-        g_inductor.vector.error = -(diff * 100) / (sum + 1);
+        ratio = (uint16)(((uint32)ABS_VALUE(diff) * s_ratio_recip[sum]) >> 16);
+        g_inductor.vector.error = (diff > 0) ? -(int16)ratio : (int16)ratio;
     }
 }
 
@@ -249,5 +321,18 @@ void Inductor_SetCalibration(uint8 channel, uint16 min_val, uint16 max_val)
     {
         s_calibration_min[channel] = min_val;
         s_calibration_max[channel] = max_val;
+        inductor_update_scale(channel);
+    }
+}
+
+/**
+ * @brief   读取电感归一化校准参数
+ */
+void Inductor_GetCalibration(uint8 channel, uint16 *min_val, uint16 *max_val)
+{
+    if (channel < 4)
+    {
+        *min_val = s_calibration_min[channel];
+        *max_val = s_calibration_max[channel];
     }
 }
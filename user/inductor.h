@@ -88,6 +88,14 @@ void Inductor_Init(void);
  */
 void Inductor_Update(void);
 
+/**
+ * @brief   由原始 ADC 值计算归一化值、向量模和偏差 (Inductor_Update 的计算部分)
+ * @param   raw     4 路原始 ADC 值 (拷贝到 g_inductor.raw)
+ * @return  void
+ * @note    不访问 ADC, 主机工具可用录制的原始值重放
+ */
+void Inductor_Process(const InductorRaw_t *raw);
+
 /**
  * @brief   获取当前偏差值
  * @return  int16   偏差值 (-100 ~ +100)
@@ -114,8 +122,17 @@ uint8 Inductor_GetSum(void);
  * @param   min_val     最小值
  * @param   max_val     最大值
  * @return  void
- * @note    用于现场校准, 调整不同场地的电感参数
+ * @note    用于现场校准, 调整不同场地的电感参数; 同时重算该通道的归一化倍率 (含一次除法, 不要在控制中断中频繁调用)
  */
 void Inductor_SetCalibration(uint8 channel, uint16 min_val, uint16 max_val);
 
+/**
+ * @brief   读取电感归一化校准参数
+ * @param   channel     通道号 (0=LX, 1=LY, 2=RX, 3=RY)
+ * @param   min_val     输出: 最小值
+ * @param   max_val     输出: 最大值
+ * @return  void
+ */
+void Inductor_GetCalibration(uint8 channel, uint16 *min_val, uint16 *max_val);
+
 #endif // __INDUCTOR_H__
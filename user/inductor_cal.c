@@ -0,0 +1,231 @@
+/*********************************************************************************************************************
+ * @file        inductor_cal.c
+ * @brief       飞檐走壁智能车 - 电感自动标定模块 (源文件)
+ * @details     控制中断中采样 (3 点中值滤波 + 极值), 主循环中检查跨度并应用到 Inductor_SetCalibration
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-21
+ ********************************************************************************************************************/
+
+#include "inductor_cal.h"
+#include "bluetooth.h"
+
+/*==================================================================================================================
+ *                                              全局变量
+ *==================================================================================================================*/
+
+InductorCalData_t g_inductor_cal;
+
+/*==================================================================================================================
+ *                                              私有变量
+ *==================================================================================================================*/
+
+static uint16 s_history[4][2];          // 每路最近两次采样 (中值滤波)
+static uint8  s_apply = 0;              // 扫描结束后是否应用
+
+#define INDUCTOR_CAL_SAMPLES    (INDUCTOR_CAL_TIME_MS / CONTROL_PERIOD_MS)
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   3 点中值
+ */
+static uint16 inductor_cal_median3(uint16 a, uint16 b, uint16 c)
+{
+    if (a > b)
+    {
+        if (b > c) return b;
+        return (a > c) ? c : a;
+    }
+    if (a > c) return a;
+    return (b > c) ? c : b;
+}
+
+/**
+ * @brief   应用扫描结果
+ * @return  uint8   有效位 (bit n = 通道 n 已更新)
+ */
+static uint8 inductor_cal_apply(void)
+{
+    uint8 ch;
+    uint8 mask = 0;
+
+    for (ch = 0; ch < 4; ch++)
+    {
+        if (g_inductor_cal.samples > 2 &&
+            g_inductor_cal.max[ch] >= g_inductor_cal.min[ch] + INDUCTOR_CAL_MIN_SPAN)
+        {
+            Inductor_SetCalibration(ch, g_inductor_cal.min[ch], g_inductor_cal.max[ch]);
+            mask |= (uint8)(1 << ch);
+        }
+    }
+    return mask;
+}
+
+/*==================================================================================================================
+ *                                              对外接口
+ *==================================================================================================================*/
+
+/**
+ * @brief   开始标定
+ */
+void InductorCal_Start(void)
+{
+    uint8 ch;
+
+    // 先停止采样再清零, 避免控制中断读到一半的数据
+    g_inductor_cal.state = INDUCTOR_CAL_IDLE;
+
+    for (ch = 0; ch < 4; ch++)
+    {
+        g_inductor_cal.min[ch] = 0xFFFF;
+        g_inductor_cal.max[ch] = 0;
+    }
+    g_inductor_cal.samples = 0;
+    s_apply = 0;
+
+    g_inductor_cal.state = INDUCTOR_CAL_SWEEP;
+
+    // 长响一声: 开始扫线
+    BUZZER_ON();
+    system_delay_ms(300);
+    BUZZER_OFF();
+}
+
+/**
+ * @brief   结束扫描
+ */
+void InductorCal_Stop(uint8 apply)
+{
+    if (g_inductor_cal.state == INDUCTOR_CAL_SWEEP)
+    {
+        s_apply = apply;
+        g_inductor_cal.state = INDUCTOR_CAL_FINISH;
+    }
+}
+
+/**
+ * @brief   是否正在扫描
+ */
+uint8 InductorCal_IsActive(void)
+{
+    return (g_inductor_cal.state == INDUCTOR_CAL_SWEEP);
+}
+
+/**
+ * @brief   扫描采样
+ */
+void InductorCal_Update(const InductorRaw_t *raw)
+{
+    uint16 value[4];
+    uint16 m;
+    uint8 ch;
+
+    if (g_inductor_cal.state != INDUCTOR_CAL_SWEEP)
+    {
+        return;
+    }
+
+    value[0] = raw->left_x;
+    value[1] = raw->left_y;
+    value[2] = raw->right_x;
+    value[3] = raw->right_y;
+
+    for (ch = 0; ch < 4; ch++)
+    {
+        // 前两个采样只填充历史
+        if (g_inductor_cal.samples >= 2)
+        {
+            m = inductor_cal_median3(s_history[ch][0], s_history[ch][1], value[ch]);
+            if (m < g_inductor_cal.min[ch]) g_inductor_cal.min[ch] = m;
+            if (m > g_inductor_cal.max[ch]) g_inductor_cal.max[ch] = m;
+        }
+        s_history[ch][0] = s_history[ch][1];
+        s_history[ch][1] = value[ch];
+    }
+
+    g_inductor_cal.samples++;
+    if (g_inductor_cal.samples >= INDUCTOR_CAL_SAMPLES)
+    {
+        s_apply = 1;
+        g_inductor_cal.state = INDUCTOR_CAL_FINISH;
+    }
+}
+
+/**
+ * @brief   主循环任务
+ */
+uint8 InductorCal_Task(void)
+{
+    uint8 updated = 0;
+
+    if (g_inductor_cal.state != INDUCTOR_CAL_FINISH)
+    {
+        return 0;
+    }
+
+    if (s_apply)
+    {
+        g_inductor_cal.valid_mask = inductor_cal_apply();
+        updated = (g_inductor_cal.valid_mask != 0);
+
+        if (g_inductor_cal.valid_mask == 0x0F)
+        {
+            // 短响两声: 4 路全部更新
+            BUZZER_ON();
+            system_delay_ms(100);
+            BUZZER_OFF();
+            system_delay_ms(100);
+            BUZZER_ON();
+            system_delay_ms(100);
+            BUZZER_OFF();
+        }
+        else
+        {
+            // 长响: 有通道没扫到
+            BUZZER_ON();
+            system_delay_ms(800);
+            BUZZER_OFF();
+        }
+    }
+
+    g_inductor_cal.state = INDUCTOR_CAL_IDLE;
+    InductorCal_SendReport();
+    return updated;
+}
+
+/**
+ * @brief   发送标定状态和当前生效的校准参数
+ */
+void InductorCal_SendReport(void)
+{
+    char line[64];
+    char *p;
+    uint16 min_val, max_val;
+    uint8 ch;
+
+    p = line;
+    *p++ = 'C';
+    *p++ = 'A';
+    *p++ = 'L';
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, (uint16)g_inductor_cal.state);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_inductor_cal.samples);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_inductor_cal.valid_mask);
+    for (ch = 0; ch < 4; ch++)
+    {
+        Inductor_GetCalibration(ch, &min_val, &max_val);
+        *p++ = ' ';
+        p = Bluetooth_AppendInt(p, min_val);
+        *p++ = ' ';
+        p = Bluetooth_AppendInt(p, max_val);
+    }
+    *p++ = '\r';
+    *p++ = '\n';
+    *p   = '\0';
+    Bluetooth_SendString(line);
+}
@@ -0,0 +1,98 @@
+/*********************************************************************************************************************
+ * @file        inductor_cal.h
+ * @brief       飞檐走壁智能车 - 电感自动标定模块 (头文件)
+ * @details     停车状态下把车横向扫过导线, 记录 4 路电感的最小/最大值, 替换 car_config.h 中的估计值
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-21
+ *
+ * @note        使用方法:
+ *              1. 车放在导线上, 长按启动键 (超过 KEY_CAL_HOLD_MS) 或发送 $CAL:1, 蜂鸣器长响一声开始
+ *              2. 手推车身左右来回扫过导线几次, 两侧都要离开导线足够远 (让电感读到底噪)
+ *              3. INDUCTOR_CAL_TIME_MS 后自动结束 ($CAL:0 提前结束, $CAL:2 放弃), 跨度足够的通道立即生效,
+ *                 蜂鸣器短响两声 = 4 路全部更新, 长响 = 有通道跨度不足 (保留原参数);
+ *                 有通道更新时连同其他参数一起保存到 EEPROM (见 param_store.h)
+ *              4. $CAL 查询: "CAL 状态 采样数 有效位 LXmin LXmax LYmin LYmax RXmin RXmax RYmin RYmax" (当前生效的参数)
+ *
+ *              异常值剔除: 每路先做 3 点中值滤波再取极值, 单个采样的尖峰 (电机干扰、ADC 毛刺) 不会进入结果;
+ *              扫过导线时峰值持续几十 ms, 因此采样放在控制中断中按 5ms 进行
+ ********************************************************************************************************************/
+
+#ifndef __INDUCTOR_CAL_H__
+#define __INDUCTOR_CAL_H__
+
+#include "car_config.h"
+#include "inductor.h"
+
+/*==================================================================================================================
+ *                                              数据结构
+ *==================================================================================================================*/
+
+/**
+ * @brief   标定状态
+ */
+typedef enum
+{
+    INDUCTOR_CAL_IDLE = 0,      // 未标定 / 已结束
+    INDUCTOR_CAL_SWEEP,         // 扫描中 (控制中断采样)
+    INDUCTOR_CAL_FINISH         // 扫描结束, 等待主循环应用
+} InductorCalState_t;
+
+/**
+ * @brief   标定数据
+ */
+typedef struct
+{
+    InductorCalState_t state;
+    uint16 samples;             // 本次扫描的采样数
+    uint16 min[4];              // 本次扫描的最小值 (中值滤波后, 0=LX, 1=LY, 2=RX, 3=RY)
+    uint16 max[4];              // 本次扫描的最大值
+    uint8  valid_mask;          // 上次结果: bit n = 通道 n 跨度足够, 已应用
+} InductorCalData_t;
+
+extern InductorCalData_t g_inductor_cal;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   开始标定
+ * @return  void
+ * @note    只能在停车时调用 (主循环)
+ */
+void InductorCal_Start(void);
+
+/**
+ * @brief   结束扫描 (结果由之后的 InductorCal_Task 应用)
+ * @param   apply   1 = 应用跨度足够的通道, 0 = 放弃本次结果
+ * @return  void
+ */
+void InductorCal_Stop(uint8 apply);
+
+/**
+ * @brief   是否正在扫描
+ * @return  uint8   1 = 扫描中 (控制中断需采样电感)
+ */
+uint8 InductorCal_IsActive(void);
+
+/**
+ * @brief   扫描采样 (停车时在 System_Control 中调用, 5ms)
+ * @param   raw     本周期 4 路原始 ADC 值
+ * @return  void
+ */
+void InductorCal_Update(const InductorRaw_t *raw);
+
+/**
+ * @brief   主循环任务: 扫描结束后应用结果、提示并发送报告
+ * @return  uint8   1 = 本次有通道更新了校准参数 (调用方可保存到 EEPROM)
+ */
+uint8 InductorCal_Task(void);
+
+/**
+ * @brief   发送标定状态和当前生效的校准参数 "CAL ..."
+ * @return  void
+ */
+void InductorCal_SendReport(void);
+
+#endif // __INDUCTOR_CAL_H__
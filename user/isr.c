@@ -39,6 +39,7 @@
 #include "../code/system.h"
 #include "../code/bluetooth.h"
 #include "../code/key.h"
+#include "../code/adc_scan.h"
 
 void DMA_UART1_IRQHandler(void) interrupt 4
 {
@@ -150,6 +151,18 @@ void DMA_UART4_IRQHandler(void) interrupt 18
     }
 }
 
+void DMA_ADC_IRQHandler(void) interrupt 48
+{
+    // 电感/电池 ADC DMA 扫描完成 - 切换缓冲区并解析 (飞檐走壁智能车)
+    AdcScan_DmaIRQHandler();
+}
+
+void DMA_UR4T_IRQHandler(void) interrupt 56
+{
+    // 蓝牙发送队列 DMA 发送完成, 继续发送下一段 (飞檐走壁智能车)
+    Bluetooth_TxDmaIRQHandler();
+}
+
 void TM0_IRQHandler() interrupt 1
 {
     TIM0_CLEAR_FLAG;
@@ -18,6 +18,7 @@ static uint8        g_is_race_mode = 0;              /* 当前模式 (0=调车,
 static uint16       g_countdown_ms = 0;              /* 倒计时计数器 (ms) */
 static uint8        g_start_key_pressed = 0;         /* 启动按键当前状态 */
 static uint8        g_debounce_cnt = 0;              /* 消抖计数器 */
+static uint8        g_cal_request = 0;               /* 电感标定请求 (长按启动键) */
 
 /*==================================================================================================================
  *                                              初始化函数
@@ -114,6 +115,16 @@ void key_scan(void)
     /* 3. 倒计时处理 */
     if (g_car_state == CAR_STATE_COUNTDOWN)
     {
+        /* 长按: 取消启动, 请求电感标定 (由主循环处理) */
+        if (g_start_key_pressed && (START_COUNTDOWN_MS - g_countdown_ms) >= KEY_CAL_HOLD_MS)
+        {
+            g_car_state = CAR_STATE_IDLE;
+            g_countdown_ms = 0;
+            g_cal_request = 1;
+            BUZZER_OFF();
+            return;
+        }
+        
         if (g_countdown_ms > 0)
         {
             g_countdown_ms -= scan_period_ms;
@@ -187,3 +198,14 @@ void key_reset_to_idle(void)
     g_car_state = CAR_STATE_IDLE;
     g_countdown_ms = 0;
 }
+
+/**
+ * @brief   读取并清除电感标定请求
+ */
+uint8 key_take_cal_request(void)
+{
+    uint8 request = g_cal_request;
+    
+    g_cal_request = 0;
+    return request;
+}
@@ -14,6 +14,7 @@
  *              1. 上电后检查拨码开关位置选择模式
  *              2. 按下启动按键,蜂鸣器响3声后小车开始运行
  *              3. 调车模式下速度限制为3000,比赛模式为8000
+ *              4. 按住启动按键超过1.5秒: 取消倒计时, 进入电感标定 (见 inductor_cal.h)
  ********************************************************************************************************************/
 
 #ifndef __KEY_H__
@@ -81,6 +82,12 @@ void key_stop_car(void);
  */
 void key_reset_to_idle(void);
 
+/**
+ * @brief   读取并清除电感标定请求 (长按启动键产生)
+ * @return  1=有标定请求, 0=无
+ */
+uint8 key_take_cal_request(void);
+
 /*==================================================================================================================
  *                                              速度限制宏
  *==================================================================================================================*/
@@ -98,5 +105,6 @@ void key_reset_to_idle(void);
 
 #define START_COUNTDOWN_MS      3000            // 启动倒计时 3秒
 #define KEY_DEBOUNCE_TIME_MS    30              // 按键消抖时间 30ms
+#define KEY_CAL_HOLD_MS         1500            // 倒计时中持续按住超过 1.5 秒: 取消启动, 进入电感标定
 
 #endif // __KEY_H__
@@ -9,6 +9,7 @@
 
 #include "motor.h"
 #include "key.h"          // 用于获取运行模式，实现速度自适应限制
+#include "battery.h"      // 电压补偿倍率
 
 /*==================================================================================================================
  *                                              私有变量
@@ -80,7 +81,7 @@ void Motor_SetSingle(uint8 motor_id, int16 speed)
     if (speed > speed_limit)  speed = speed_limit;
     if (speed < -speed_limit) speed = -speed_limit;
     
-    // 记录 PWM 值
+    // 记录 PWM 值 (标称电压下的占空比, 即控制器的输出)
     s_motor_pwm[motor_id] = speed;
     
     // 根据速度正负设置方向
@@ -95,6 +96,15 @@ void Motor_SetSingle(uint8 motor_id, int16 speed)
         duty = (uint32)(-speed);
     }
     
+    // 电压补偿: 按 标称电压 / 实际电压 放大, 电池放电过程中电机得到的平均电压不变
+    duty = (duty * Battery_GetCompScale() + 2048) >> 12;
+    
+    // 补偿后再次限幅 (调车模式的限幅是实际占空比上限)
+    if (duty > (uint32)speed_limit)
+    {
+        duty = (uint32)speed_limit;
+    }
+    
     // 设置 PWM 占空比
     pwm_set_duty(pwm_ch, duty);
 }
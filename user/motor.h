@@ -40,8 +40,9 @@ void Motor_SetSpeed(int16 left_speed, int16 right_speed);
 /**
  * @brief   设置单个电机速度
  * @param   motor_id    电机编号 (0=左, 1=右)
- * @param   speed       速度值 (-MOTOR_SPEED_MAX ~ +MOTOR_SPEED_MAX)
+ * @param   speed       速度值 (-MOTOR_SPEED_MAX ~ +MOTOR_SPEED_MAX), 标称电压下的占空比
  * @return  void
+ * @note    实际占空比按电池电压补偿 (见 Battery_GetCompScale)
  */
 void Motor_SetSingle(uint8 motor_id, int16 speed);
 
@@ -63,7 +64,7 @@ void Motor_Brake(void);
 /**
  * @brief   获取当前电机 PWM 输出值
  * @param   motor_id    电机编号 (0=左, 1=右)
- * @return  int16       当前 PWM 值 (带符号)
+ * @return  int16       当前 PWM 值 (带符号, 补偿前)
  */
 int16 Motor_GetPWM(uint8 motor_id);
 
@@ -7,6 +7,8 @@
  * @date        2026-02-06
  * 
  * @note        使用软件 I2C 驱动，兼容性好，无需硬件资源
+ *              显示函数只写 1KB 显存并记录每页的脏列区间, oled_refresh() 时
+ *              每个脏区间只发一次定位命令 + 一次连续数据传输; 内容未变化的字符不产生 I2C 传输
  ********************************************************************************************************************/
 
 #include "oled.h"
@@ -122,7 +124,7 @@ static const uint8 code OLED_FONT_6X8[][6] = {
 static void i2c_delay(void)
 {
     uint8 i;
-    for (i = 0; i < 10; i++);
+    for (i = 0; i < OLED_I2C_DELAY_LOOPS; i++);
 }
 
 /* SCL 引脚操作 */
@@ -182,6 +184,32 @@ static void i2c_write_byte(uint8 dat)
     SCL_LOW();
 }
 
+/*==================================================================================================================
+ *                                              显存 (帧缓冲)
+ *==================================================================================================================*/
+
+/* 1KB 显存: 8 页 × 128 列, 每字节为一列 8 个像素 (低位在上) */
+static uint8 xdata s_oled_buf[OLED_PAGES][OLED_WIDTH];
+
+/* 每页脏区间 [min, max], min > max 表示本页无改动 */
+static uint8 s_dirty_min[OLED_PAGES];
+static uint8 s_dirty_max[OLED_PAGES];
+
+/* 标记一页的脏区间 */
+static void oled_mark_dirty(uint8 page, uint8 x_start, uint8 x_end)
+{
+    if (s_dirty_min[page] > s_dirty_max[page])
+    {
+        s_dirty_min[page] = x_start;
+        s_dirty_max[page] = x_end;
+    }
+    else
+    {
+        if (x_start < s_dirty_min[page]) s_dirty_min[page] = x_start;
+        if (x_end   > s_dirty_max[page]) s_dirty_max[page] = x_end;
+    }
+}
+
 /*==================================================================================================================
  *                                              OLED 底层命令/数据发送
  *==================================================================================================================*/
@@ -196,22 +224,33 @@ static void oled_write_cmd(uint8 cmd)
     i2c_stop();
 }
 
-/* 发送数据 */
-static void oled_write_data(uint8 dat)
+/* 设置显示位置 (三条命令放在同一次传输中) */
+static void oled_set_pos(uint8 x, uint8 page)
 {
     i2c_start();
-    i2c_write_byte(OLED_I2C_ADDR);  /* 设备地址 + 写 */
-    i2c_write_byte(0x40);            /* Co=0, D/C=1 (数据) */
-    i2c_write_byte(dat);
+    i2c_write_byte(OLED_I2C_ADDR);
+    i2c_write_byte(0x00);                       /* Co=0, D/C=0: 后续字节全部为命令 */
+    i2c_write_byte(0xB0 + page);                /* 设置页地址 */
+    i2c_write_byte(0x00 + (x & 0x0F));          /* 设置列低地址 */
+    i2c_write_byte(0x10 + ((x >> 4) & 0x0F));   /* 设置列高地址 */
     i2c_stop();
 }
 
-/* 设置显示位置 */
-static void oled_set_pos(uint8 x, uint8 page)
+/* 连续发送一段显存 (一次传输, 列地址自动递增) */
+static void oled_write_span(uint8 page, uint8 x, uint8 len)
 {
-    oled_write_cmd(0xB0 + page);             /* 设置页地址 */
-    oled_write_cmd(0x00 + (x & 0x0F));       /* 设置列低地址 */
-    oled_write_cmd(0x10 + ((x >> 4) & 0x0F)); /* 设置列高地址 */
+    const uint8 xdata *p = &s_oled_buf[page][x];
+
+    oled_set_pos(x, page);
+
+    i2c_start();
+    i2c_write_byte(OLED_I2C_ADDR);
+    i2c_write_byte(0x40);                       /* Co=0, D/C=1: 后续字节全部为数据 */
+    while (len--)
+    {
+        i2c_write_byte(*p++);
+    }
+    i2c_stop();
 }
 
 /*==================================================================================================================
@@ -260,34 +299,138 @@ void oled_init(void)
     oled_write_cmd(0x14);
     oled_write_cmd(0xAF);   /* 开启显示 */
     
-    /* 清屏 */
+    /* 清屏: 上电后面板 RAM 内容未知, 整屏标记为脏并立即刷新 */
     oled_clear();
+    oled_mark_all_dirty();
+    oled_refresh();
 }
 
 /**
- * @brief   清屏
+ * @brief   清屏 (只清显存, 调用 oled_refresh 后生效)
  */
 void oled_clear(void)
 {
     uint8 page, col;
     
-    for (page = 0; page < 8; page++)
+    for (page = 0; page < OLED_PAGES; page++)
+    {
+        for (col = 0; col < OLED_WIDTH; col++)
+        {
+            if (s_oled_buf[page][col] != 0x00)
+            {
+                s_oled_buf[page][col] = 0x00;
+                oled_mark_dirty(page, col, col);
+            }
+        }
+    }
+}
+
+/**
+ * @brief   整屏标记为脏
+ */
+void oled_mark_all_dirty(void)
+{
+    uint8 page;
+    
+    for (page = 0; page < OLED_PAGES; page++)
+    {
+        s_dirty_min[page] = 0;
+        s_dirty_max[page] = OLED_WIDTH - 1;
+    }
+}
+
+/**
+ * @brief   刷新显示 (只发送有改动的区间)
+ */
+void oled_refresh(void)
+{
+    /* 整屏最多 8 × (128 + OLED_SPAN_OVERHEAD) 字节, 预算足够一次发完 */
+    oled_refresh_budget(0xFFFF);
+}
+
+/**
+ * @brief   按字节预算刷新
+ */
+uint16 oled_refresh_budget(uint16 max_bytes)
+{
+    uint16 sent = 0;
+    uint16 remain;
+    uint8 page;
+    uint8 len;
+    
+    for (page = 0; page < OLED_PAGES; page++)
+    {
+        if (s_dirty_min[page] > s_dirty_max[page])
+        {
+            continue;
+        }
+        
+        len = (uint8)(s_dirty_max[page] - s_dirty_min[page] + 1);
+        remain = (sent < max_bytes) ? (uint16)(max_bytes - sent) : 0;
+        
+        if (remain <= OLED_SPAN_OVERHEAD)
+        {
+            /* 预算用完; 但每次调用至少发 1 列, 保证预算很小时也能刷完 */
+            if (sent != 0)
+            {
+                break;
+            }
+            len = 1;
+        }
+        else if (len > remain - OLED_SPAN_OVERHEAD)
+        {
+            len = (uint8)(remain - OLED_SPAN_OVERHEAD);
+        }
+        
+        oled_write_span(page, s_dirty_min[page], len);
+        sent += OLED_SPAN_OVERHEAD + len;
+        
+        /* 区间没发完时只推进起点, 剩余部分下次继续 */
+        if ((uint8)(s_dirty_min[page] + len) > s_dirty_max[page])
+        {
+            s_dirty_min[page] = 0xFF;
+            s_dirty_max[page] = 0x00;
+        }
+        else
+        {
+            s_dirty_min[page] += len;
+            break;
+        }
+    }
+    
+    return sent;
+}
+
+/**
+ * @brief   显存是否有未发送的改动
+ */
+uint8 oled_is_dirty(void)
+{
+    uint8 page;
+    
+    for (page = 0; page < OLED_PAGES; page++)
     {
-        oled_set_pos(0, page);
-        for (col = 0; col < 128; col++)
+        if (s_dirty_min[page] <= s_dirty_max[page])
         {
-            oled_write_data(0x00);
+            return 1;
         }
     }
+    return 0;
 }
 
 /**
  * @brief   显示单个字符
  */
-void oled_show_char(uint8 x, uint8 page, char c)
+void oled_show_char(uint8 x, uint8 y, char c)
 {
     uint8 i;
     uint8 idx;
+    uint8 dirty_start = 0xFF, dirty_end = 0;
+    
+    if (y >= OLED_PAGES)
+    {
+        return;
+    }
     
     /* 字符范围检查 */
     if (c < 32 || c > 126)
@@ -296,10 +439,23 @@ void oled_show_char(uint8 x, uint8 page, char c)
     }
     idx = c - 32;
     
-    oled_set_pos(x, page);
-    for (i = 0; i < 6; i++)
+    /* 写入显存, 只有内容真的变化时才标脏 (重复显示相同内容不产生 I2C 传输) */
+    for (i = 0; i < 6 && (uint8)(x + i) < OLED_WIDTH; i++)
+    {
+        if (s_oled_buf[y][x + i] != OLED_FONT_6X8[idx][i])
+        {
+            s_oled_buf[y][x + i] = OLED_FONT_6X8[idx][i];
+            if (dirty_start == 0xFF)
+            {
+                dirty_start = x + i;
+            }
+            dirty_end = x + i;
+        }
+    }
+    
+    if (dirty_start != 0xFF)
     {
-        oled_write_data(OLED_FONT_6X8[idx][i]);
+        oled_mark_dirty(y, dirty_start, dirty_end);
     }
 }
 
@@ -24,7 +24,10 @@
 
 #define OLED_WIDTH              128             /* 屏幕宽度 (像素) */
 #define OLED_HEIGHT             64              /* 屏幕高度 (像素) */
+#define OLED_PAGES              (OLED_HEIGHT / 8)   /* 页数 (每页 8 行像素) */
 #define OLED_I2C_ADDR           0x78            /* SSD1306 I2C 地址 (7bit=0x3C, 写地址=0x78) */
+#define OLED_I2C_DELAY_LOOPS    10              /* I2C 半周期延时循环次数 (约 5us, 标准模式; 减小前需用示波器确认 SCL 低电平 ≥ 1.3us) */
+#define OLED_SPAN_OVERHEAD      7               /* 每个区间的额外字节: 地址+控制+3 条定位命令, 地址+控制 */
 
 /* I2C 引脚定义 (使用 car_config.h 中的定义) */
 #define OLED_SCL                OLED_I2C_SCL_PIN    /* P2.5 */
@@ -43,16 +46,39 @@ void oled_init(void);
 /**
  * @brief   清屏
  * @return  void
+ * @note    只清显存, 调用 oled_refresh() 后生效
  */
 void oled_clear(void);
 
+/**
+ * @brief   整屏标记为脏 (下次刷新时重发全部显存)
+ * @return  void
+ * @note    屏幕复位或受干扰花屏后使用
+ */
+void oled_mark_all_dirty(void);
+
 /**
  * @brief   刷新显示 (将缓冲区数据发送到 OLED)
  * @return  void
  * @note    修改缓冲区后需要调用此函数才能显示
+ *          只发送有改动的列区间, 每页至多一次定位 + 一次连续数据传输
  */
 void oled_refresh(void);
 
+/**
+ * @brief   按字节预算刷新 (分多次调用刷完, 限制单次阻塞时间)
+ * @param   max_bytes   本次最多发送的 I2C 字节数 (含每个区间 OLED_SPAN_OVERHEAD 字节的开销)
+ * @return  uint16      实际发送的 I2C 字节数, 0 = 没有改动
+ * @note    区间超出预算时拆开发送, 剩余部分下次继续; 每次至少发送 1 列, 保证能刷完
+ */
+uint16 oled_refresh_budget(uint16 max_bytes);
+
+/**
+ * @brief   显存是否有未发送的改动
+ * @return  uint8   1 = 有, 0 = 无
+ */
+uint8 oled_is_dirty(void);
+
 /**
  * @brief   显示单个字符
  * @param   x       起始 X 坐标
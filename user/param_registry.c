@@ -0,0 +1,369 @@
+/*********************************************************************************************************************
+ * @file        param_registry.c
+ * @brief       飞檐走壁智能车 - 参数表模块 (源文件)
+ * @details     可调参数表 + 蓝牙 $GET/$SET/$LIST 处理 (十进制定点换算, 不用浮点和 sprintf)
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-23
+ ********************************************************************************************************************/
+
+#include "param_registry.h"
+#include "system.h"
+#include "element.h"
+#include "steer.h"
+#include "speed_ctrl.h"
+#include "fan.h"
+#include "bluetooth.h"
+
+/*==================================================================================================================
+ *                                              参数表
+ *==================================================================================================================*/
+
+/**
+ * @brief   可调参数表 (顺序即 EEPROM 保存顺序, 修改时同时修改 PARAM_STORE_VERSION)
+ * @note    方向环增益登记的是基础增益, 元素增益表在此基础上缩放;
+ *          速度环增益登记左轮, 右轮由 System_ParamChanged 同步
+ */
+static const ParamEntry_t code s_param_table[] = {
+    /* 名称          地址                                  类型             小数 下限  上限    回调 */
+    { "speed",      &g_system.target_speed,                PARAM_TYPE_I16,  0,   0,    200,   0 },
+    { "dir_kp",     &g_system.dir_kp_base,                 PARAM_TYPE_Q10,  1,   0,    300,   System_ParamChanged },
+    { "dir_ki",     &g_system.dir_ki_base,                 PARAM_TYPE_Q10,  1,   0,    300,   System_ParamChanged },
+    { "dir_kd",     &g_system.dir_kd_base,                 PARAM_TYPE_Q10,  1,   0,    300,   System_ParamChanged },
+    { "spd_kp",     &g_system.pid_speed_left.Kp,           PARAM_TYPE_Q10,  1,   0,    300,   System_ParamChanged },
+    { "spd_ki",     &g_system.pid_speed_left.Ki,           PARAM_TYPE_Q10,  1,   0,    300,   System_ParamChanged },
+    { "spd_kd",     &g_system.pid_speed_left.Kd,           PARAM_TYPE_Q10,  1,   0,    300,   System_ParamChanged },
+    { "rate_kp",    &g_steer_param.rate_kp_x100,           PARAM_TYPE_I16,  2,   0,    1000,  Steer_ParamChanged },
+    { "ff_gain",    &g_steer_param.ff_gain,                PARAM_TYPE_I16,  0,   0,    500,   Steer_ParamChanged },
+    { "zz_jump",    &g_element_param.zigzag_jump,          PARAM_TYPE_I16,  0,   0,    200,   0 },
+    { "t90_low",    &g_element_param.turn90_low,           PARAM_TYPE_I16,  0,   0,    100,   0 },
+    { "t90_high",   &g_element_param.turn90_high,          PARAM_TYPE_I16,  0,   0,    100,   0 },
+    { "t90_step",   &g_element_param.turn90_step,          PARAM_TYPE_I16,  0,   0,    1024,  0 },
+    { "t90_yaw",    &g_element_param.turn90_yaw,           PARAM_TYPE_I16,  0,   0,    180,   0 },
+    { "hex_sum",    &g_element_param.hexagon_sum,          PARAM_TYPE_I16,  0,   0,    200,   0 },
+    { "hex_yaw",    &g_element_param.hexagon_yaw,          PARAM_TYPE_I16,  0,   0,    720,   0 },
+    { "hex_off",    &g_element_param.hexagon_offset,       PARAM_TYPE_I16,  0,   0,    1024,  0 },
+    { "cross_high", &g_element_param.cross_high,           PARAM_TYPE_I16,  0,   0,    100,   0 },
+    { "fan_gnd",    &g_fan_param.duty_ground,              PARAM_TYPE_I16,  0,   0,    FAN_DUTY_MAX, 0 },
+    { "fan_wall",   &g_fan_param.duty_wall,                PARAM_TYPE_I16,  0,   0,    FAN_DUTY_MAX, 0 },
+    { "fan_ang0",   &g_fan_param.angle_low,                PARAM_TYPE_I16,  0,   0,    90,    0 },
+    { "fan_ang1",   &g_fan_param.angle_high,               PARAM_TYPE_I16,  0,   0,    90,    0 },
+    { "spd_ff",     &g_speed_ctrl_param.ff_duty_x100,      PARAM_TYPE_I16,  2,   0,    5000,  SpeedCtrl_ParamChanged },
+    { "spd_st",     &g_speed_ctrl_param.ff_static,         PARAM_TYPE_I16,  0,   0,    3000,  0 },
+    { "spd_slew",   &g_speed_ctrl_param.slew,              PARAM_TYPE_I16,  0,   1,    PID_SPEED_OUT_MAX, 0 },
+    { "fan_lead",   &g_fan_param.lead_ms,                  PARAM_TYPE_I16,  0,   0,    500,   Fan_ParamChanged },
+    { "fan_spd",    &g_fan_param.speed_gain,               PARAM_TYPE_I16,  0,   0,    100,   0 },
+    { "fan_hold",   &g_fan_param.hold_ms,                  PARAM_TYPE_I16,  0,   0,    2000,  Fan_ParamChanged }
+};
+
+// 表长度与 PARAM_REG_NUM 不一致时编译报错 (数组长度为负)
+typedef char param_reg_num_check[(sizeof(s_param_table) / sizeof(s_param_table[0]) == PARAM_REG_NUM) ? 1 : -1];
+
+/*==================================================================================================================
+ *                                              私有变量
+ *==================================================================================================================*/
+
+static uint8 s_list_pos = 0xFF;             // $LIST 下一项, 0xFF = 空闲
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   名称比较 (输入不分大小写, 表中名称为小写)
+ */
+static uint8 param_name_equal(const char *input, const char *name)
+{
+    char c;
+
+    while (*input && *name)
+    {
+        c = *input;
+        if (c >= 'A' && c <= 'Z')
+        {
+            c = (char)(c - 'A' + 'a');
+        }
+        if (c != *name) return 0;
+        input++;
+        name++;
+    }
+    return (*input == '\0' && *name == '\0');
+}
+
+/**
+ * @brief   十进制定点解析 "12.5" → 125 (小数位 1), 多余的小数位截断
+ * @return  int32   已限制在 ±32767 以内
+ */
+static int32 param_parse_value(const char *str, uint8 decimals)
+{
+    int32 value = 0;
+    uint8 negative = 0;
+    uint8 frac = 0;
+
+    if (*str == '-')
+    {
+        negative = 1;
+        str++;
+    }
+    else if (*str == '+')
+    {
+        str++;
+    }
+
+    while (*str >= '0' && *str <= '9')
+    {
+        if (value < 32767)
+        {
+            value = value * 10 + (*str - '0');
+        }
+        str++;
+    }
+
+    if (*str == '.')
+    {
+        str++;
+        while (frac < decimals && *str >= '0' && *str <= '9')
+        {
+            value = value * 10 + (*str - '0');
+            frac++;
+            str++;
+        }
+    }
+
+    while (frac < decimals)
+    {
+        value *= 10;
+        frac++;
+    }
+
+    if (value > 32767)
+    {
+        value = 32767;
+    }
+    return negative ? -value : value;
+}
+
+/**
+ * @brief   追加字符串
+ */
+static char *param_append_str(char *p, const char *str, uint8 max_len)
+{
+    while (*str && max_len > 0)
+    {
+        *p++ = *str++;
+        max_len--;
+    }
+    return p;
+}
+
+/**
+ * @brief   追加十进制定点数 (前面加空格), 125 (小数位 1) → " 12.5"
+ */
+static char *param_append_value(char *p, int16 value, uint8 decimals)
+{
+    char tmp[7];
+    uint16 mag;
+    uint8 n = 0;
+
+    *p++ = ' ';
+    if (value < 0)
+    {
+        *p++ = '-';
+        mag = (uint16)(-(int32)value);
+    }
+    else
+    {
+        mag = (uint16)value;
+    }
+
+    do
+    {
+        tmp[n++] = (char)('0' + mag % 10);
+        mag /= 10;
+        if (n == decimals)
+        {
+            tmp[n++] = '.';
+        }
+    } while (mag > 0 || (decimals > 0 && n <= decimals + 1));     // 补齐 "0.05" 的前导零
+
+    while (n > 0)
+    {
+        *p++ = tmp[--n];
+    }
+    return p;
+}
+
+/**
+ * @brief   发送一项 "PAR 名称 当前值 下限 上限"
+ */
+static void param_send_entry(uint8 index)
+{
+    const ParamEntry_t code *e = &s_param_table[index];
+    char line[48];
+    char *p;
+
+    p = line;
+    *p++ = 'P';
+    *p++ = 'A';
+    *p++ = 'R';
+    *p++ = ' ';
+    p = param_append_str(p, e->name, 11);
+    p = param_append_value(p, ParamRegistry_Get(index), e->decimals);
+    p = param_append_value(p, e->min, e->decimals);
+    p = param_append_value(p, e->max, e->decimals);
+    *p++ = '\r';
+    *p++ = '\n';
+    *p   = '\0';
+    Bluetooth_SendString(line);
+}
+
+/**
+ * @brief   发送 "PAR ? 名称" (没有该参数 / 格式错误)
+ */
+static void param_send_unknown(const char *name)
+{
+    char line[32];
+    char *p;
+
+    p = line;
+    p = param_append_str(p, "PAR ? ", 6);
+    p = param_append_str(p, name, 16);
+    *p++ = '\r';
+    *p++ = '\n';
+    *p   = '\0';
+    Bluetooth_SendString(line);
+}
+
+/*==================================================================================================================
+ *                                              对外接口
+ *==================================================================================================================*/
+
+/**
+ * @brief   按名称查找参数
+ */
+uint8 ParamRegistry_Find(const char *name)
+{
+    uint8 i;
+
+    for (i = 0; i < PARAM_REG_NUM; i++)
+    {
+        if (param_name_equal(name, s_param_table[i].name))
+        {
+            return i;
+        }
+    }
+    return 0xFF;
+}
+
+/**
+ * @brief   读取参数的整数值
+ */
+int16 ParamRegistry_Get(uint8 index)
+{
+    const ParamEntry_t code *e = &s_param_table[index];
+
+    if (e->type == PARAM_TYPE_Q10)
+    {
+        return PID_GainToX10(*(int32 *)e->ptr);
+    }
+    return *(int16 *)e->ptr;
+}
+
+/**
+ * @brief   修改参数
+ */
+void ParamRegistry_Set(uint8 index, int16 value)
+{
+    const ParamEntry_t code *e = &s_param_table[index];
+    int32 gain;
+
+    value = LIMIT_RANGE(value, e->min, e->max);
+
+    if (e->type == PARAM_TYPE_Q10)
+    {
+        gain = PID_GainFromX10(value);
+        interrupt_global_disable();
+        *(int32 *)e->ptr = gain;
+        interrupt_global_enable();
+    }
+    else
+    {
+        interrupt_global_disable();
+        *(int16 *)e->ptr = value;
+        interrupt_global_enable();
+    }
+
+    if (e->apply)
+    {
+        e->apply();
+    }
+}
+
+/**
+ * @brief   处理 $GET
+ */
+void ParamRegistry_CmdGet(const char *name)
+{
+    uint8 index = ParamRegistry_Find(name);
+
+    if (index == 0xFF)
+    {
+        param_send_unknown(name);
+        return;
+    }
+    param_send_entry(index);
+}
+
+/**
+ * @brief   处理 $SET
+ */
+void ParamRegistry_CmdSet(char *arg)
+{
+    char *value_str = arg;
+    uint8 index;
+
+    while (*value_str && *value_str != '=')
+    {
+        value_str++;
+    }
+    if (*value_str != '=')
+    {
+        param_send_unknown(arg);
+        return;
+    }
+    *value_str++ = '\0';
+
+    index = ParamRegistry_Find(arg);
+    if (index == 0xFF)
+    {
+        param_send_unknown(arg);
+        return;
+    }
+
+    ParamRegistry_Set(index, (int16)param_parse_value(value_str, s_param_table[index].decimals));
+    param_send_entry(index);
+}
+
+/**
+ * @brief   处理 $LIST
+ */
+void ParamRegistry_CmdList(void)
+{
+    s_list_pos = 0;
+}
+
+/**
+ * @brief   主循环任务
+ */
+void ParamRegistry_Task(void)
+{
+    while (s_list_pos < PARAM_REG_NUM && Bluetooth_GetTxFree() >= 48)
+    {
+        param_send_entry(s_list_pos);
+        s_list_pos++;
+    }
+    if (s_list_pos >= PARAM_REG_NUM)
+    {
+        s_list_pos = 0xFF;
+    }
+}
@@ -0,0 +1,111 @@
+/*********************************************************************************************************************
+ * @file        param_registry.h
+ * @brief       飞檐走壁智能车 - 参数表模块 (头文件)
+ * @details     把各模块的可调参数登记在一张表中 (名称、地址、类型、小数位、上下限、修改后回调),
+ *              蓝牙 $GET/$SET/$LIST 和 EEPROM 参数存储都按这张表工作, 调参不用再改代码重新下载
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-23
+ *
+ * @note        协议 (回复 "PAR 名称 当前值 下限 上限", 数值按小数位显示):
+ *              $GET:t90_yaw\n          查询一个参数, 回复 "PAR t90_yaw 45 0 180"
+ *              $SET:t90_yaw=60\n       修改并回复新值 (超出上下限时限幅), 名称不分大小写
+ *              $SET:spd_kp=2.5\n       带小数的参数按小数位换算, 多余的小数位截断
+ *              $LIST\n                 按表顺序逐行回复全部参数 (主循环中按发送队列空间分批发送)
+ *              未知名称回复 "PAR ? 名称"
+ *
+ *              修改在主循环中完成, 写入时关中断, 控制中断不会读到一半的 16/32 位数据;
+ *              运行中也可修改, 下一个控制周期生效; $SAVE 把当前值保存到 EEPROM (见 param_store.h)
+ *
+ *              增加参数: 在 param_registry.c 的表末尾加一行并修改 PARAM_REG_NUM,
+ *              同时修改 PARAM_STORE_VERSION (EEPROM 中按表顺序保存, 旧记录将被忽略)
+ ********************************************************************************************************************/
+
+#ifndef __PARAM_REGISTRY_H__
+#define __PARAM_REGISTRY_H__
+
+#include "car_config.h"
+
+/*==================================================================================================================
+ *                                              数据结构
+ *==================================================================================================================*/
+
+#define PARAM_REG_NUM           28          // 参数个数 (与 param_registry.c 中的表一致, 编译时检查)
+
+/**
+ * @brief   参数存储类型
+ */
+typedef enum
+{
+    PARAM_TYPE_I16 = 0,         // int16, 数值 = 显示值 × 10^小数位
+    PARAM_TYPE_Q10              // int32 PID 增益 (Q10), 显示为 1 位小数 (与 $P 一致)
+} ParamType_t;
+
+/**
+ * @brief   参数表项
+ */
+typedef struct
+{
+    const char *name;           // 名称 (小写, 不超过 11 个字符)
+    void       *ptr;            // 参数地址
+    uint8       type;           // ParamType_t
+    uint8       decimals;       // 小数位 (0 ~ 2)
+    int16       min;            // 下限 (整数值, 即显示值 × 10^小数位)
+    int16       max;            // 上限
+    void      (*apply)(void);   // 修改后调用 (可为 0)
+} ParamEntry_t;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   按名称查找参数 (不分大小写)
+ * @param   name    参数名
+ * @return  uint8   表中序号, 0xFF = 没有该参数
+ */
+uint8 ParamRegistry_Find(const char *name);
+
+/**
+ * @brief   读取参数的整数值 (显示值 × 10^小数位)
+ * @param   index   表中序号
+ * @return  int16
+ */
+int16 ParamRegistry_Get(uint8 index);
+
+/**
+ * @brief   修改参数 (限幅后写入并调用回调)
+ * @param   index   表中序号
+ * @param   value   整数值 (显示值 × 10^小数位)
+ * @return  void
+ * @note    只在主循环中调用
+ */
+void ParamRegistry_Set(uint8 index, int16 value);
+
+/**
+ * @brief   处理 $GET 命令: 查询并回复
+ * @param   name    参数名
+ * @return  void
+ */
+void ParamRegistry_CmdGet(const char *name);
+
+/**
+ * @brief   处理 $SET 命令: 解析 "名称=数值", 修改后回复新值
+ * @param   arg     命令参数 (会被修改)
+ * @return  void
+ */
+void ParamRegistry_CmdSet(char *arg);
+
+/**
+ * @brief   处理 $LIST 命令: 从第一项开始列出全部参数 (由 ParamRegistry_Task 分批发送)
+ * @return  void
+ */
+void ParamRegistry_CmdList(void);
+
+/**
+ * @brief   主循环任务: 发送队列空间足够时继续 $LIST 输出
+ * @return  void
+ */
+void ParamRegistry_Task(void);
+
+#endif // __PARAM_REGISTRY_H__
@@ -0,0 +1,264 @@
+/*********************************************************************************************************************
+ * @file        param_store.c
+ * @brief       飞檐走壁智能车 - 参数存储模块 (源文件)
+ * @details     两扇区轮换 + 扇区内顺序追加的 IAP EEPROM 参数记录, CRC-16 校验, 序号取最新
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-22
+ ********************************************************************************************************************/
+
+#include "param_store.h"
+#include "telemetry.h"              /* Telemetry_Crc16 */
+#include "bluetooth.h"
+
+/*==================================================================================================================
+ *                                              全局变量
+ *==================================================================================================================*/
+
+ParamStoreStatus_t g_param_store;
+
+/*==================================================================================================================
+ *                                              私有定义
+ *==================================================================================================================*/
+
+#define PARAM_STORE_MAGIC       0xC5A3
+
+/**
+ * @brief   一条记录 (CRC 覆盖 crc 之前的全部字节)
+ */
+typedef struct
+{
+    uint16      magic;
+    uint8       version;
+    uint8       length;             // sizeof(ParamData_t)
+    uint16      seq;                // 序号, 每次保存 +1 (回绕按差值比较)
+    ParamData_t data;
+    uint16      crc;
+} ParamRecord_t;
+
+#define PARAM_RECORD_SIZE       ((uint16)sizeof(ParamRecord_t))
+#define PARAM_STORE_SLOTS       ((uint8)(PARAM_STORE_SECTOR_SIZE / sizeof(ParamRecord_t)))
+
+// 记录长度字段和 CRC 长度都是 8 位, 参数表加长到放不下时编译报错
+typedef char param_record_size_check[(sizeof(ParamRecord_t) <= 255) ? 1 : -1];
+
+static ParamRecord_t xdata s_record;        // 读写缓冲
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   记录地址 (EEPROM 区内偏移)
+ */
+static uint32 param_store_addr(uint8 sector, uint8 slot)
+{
+    return (uint32)PARAM_STORE_BASE_ADDR + (uint32)sector * PARAM_STORE_SECTOR_SIZE
+         + (uint32)slot * PARAM_RECORD_SIZE;
+}
+
+/**
+ * @brief   记录 CRC
+ */
+static uint16 param_store_crc(const ParamRecord_t *rec)
+{
+    return Telemetry_Crc16((const uint8 *)rec, (uint8)(PARAM_RECORD_SIZE - 2));
+}
+
+/**
+ * @brief   读取一条记录到 s_record 并检查
+ * @return  1 = 有效记录
+ */
+static uint8 param_store_read(uint8 sector, uint8 slot)
+{
+    iap_read_bytes(param_store_addr(sector, slot), (uint8 *)&s_record, PARAM_RECORD_SIZE);
+
+    return (s_record.magic == PARAM_STORE_MAGIC &&
+            s_record.version == PARAM_STORE_VERSION &&
+            s_record.length == (uint8)sizeof(ParamData_t) &&
+            s_record.crc == param_store_crc(&s_record));
+}
+
+/**
+ * @brief   检查位置是否为擦除状态 (全 0xFF, 可直接写入)
+ */
+static uint8 param_store_is_blank(uint8 sector, uint8 slot)
+{
+    const uint8 *p = (const uint8 *)&s_record;
+    uint16 i;
+
+    iap_read_bytes(param_store_addr(sector, slot), (uint8 *)&s_record, PARAM_RECORD_SIZE);
+    for (i = 0; i < PARAM_RECORD_SIZE; i++)
+    {
+        if (p[i] != 0xFF)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*==================================================================================================================
+ *                                              对外接口
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化并扫描
+ */
+void ParamStore_Init(void)
+{
+    uint8 sector, slot;
+
+    iap_init();
+
+    g_param_store.seq = 0;
+    g_param_store.sector = 0;
+    g_param_store.slot = 0xFF;
+    g_param_store.result = 0;
+
+    for (sector = 0; sector < 2; sector++)
+    {
+        for (slot = 0; slot < PARAM_STORE_SLOTS; slot++)
+        {
+            if (!param_store_read(sector, slot))
+            {
+                continue;
+            }
+            if (g_param_store.slot == 0xFF || (int16)(s_record.seq - g_param_store.seq) > 0)
+            {
+                g_param_store.seq = s_record.seq;
+                g_param_store.sector = sector;
+                g_param_store.slot = slot;
+            }
+        }
+    }
+}
+
+/**
+ * @brief   读取最新记录
+ */
+uint8 ParamStore_Load(ParamData_t *data)
+{
+    g_param_store.result = 0;
+
+    if (g_param_store.slot == 0xFF || !param_store_read(g_param_store.sector, g_param_store.slot))
+    {
+        return 0;
+    }
+
+    *data = s_record.data;
+    g_param_store.result = 1;
+    return 1;
+}
+
+/**
+ * @brief   追加一条记录
+ */
+uint8 ParamStore_Save(const ParamData_t *data)
+{
+    const uint8 *expect;
+    const uint8 *actual;
+    ParamRecord_t rec;
+    uint8 sector, slot;
+    uint16 i;
+
+    g_param_store.result = 0;
+
+    /*-------------------------------------------------
+     * Step 1: 找写入位置 (当前扇区最新记录之后的空位, 没有则擦除另一扇区)
+     *-------------------------------------------------*/
+    if (g_param_store.slot == 0xFF)
+    {
+        sector = 0;
+        slot = PARAM_STORE_SLOTS;           // 没有有效记录: 直接擦除扇区 A
+    }
+    else
+    {
+        sector = g_param_store.sector;
+        slot = g_param_store.slot + 1;
+    }
+
+    while (slot < PARAM_STORE_SLOTS && !param_store_is_blank(sector, slot))
+    {
+        slot++;                             // 跳过掉电写坏的位置
+    }
+
+    if (slot >= PARAM_STORE_SLOTS)
+    {
+        if (g_param_store.slot != 0xFF)
+        {
+            sector ^= 1;
+        }
+        slot = 0;
+        iap_erase_page(param_store_addr(sector, 0));
+    }
+
+    /*-------------------------------------------------
+     * Step 2: 写入并回读校验
+     *-------------------------------------------------*/
+    rec.magic = PARAM_STORE_MAGIC;
+    rec.version = PARAM_STORE_VERSION;
+    rec.length = (uint8)sizeof(ParamData_t);
+    rec.seq = g_param_store.seq + 1;
+    rec.data = *data;
+    rec.crc = param_store_crc(&rec);
+
+    iap_write_bytes(param_store_addr(sector, slot), (uint8 *)&rec, PARAM_RECORD_SIZE);
+
+    iap_read_bytes(param_store_addr(sector, slot), (uint8 *)&s_record, PARAM_RECORD_SIZE);
+    expect = (const uint8 *)&rec;
+    actual = (const uint8 *)&s_record;
+    for (i = 0; i < PARAM_RECORD_SIZE; i++)
+    {
+        if (expect[i] != actual[i])
+        {
+            return 0;
+        }
+    }
+
+    g_param_store.seq = rec.seq;
+    g_param_store.sector = sector;
+    g_param_store.slot = slot;
+    g_param_store.result = 1;
+    return 1;
+}
+
+/**
+ * @brief   擦除两个扇区
+ */
+void ParamStore_Erase(void)
+{
+    iap_erase_page(param_store_addr(0, 0));
+    iap_erase_page(param_store_addr(1, 0));
+
+    g_param_store.seq = 0;
+    g_param_store.sector = 0;
+    g_param_store.slot = 0xFF;
+    g_param_store.result = 1;
+}
+
+/**
+ * @brief   发送存储状态
+ */
+void ParamStore_SendReport(void)
+{
+    char line[32];
+    char *p;
+
+    p = line;
+    *p++ = 'P';
+    *p++ = 'R';
+    *p++ = 'M';
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_param_store.result);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_param_store.seq);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_param_store.sector);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_param_store.slot);
+    *p++ = '\r';
+    *p++ = '\n';
+    *p   = '\0';
+    Bluetooth_SendString(line);
+}
@@ -0,0 +1,98 @@
+/*********************************************************************************************************************
+ * @file        param_store.h
+ * @brief       飞檐走壁智能车 - 参数存储模块 (头文件)
+ * @details     把蓝牙调好的参数 (参数表中的全部可调参数、电感校准) 保存到片内 IAP EEPROM, 上电自动加载
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-22
+ *
+ * @note        存储布局:
+ *              EEPROM 区内 PARAM_STORE_BASE_ADDR 起两个扇区 (A/B, 各 PARAM_STORE_SECTOR_SIZE 字节) 轮流使用,
+ *              扇区内按顺序追加记录, 每条记录 = 头 (魔数、版本、长度、序号) + 参数 + CRC-16
+ *
+ *              - 保存: 写到当前扇区下一个空位; 当前扇区写满时擦除另一扇区并写在其开头,
+ *                      每次保存只写一条记录, 两个扇区的擦写次数平均分摊
+ *              - 加载: 扫描两个扇区, 取 CRC 正确、版本一致、序号最新的记录;
+ *                      写记录时掉电只会损坏这一条, 上一条仍然有效
+ *              - 找不到有效记录 (新芯片、参数格式改版) 时保持 car_config.h 中的默认值
+ *
+ *              STC-ISP 下载时 EEPROM 大小至少设为 PARAM_STORE_BASE_ADDR + 2 × 扇区大小;
+ *              擦写期间 CPU 暂停 (擦除约 4~6ms), 因此只允许停车时保存
+ *
+ *              ParamData_t 字段或参数表 (param_registry.c) 有增删、换序时必须修改 PARAM_STORE_VERSION, 旧记录将被忽略
+ ********************************************************************************************************************/
+
+#ifndef __PARAM_STORE_H__
+#define __PARAM_STORE_H__
+
+#include "car_config.h"
+#include "param_registry.h"
+
+/*==================================================================================================================
+ *                                              数据结构
+ *==================================================================================================================*/
+
+#define PARAM_STORE_VERSION     5           // 参数格式版本 (2: 按参数表保存, 3: 增加速度前馈参数, 4: 增加风扇模型参数,
+                                            //               5: 元素方向偏置改为 1/1024)
+
+/**
+ * @brief   保存的参数 (只用 16 位字段, 单片机与主机的结构体布局一致)
+ */
+typedef struct
+{
+    uint16 cal_min[4];          // 电感校准最小值 (0=LX, 1=LY, 2=RX, 3=RY)
+    uint16 cal_max[4];          // 电感校准最大值
+    int16  reg[PARAM_REG_NUM];  // 参数表各项 (ParamRegistry_Get 的整数值, 按表顺序)
+} ParamData_t;
+
+/**
+ * @brief   存储状态 (调试用)
+ */
+typedef struct
+{
+    uint16 seq;                 // 最新记录序号
+    uint8  sector;              // 最新记录所在扇区 (0 = A, 1 = B)
+    uint8  slot;                // 最新记录在扇区内的位置, 0xFF = 没有有效记录
+    uint8  result;              // 上次加载/保存结果 (1 = 成功)
+} ParamStoreStatus_t;
+
+extern ParamStoreStatus_t g_param_store;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化 IAP 并扫描两个扇区, 找到最新记录
+ * @return  void
+ */
+void ParamStore_Init(void);
+
+/**
+ * @brief   读取最新记录
+ * @param   data    输出参数 (失败时不修改)
+ * @return  uint8   1 = 成功, 0 = 没有有效记录
+ */
+uint8 ParamStore_Load(ParamData_t *data);
+
+/**
+ * @brief   追加一条记录
+ * @param   data    要保存的参数
+ * @return  uint8   1 = 成功 (已回读校验), 0 = 失败
+ * @note    只能在停车时于主循环中调用
+ */
+uint8 ParamStore_Save(const ParamData_t *data);
+
+/**
+ * @brief   擦除两个扇区 (下次上电使用 car_config.h 默认值)
+ * @return  void
+ */
+void ParamStore_Erase(void);
+
+/**
+ * @brief   发送存储状态 "PRM 结果 序号 扇区 位置"
+ * @return  void
+ */
+void ParamStore_SendReport(void);
+
+#endif // __PARAM_STORE_H__
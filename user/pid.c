@@ -1,14 +1,61 @@
 /*********************************************************************************************************************
  * @file        pid.c
  * @brief       飞檐走壁智能车 - PID控制器模块 (源文件)
- * @details     实现增量式PID和位置式PID算法
+ * @details     实现增量式PID和位置式PID算法 (Q10 定点)
  * @author      智能车竞赛代码
- * @version     1.0
+ * @version     1.1
  * @date        2026-02-01
  ********************************************************************************************************************/
 
 #include "pid.h"
 
+/*==================================================================================================================
+ *                                              定点运算辅助函数
+ *==================================================================================================================*/
+
+#define PID_INT32_MAX   ((int32)0x7FFFFFFFL)
+#define PID_INT32_MIN   (-PID_INT32_MAX - 1)
+
+/**
+ * @brief   int32 -> int16 饱和
+ */
+static int16 pid_sat16(int32 x)
+{
+    if (x > 32767)  return 32767;
+    if (x < -32767) return -32767;
+    return (int16)x;
+}
+
+/**
+ * @brief   int32 饱和加法
+ */
+static int32 pid_add_sat(int32 a, int32 b)
+{
+    if (b > 0 && a > PID_INT32_MAX - b) return PID_INT32_MAX;
+    if (b < 0 && a < PID_INT32_MIN - b) return PID_INT32_MIN;
+    return a + b;
+}
+
+/**
+ * @brief   增益限幅到 ±PID_GAIN_MAX
+ */
+static int32 pid_clamp_gain(int32 gain)
+{
+    if (gain > PID_GAIN_MAX)  return PID_GAIN_MAX;
+    if (gain < -PID_GAIN_MAX) return -PID_GAIN_MAX;
+    return gain;
+}
+
+/**
+ * @brief   输出限幅
+ */
+static int32 pid_clamp_output(PID_Controller_t *pid, int32 value)
+{
+    if (value > pid->output_max)  return pid->output_max;
+    if (value < -pid->output_max) return -pid->output_max;
+    return value;
+}
+
 /*==================================================================================================================
  *                                              PID 初始化
  *==================================================================================================================*/
@@ -16,25 +63,24 @@
 /**
  * @brief   初始化 PID 控制器
  */
-void PID_Init(PID_Controller_t *pid, float kp, float ki, float kd, int32 out_max)
+void PID_Init(PID_Controller_t *pid, int32 kp, int32 ki, int32 kd, int32 out_max)
 {
     // 设置PID参数
-    pid->Kp = kp;
-    pid->Ki = ki;
-    pid->Kd = kd;
-    
+    PID_SetParams(pid, kp, ki, kd);
+
     // 清零误差记录
     pid->error_now  = 0;
     pid->error_last = 0;
     pid->error_prev = 0;
-    
+
     // 清零积分项, 设置积分限幅 (通常为输出限幅的50%)
     pid->integral     = 0;
     pid->integral_max = out_max / 2;
-    
+
     // 设置输出限幅
-    pid->output     = 0;
-    pid->output_max = out_max;
+    pid->output      = 0;
+    pid->output_max  = out_max;
+    pid->output_frac = 0;
 }
 
 /*==================================================================================================================
@@ -47,46 +93,41 @@ void PID_Init(PID_Controller_t *pid, float kp, float ki, float kd, int32 out_max
  *          1. 无需积分饱和处理
  *          2. 切换时冲击小
  *          3. 便于手动/自动切换
- * 
+ *
  *          公式推导:
  *          Δu(k) = u(k) - u(k-1)
  *                = Kp × [e(k) - e(k-1)] + Ki × e(k) + Kd × [e(k) - 2×e(k-1) + e(k-2)]
+ *
+ *          定点实现: 三个分量在 Q10 下求和, 整数部分累加到输出, 小数部分留在 output_frac
+ *          中参与下次计算, 因此 Ki × e(k) < 1 这类小增量不会像浮点截断那样被丢弃
  */
 int32 PID_Incremental(PID_Controller_t *pid, int16 target, int16 feedback)
 {
-    int32 delta_output;     // 输出增量
-    int32 p_term, i_term, d_term;   // P, I, D 分量
-    
+    int32 delta_q;          // 输出增量 (Q10)
+    int32 delta_int;        // 输出增量整数部分
+
     // 更新误差序列: 依次后移
     pid->error_prev = pid->error_last;
     pid->error_last = pid->error_now;
-    pid->error_now  = target - feedback;
-    
-    // 计算 P 分量: Kp × [e(k) - e(k-1)]
-    p_term = (int32)(pid->Kp * (float)(pid->error_now - pid->error_last));
-    
-    // 计算 I 分量: Ki × e(k)
-    i_term = (int32)(pid->Ki * (float)(pid->error_now));
-    
-    // 计算 D 分量: Kd × [e(k) - 2×e(k-1) + e(k-2)]
-    d_term = (int32)(pid->Kd * (float)(pid->error_now - 2 * pid->error_last + pid->error_prev));
-    
-    // 计算输出增量
-    delta_output = p_term + i_term + d_term;
-    
-    // 累加到输出值
-    pid->output += delta_output;
-    
-    // 输出限幅
-    if (pid->output > pid->output_max)
-    {
-        pid->output = pid->output_max;
-    }
-    else if (pid->output < -pid->output_max)
-    {
-        pid->output = -pid->output_max;
-    }
-    
+    pid->error_now  = pid_sat16((int32)target - feedback);
+
+    // P 分量: Kp × [e(k) - e(k-1)]
+    delta_q = pid->Kp * pid_sat16((int32)pid->error_now - pid->error_last);
+
+    // I 分量: Ki × e(k)
+    delta_q = pid_add_sat(delta_q, pid->Ki * pid->error_now);
+
+    // D 分量: Kd × [e(k) - 2×e(k-1) + e(k-2)]
+    delta_q = pid_add_sat(delta_q, pid->Kd * pid_sat16((int32)pid->error_now - 2 * (int32)pid->error_last + pid->error_prev));
+
+    // 加上上次的小数余量, 拆分整数/小数部分 (算术右移 = 向下取整, 余量恒为非负)
+    delta_q   = pid_add_sat(delta_q, pid->output_frac);
+    delta_int = delta_q >> PID_Q_SHIFT;
+    pid->output_frac = delta_q - (delta_int << PID_Q_SHIFT);
+
+    // 累加到输出值并限幅 (输出已限幅, 增量不超过 2^21, 不会溢出)
+    pid->output = pid_clamp_output(pid, pid->output + delta_int);
+
     return pid->output;
 }
 
@@ -97,21 +138,18 @@ int32 PID_Incremental(PID_Controller_t *pid, int16 target, int16 feedback)
 /**
  * @brief   位置式 PID 计算
  * @note    位置式PID直接输出控制量, 适合方向控制
- * 
+ *
  *          公式:
  *          u(k) = Kp × e(k) + Ki × Σe(k) + Kd × [e(k) - e(k-1)]
  */
 int32 PID_Positional(PID_Controller_t *pid, int16 target, int16 feedback)
 {
-    int32 p_term, i_term, d_term;   // P, I, D 分量
-    
+    int32 sum_q;            // 输出 (Q10)
+
     // 更新误差
     pid->error_last = pid->error_now;
-    pid->error_now  = target - feedback;
-    
-    // 计算 P 分量: Kp × e(k)
-    p_term = (int32)(pid->Kp * (float)(pid->error_now));
-    
+    pid->error_now  = pid_sat16((int32)target - feedback);
+
     // 积分累加并限幅 (防止积分饱和)
     pid->integral += pid->error_now;
     if (pid->integral > pid->integral_max)
@@ -122,26 +160,20 @@ int32 PID_Positional(PID_Controller_t *pid, int16 target, int16 feedback)
     {
         pid->integral = -pid->integral_max;
     }
-    
-    // 计算 I 分量: Ki × Σe(k)
-    i_term = (int32)(pid->Ki * (float)(pid->integral));
-    
-    // 计算 D 分量: Kd × [e(k) - e(k-1)]
-    d_term = (int32)(pid->Kd * (float)(pid->error_now - pid->error_last));
-    
-    // 计算输出
-    pid->output = p_term + i_term + d_term;
-    
-    // 输出限幅
-    if (pid->output > pid->output_max)
-    {
-        pid->output = pid->output_max;
-    }
-    else if (pid->output < -pid->output_max)
-    {
-        pid->output = -pid->output_max;
-    }
-    
+
+    // P 分量: Kp × e(k)
+    sum_q = pid->Kp * pid->error_now;
+
+    // I 分量: Ki × Σe(k)
+    sum_q = pid_add_sat(sum_q, pid->Ki * pid_sat16(pid->integral));
+
+    // D 分量: Kd × [e(k) - e(k-1)]
+    sum_q = pid_add_sat(sum_q, pid->Kd * pid_sat16((int32)pid->error_now - pid->error_last));
+
+    // Q10 -> 整数 (四舍五入) 并限幅
+    sum_q = pid_add_sat(sum_q, PID_Q_ONE / 2);
+    pid->output = pid_clamp_output(pid, sum_q >> PID_Q_SHIFT);
+
     return pid->output;
 }
 
@@ -154,11 +186,12 @@ int32 PID_Positional(PID_Controller_t *pid, int16 target, int16 feedback)
  */
 void PID_Reset(PID_Controller_t *pid)
 {
-    pid->error_now  = 0;
-    pid->error_last = 0;
-    pid->error_prev = 0;
-    pid->integral   = 0;
-    pid->output     = 0;
+    pid->error_now   = 0;
+    pid->error_last  = 0;
+    pid->error_prev  = 0;
+    pid->integral    = 0;
+    pid->output      = 0;
+    pid->output_frac = 0;
 }
 
 /*==================================================================================================================
@@ -166,11 +199,42 @@ void PID_Reset(PID_Controller_t *pid)
  *==================================================================================================================*/
 
 /**
- * @brief   更新 PID 参数 (用于蓝牙调参)
+ * @brief   更新 PID 参数
  */
-void PID_SetParams(PID_Controller_t *pid, float kp, float ki, float kd)
+void PID_SetParams(PID_Controller_t *pid, int32 kp, int32 ki, int32 kd)
 {
-    pid->Kp = kp;
-    pid->Ki = ki;
-    pid->Kd = kd;
+    pid->Kp = pid_clamp_gain(kp);
+    pid->Ki = pid_clamp_gain(ki);
+    pid->Kd = pid_clamp_gain(kd);
+}
+
+/**
+ * @brief   以 ×10 整数更新 PID 参数 (用于蓝牙调参)
+ * @note    超过 ±PID_GAIN_MAX_X10 的值在 PID_SetParams 中限幅到 ±PID_GAIN_MAX
+ */
+void PID_SetParamsX10(PID_Controller_t *pid, int16 kp_x10, int16 ki_x10, int16 kd_x10)
+{
+    PID_SetParams(pid, PID_GainFromX10(kp_x10), PID_GainFromX10(ki_x10), PID_GainFromX10(kd_x10));
+}
+
+/**
+ * @brief   ×10 整数 -> Q10 增益
+ */
+int32 PID_GainFromX10(int16 value_x10)
+{
+    int32 scaled = (int32)value_x10 * PID_Q_ONE;
+
+    // 对称四舍五入 (仅在调参时调用, 除法开销可接受)
+    return (scaled >= 0) ? (scaled + 5) / 10 : (scaled - 5) / 10;
+}
+
+/**
+ * @brief   Q10 增益 -> ×10 整数
+ */
+int16 PID_GainToX10(int32 gain)
+{
+    int32 scaled = gain * 10;
+
+    return (int16)((scaled >= 0) ? (scaled + PID_Q_ONE / 2) >> PID_Q_SHIFT
+                                 : -((-scaled + PID_Q_ONE / 2) >> PID_Q_SHIFT));
 }
@@ -3,8 +3,15 @@
  * @brief       飞檐走壁智能车 - PID控制器模块 (头文件)
  * @details     实现增量式PID和位置式PID算法, 用于速度环、方向环、姿态环控制
  * @author      智能车竞赛代码
- * @version     1.0
+ * @version     1.1
  * @date        2026-02-01
+ * 
+ * @note        全定点实现 (STC32G 无 FPU, 控制中断内不使用浮点):
+ *              - Kp/Ki/Kd 以 Q10 整数存储 (1.0 = 1024)
+ *              - 误差项限幅到 int16, 增益限幅到 PID_GAIN_MAX, 乘积不会溢出 int32
+ *              - 增益上限约 31.99 (×10 调参值 319): 蓝牙 $P/$I/$D 给出更大的值时按上限生效, 不报错;
+ *                参数表 ($SET:dir_kp 等) 的上限 30.0 在此范围内
+ *              - 各分量求和使用饱和加法
  ********************************************************************************************************************/
 
 #ifndef __PID_H__
@@ -12,6 +19,18 @@
 
 #include "car_config.h"
 
+/*==================================================================================================================
+ *                                              定点格式定义
+ *==================================================================================================================*/
+
+#define PID_Q_SHIFT             10                                  // 增益小数位数 (Q10)
+#define PID_Q_ONE               ((int32)1 << PID_Q_SHIFT)           // 定点 1.0
+#define PID_GAIN_MAX            32767L                              // 增益上限 (约 31.99), 保证 增益×int16 < 2^30
+#define PID_GAIN_MAX_X10        319                                 // 增益上限的 ×10 调参值 (31.9)
+
+// 浮点常量 -> Q10 增益 (仅用于编译期常量, 例如 car_config.h 中的默认参数)
+#define PID_GAIN_Q(f)           ((int32)((f) * (float)PID_Q_ONE + ((f) >= 0 ? 0.5f : -0.5f)))
+
 /*==================================================================================================================
  *                                              PID 控制器结构体
  *==================================================================================================================*/
@@ -23,10 +42,10 @@
  */
 typedef struct
 {
-    // PID 参数 (可通过蓝牙动态调整)
-    float Kp;                   // 比例系数
-    float Ki;                   // 积分系数
-    float Kd;                   // 微分系数
+    // PID 参数 (Q10 定点, 可通过蓝牙动态调整)
+    int32 Kp;                   // 比例系数 × 1024
+    int32 Ki;                   // 积分系数 × 1024
+    int32 Kd;                   // 微分系数 × 1024
     
     // 误差记录 (用于增量式PID)
     int16 error_now;            // 当前误差 e(k)
@@ -40,6 +59,7 @@ typedef struct
     // 输出
     int32 output;               // PID 输出值
     int32 output_max;           // 输出限幅值
+    int32 output_frac;          // 增量式输出的小数余量 (Q10, 避免小增量被截断丢失)
     
 } PID_Controller_t;
 
@@ -50,13 +70,13 @@ typedef struct
 /**
  * @brief   初始化 PID 控制器
  * @param   pid         PID控制器结构体指针
- * @param   kp          比例系数
- * @param   ki          积分系数
- * @param   kd          微分系数
+ * @param   kp          比例系数 (Q10, 可用 PID_GAIN_Q(1.5f) 生成)
+ * @param   ki          积分系数 (Q10)
+ * @param   kd          微分系数 (Q10)
  * @param   out_max     输出限幅值
  * @return  void
  */
-void PID_Init(PID_Controller_t *pid, float kp, float ki, float kd, int32 out_max);
+void PID_Init(PID_Controller_t *pid, int32 kp, int32 ki, int32 kd, int32 out_max);
 
 /**
  * @brief   增量式 PID 计算
@@ -93,12 +113,38 @@ void PID_Reset(PID_Controller_t *pid);
 /**
  * @brief   更新 PID 参数
  * @param   pid         PID控制器结构体指针
- * @param   kp          新的比例系数
- * @param   ki          新的积分系数
- * @param   kd          新的微分系数
+ * @param   kp          新的比例系数 (Q10)
+ * @param   ki          新的积分系数 (Q10)
+ * @param   kd          新的微分系数 (Q10)
+ * @return  void
+ * @note    超出 ±PID_GAIN_MAX (约 ±31.99) 的增益会被静默限幅
+ */
+void PID_SetParams(PID_Controller_t *pid, int32 kp, int32 ki, int32 kd);
+
+/**
+ * @brief   以 ×10 整数更新 PID 参数
+ * @param   pid         PID控制器结构体指针
+ * @param   kp_x10      Kp × 10 (例如 15 表示 1.5)
+ * @param   ki_x10      Ki × 10
+ * @param   kd_x10      Kd × 10
  * @return  void
- * @note    用于蓝牙实时调参
+ * @note    用于蓝牙实时调参, 与 BT_PIDCallback_t 的参数格式一致;
+ *          超过 ±PID_GAIN_MAX_X10 (31.9) 的值按上限生效 (例如 $P:50 实际 Kp ≈ 31.99), 不报错
+ */
+void PID_SetParamsX10(PID_Controller_t *pid, int16 kp_x10, int16 ki_x10, int16 kd_x10);
+
+/**
+ * @brief   ×10 整数 -> Q10 增益 (四舍五入)
+ * @param   value_x10   参数 × 10
+ * @return  int32       Q10 增益
+ */
+int32 PID_GainFromX10(int16 value_x10);
+
+/**
+ * @brief   Q10 增益 -> ×10 整数 (四舍五入)
+ * @param   gain        Q10 增益
+ * @return  int16       参数 × 10
  */
-void PID_SetParams(PID_Controller_t *pid, float kp, float ki, float kd);
+int16 PID_GainToX10(int32 gain);
 
 #endif // __PID_H__
@@ -0,0 +1,167 @@
+/*********************************************************************************************************************
+ * @file        pose.c
+ * @brief       飞檐走壁智能车 - 里程计位姿模块 (源文件)
+ * @details     编码器里程 + 陀螺仪航向 (差速航向修正漂移) 的定点航位推算
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-18
+ ********************************************************************************************************************/
+
+#include "pose.h"
+
+/*==================================================================================================================
+ *                                              全局变量
+ *==================================================================================================================*/
+
+PoseData_t g_pose;
+
+/*==================================================================================================================
+ *                                              私有变量
+ *==================================================================================================================*/
+
+// sin(0° ~ 90°), Q14 (16384 = 1.0)
+static const int16 code s_sin_table[91] = {
+        0,   286,   572,   857,  1143,  1428,  1713,  1997,  2280,  2563,
+     2845,  3126,  3406,  3686,  3964,  4240,  4516,  4790,  5063,  5334,
+     5604,  5872,  6138,  6402,  6664,  6924,  7182,  7438,  7692,  7943,
+     8192,  8438,  8682,  8923,  9162,  9397,  9630,  9860, 10087, 10311,
+    10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+    12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+    14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+    15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+    16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+    16384
+};
+
+static int32 s_x_um = 0;                // 位置 (μm)
+static int32 s_y_um = 0;
+static int32 s_dist_um_rem = 0;         // 里程不足 1mm 的余数 (μm)
+static int32 s_odo_num_rem = 0;         // 差速航向不足 0.01° 的余数 (分子)
+
+// 差速航向: 0.01° = (左 - 右) × μm/脉冲 × 5730 / 轮距μm
+#define POSE_ODO_DEN            ((int32)POSE_TRACK_WIDTH_MM * 1000)
+#define POSE_RAD_TO_CDEG        5730    // 1 rad = 5729.6 × 0.01°
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   整数度正弦
+ * @param   deg     角度 (度, 0 ~ 359)
+ * @return  int16   sin, Q14
+ */
+static int16 pose_sin(int16 deg)
+{
+    if (deg < 90)
+    {
+        return s_sin_table[deg];
+    }
+    if (deg < 180)
+    {
+        return s_sin_table[180 - deg];
+    }
+    if (deg < 270)
+    {
+        return -s_sin_table[deg - 180];
+    }
+    return -s_sin_table[360 - deg];
+}
+
+/*==================================================================================================================
+ *                                              对外接口
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化位姿模块
+ */
+void Pose_Init(void)
+{
+    Pose_Reset();
+    g_pose.distance_mm = 0;
+}
+
+/**
+ * @brief   位姿清零
+ * @note    累计里程不清零, 保持单调, 元素标记跨越发车也有效
+ */
+void Pose_Reset(void)
+{
+    s_x_um = 0;
+    s_y_um = 0;
+    s_odo_num_rem = 0;
+
+    g_pose.x_mm = 0;
+    g_pose.y_mm = 0;
+    g_pose.heading = 0;
+    g_pose.odo_heading = 0;
+    g_pose.yaw_rate = 0;
+}
+
+/**
+ * @brief   控制周期位姿更新
+ */
+void Pose_Update(int16 left_delta, int16 right_delta, int16 yaw_delta)
+{
+    int32 d_um;
+    int32 odo_delta;
+    int16 deg;
+
+    /*-------------------------------------------------
+     * Step 1: 里程
+     *-------------------------------------------------*/
+    d_um = ((int32)left_delta + right_delta) * POSE_UM_PER_COUNT / 2;
+    s_dist_um_rem += d_um;
+    g_pose.distance_mm += s_dist_um_rem / 1000;
+    s_dist_um_rem %= 1000;
+
+    /*-------------------------------------------------
+     * Step 2: 航向 (陀螺仪积分, 差速航向修正漂移)
+     *-------------------------------------------------*/
+    s_odo_num_rem += ((int32)left_delta - right_delta) * POSE_UM_PER_COUNT * POSE_RAD_TO_CDEG;
+    odo_delta = s_odo_num_rem / POSE_ODO_DEN;
+    s_odo_num_rem -= odo_delta * POSE_ODO_DEN;
+    g_pose.odo_heading += odo_delta;
+
+    g_pose.heading += yaw_delta;
+    g_pose.heading += (g_pose.odo_heading - g_pose.heading) >> POSE_ODO_WEIGHT_SHIFT;
+    g_pose.yaw_rate = (int16)((int32)yaw_delta * (1000 / CONTROL_PERIOD_MS) / 100);
+
+    /*-------------------------------------------------
+     * Step 3: 位置 (按航向分解里程)
+     *-------------------------------------------------*/
+    deg = (int16)(((g_pose.heading + 50) / 100) % 360);
+    if (deg < 0)
+    {
+        deg += 360;
+    }
+    s_x_um += (d_um * pose_sin((deg + 90) % 360)) >> 14;
+    s_y_um += (d_um * pose_sin(deg)) >> 14;
+    g_pose.x_mm = s_x_um / 1000;
+    g_pose.y_mm = s_y_um / 1000;
+}
+
+/**
+ * @brief   在当前位置打标记
+ */
+void Pose_SetMark(PoseMark_t *mark)
+{
+    mark->distance_mm = g_pose.distance_mm;
+    mark->heading = g_pose.heading;
+}
+
+/**
+ * @brief   标记之后走过的里程
+ */
+int32 Pose_DistanceSince(const PoseMark_t *mark)
+{
+    return g_pose.distance_mm - mark->distance_mm;
+}
+
+/**
+ * @brief   标记之后转过的角度
+ */
+int32 Pose_HeadingSince(const PoseMark_t *mark)
+{
+    return g_pose.heading - mark->heading;
+}
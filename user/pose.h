@@ -0,0 +1,105 @@
+/*********************************************************************************************************************
+ * @file        pose.h
+ * @brief       飞檐走壁智能车 - 里程计位姿模块 (头文件)
+ * @details     左右轮编码器增量 + 陀螺仪偏航角融合, 推算平面位姿 (x, y, 航向) 和累计里程, 全部定点运算
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-18
+ *
+ * @note        算法说明:
+ *              1. 里程: 左右轮增量平均 × POSE_UM_PER_COUNT, 余数累计, 长距离不丢精度
+ *              2. 航向: 以陀螺仪偏航增量为主 (姿态模块已扣除零偏);
+ *                 左右轮差速推算的航向每周期以 1/2^POSE_ODO_WEIGHT_SHIFT 的权重修正陀螺仪积分漂移
+ *              3. 位置: 按当前航向把本周期里程分解到 x/y (1° 分辨率正弦表)
+ *
+ *              坐标约定 (与姿态模块一致):
+ *              - 发车 (Pose_Reset) 时车头方向为 +x, 车身右侧为 +y
+ *              - 航向正 = 右转, 单位 0.01°, 连续累计不回绕 (转两圈 = 72000)
+ *
+ *              元素状态机等需要 "进入某处后走了多远/转了多少度" 时:
+ *                  PoseMark_t mark;
+ *                  Pose_SetMark(&mark);                  // 入口处记录
+ *                  ...
+ *                  if (Pose_DistanceSince(&mark) > 300)  // 之后每周期查询 (mm)
+ ********************************************************************************************************************/
+
+#ifndef __POSE_H__
+#define __POSE_H__
+
+#include "car_config.h"
+
+/*==================================================================================================================
+ *                                              位姿数据结构体
+ *==================================================================================================================*/
+
+/**
+ * @brief   位姿数据
+ */
+typedef struct
+{
+    int32 x_mm;                 // 位置 (mm), 发车方向为 +x
+    int32 y_mm;                 // 位置 (mm), 发车时车身右侧为 +y
+    int32 heading;              // 融合航向 (0.01°, 正 = 右转, 不回绕)
+    int32 odo_heading;          // 左右轮差速推算的航向 (0.01°, 仅供对比/标定)
+    int32 distance_mm;          // 累计里程 (mm, 倒车时减小)
+    int16 yaw_rate;             // 航向角速度 (°/s, 正 = 右转)
+} PoseData_t;
+
+/**
+ * @brief   位姿标记 (记录某一时刻的里程和航向)
+ */
+typedef struct
+{
+    int32 distance_mm;
+    int32 heading;
+} PoseMark_t;
+
+extern PoseData_t g_pose;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化位姿模块 (位姿清零)
+ * @return  void
+ */
+void Pose_Init(void);
+
+/**
+ * @brief   位姿清零 (发车时调用, 以当前位置和朝向为原点)
+ * @return  void
+ */
+void Pose_Reset(void);
+
+/**
+ * @brief   控制周期位姿更新 (在 System_Control 中, Attitude_Update 之后调用)
+ * @param   left_delta      本周期左轮编码器增量 (带方向)
+ * @param   right_delta     本周期右轮编码器增量 (带方向)
+ * @param   yaw_delta       本周期陀螺仪偏航角增量 (0.01°, 正 = 右转)
+ * @return  void
+ */
+void Pose_Update(int16 left_delta, int16 right_delta, int16 yaw_delta);
+
+/**
+ * @brief   在当前位置打标记
+ * @param   mark    标记
+ * @return  void
+ */
+void Pose_SetMark(PoseMark_t *mark);
+
+/**
+ * @brief   标记之后走过的里程
+ * @param   mark    标记
+ * @return  int32   里程 (mm)
+ */
+int32 Pose_DistanceSince(const PoseMark_t *mark);
+
+/**
+ * @brief   标记之后转过的角度
+ * @param   mark    标记
+ * @return  int32   角度 (0.01°, 正 = 右转)
+ */
+int32 Pose_HeadingSince(const PoseMark_t *mark);
+
+#endif // __POSE_H__
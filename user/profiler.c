@@ -0,0 +1,322 @@
+/*********************************************************************************************************************
+ * @file        profiler.c
+ * @brief       飞檐走壁智能车 - 控制周期分段耗时统计模块 (源文件)
+ * @details     基于 TIM2 计数器的分段计时, 统计 min/max/mean 和超时次数
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-13
+ ********************************************************************************************************************/
+
+#include "profiler.h"
+#include "bluetooth.h"
+
+/*==================================================================================================================
+ *                                              全局变量
+ *==================================================================================================================*/
+
+ProfilerData_t g_profiler;
+
+static uint16 s_reload = 0;             // TIM2 重装值 (周期起点计数)
+static uint16 s_last_stamp = 0;         // 上一次打点时的计数
+
+// 测不到回绕时使用的默认周期计数 (按 12T 分频估算)
+#define PROFILER_DEFAULT_PERIOD_TICKS   ((uint16)(SYSTEM_CLOCK_FREQ / 12 / 1000 * CONTROL_PERIOD_MS))
+
+// 阶段名称 (用于蓝牙报告和 OLED)
+static const char code s_stage_name[PROF_STAGE_NUM][4] = {
+    "ENT", "ENC", "IND", "IMU", "ELM", "PID", "MOT", "FAN", "TOT"
+};
+
+/*==================================================================================================================
+ *                                              定时器读取
+ *==================================================================================================================*/
+
+#ifndef CAR_HOST_BUILD
+
+/**
+ * @brief   读取 TIM2 计数器 (高字节前后两次一致才算有效, 防止读到进位中间态)
+ */
+static uint16 profiler_read_counter(void)
+{
+    uint8 high, low;
+
+    do
+    {
+        high = T2H;
+        low  = T2L;
+    } while (high != T2H);
+
+    return ((uint16)high << 8) | low;
+}
+
+#define PROFILER_NEXT_PERIOD_PENDING()  (AUXINTIF & 0x01)      // T2IF: 下一周期的中断已经到来
+
+#else
+
+static uint16 s_mock_counter = 0;
+static uint8  s_mock_overrun = 0;
+
+static uint16 profiler_read_counter(void)
+{
+    return s_mock_counter;
+}
+
+#define PROFILER_NEXT_PERIOD_PENDING()  (s_mock_overrun)
+
+void Profiler_MockSetCounter(uint16 ticks)
+{
+    s_mock_counter = ticks;
+}
+
+void Profiler_MockSetOverrun(uint8 pending)
+{
+    s_mock_overrun = pending;
+}
+
+#endif
+
+/*==================================================================================================================
+ *                                              统计累加
+ *==================================================================================================================*/
+
+/**
+ * @brief   记录一次阶段耗时
+ */
+static void profiler_record(ProfilerStat_t *stat, uint16 ticks)
+{
+    stat->last = ticks;
+    if (stat->count == 0 || ticks < stat->min)
+    {
+        stat->min = ticks;
+    }
+    if (ticks > stat->max)
+    {
+        stat->max = ticks;
+    }
+
+    // 计数将满时减半, 平均值保持不变, 相当于逐渐淡化早期数据
+    if (stat->count == 0xFFFF)
+    {
+        stat->sum   >>= 1;
+        stat->count >>= 1;
+    }
+    stat->sum += ticks;
+    stat->count++;
+}
+
+/*==================================================================================================================
+ *                                              初始化
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化统计模块并测量定时器重装值
+ */
+void Profiler_Init(void)
+{
+#ifndef CAR_HOST_BUILD
+    uint16 prev, now;
+    uint16 guard;
+
+    // 等待计数器回绕: 回绕后读到的第一个值即 (近似) 重装值
+    s_reload = (uint16)(0 - PROFILER_DEFAULT_PERIOD_TICKS);
+    prev = profiler_read_counter();
+    for (guard = 0; guard < 60000; guard++)
+    {
+        now = profiler_read_counter();
+        if (now < prev)
+        {
+            s_reload = now;
+            break;
+        }
+        prev = now;
+    }
+    g_profiler.period_ticks = (uint16)(0 - s_reload);
+#else
+    s_reload = 0;
+    g_profiler.period_ticks = CONTROL_PERIOD_MS * 1000;
+#endif
+
+    Profiler_Reset();
+}
+
+/**
+ * @brief   清零全部统计
+ */
+void Profiler_Reset(void)
+{
+    uint8 i;
+
+    interrupt_global_disable();
+    for (i = 0; i < PROF_STAGE_NUM; i++)
+    {
+        g_profiler.stage[i].last  = 0;
+        g_profiler.stage[i].min   = 0;
+        g_profiler.stage[i].max   = 0;
+        g_profiler.stage[i].count = 0;
+        g_profiler.stage[i].sum   = 0;
+    }
+    g_profiler.overrun = 0;
+    interrupt_global_enable();
+}
+
+/*==================================================================================================================
+ *                                              打点
+ *==================================================================================================================*/
+
+/**
+ * @brief   控制任务开始打点
+ */
+void Profiler_Begin(void)
+{
+    s_last_stamp = profiler_read_counter();
+    profiler_record(&g_profiler.stage[PROF_STAGE_ENTRY], (uint16)(s_last_stamp - s_reload));
+}
+
+/**
+ * @brief   阶段结束打点
+ */
+void Profiler_Mark(ProfilerStage_t stage)
+{
+    uint16 now = profiler_read_counter();
+
+    profiler_record(&g_profiler.stage[stage], (uint16)(now - s_last_stamp));
+    s_last_stamp = now;
+}
+
+/**
+ * @brief   控制任务结束打点
+ */
+void Profiler_End(void)
+{
+    uint16 now = profiler_read_counter();
+
+    profiler_record(&g_profiler.stage[PROF_STAGE_TOTAL], (uint16)(now - s_reload));
+
+    // 计数器已经再次溢出, 本周期的测量值不可信, 只计超时次数
+    if (PROFILER_NEXT_PERIOD_PENDING())
+    {
+        g_profiler.overrun++;
+    }
+}
+
+/*==================================================================================================================
+ *                                              结果读取
+ *==================================================================================================================*/
+
+/**
+ * @brief   定时器计数 -> 微秒
+ */
+uint16 Profiler_TicksToUs(uint32 ticks)
+{
+    uint32 us;
+
+    if (g_profiler.period_ticks == 0)
+    {
+        return 0;
+    }
+
+    us = ticks * (CONTROL_PERIOD_MS * 1000UL) / g_profiler.period_ticks;
+    return (us > 0xFFFF) ? 0xFFFF : (uint16)us;
+}
+
+/**
+ * @brief   获取某阶段平均耗时
+ */
+uint16 Profiler_GetMeanUs(ProfilerStage_t stage)
+{
+    uint32 sum;
+    uint16 count;
+
+    interrupt_global_disable();
+    sum   = g_profiler.stage[stage].sum;
+    count = g_profiler.stage[stage].count;
+    interrupt_global_enable();
+
+    return (count == 0) ? 0 : Profiler_TicksToUs(sum / count);
+}
+
+/**
+ * @brief   获取某阶段最大耗时
+ */
+uint16 Profiler_GetMaxUs(ProfilerStage_t stage)
+{
+    return Profiler_TicksToUs(g_profiler.stage[stage].max);
+}
+
+/**
+ * @brief   获取平均耗时最长的阶段
+ */
+ProfilerStage_t Profiler_GetSlowestStage(void)
+{
+    uint8 i;
+    uint8 slowest = PROF_STAGE_ENTRY;
+    uint16 mean, slowest_mean = 0;
+
+    for (i = 0; i < PROF_STAGE_TOTAL; i++)
+    {
+        mean = Profiler_GetMeanUs((ProfilerStage_t)i);
+        if (mean > slowest_mean)
+        {
+            slowest_mean = mean;
+            slowest = i;
+        }
+    }
+    return (ProfilerStage_t)slowest;
+}
+
+/**
+ * @brief   获取阶段名称
+ */
+const char *Profiler_GetStageName(ProfilerStage_t stage)
+{
+    return s_stage_name[stage];
+}
+
+/*==================================================================================================================
+ *                                              蓝牙报告
+ *==================================================================================================================*/
+
+/**
+ * @brief   通过蓝牙发送统计报告
+ */
+void Profiler_SendReport(void)
+{
+    char line[32];
+    char *p;
+    uint8 i;
+
+    for (i = 0; i < PROF_STAGE_NUM; i++)
+    {
+        p = line;
+        *p++ = s_stage_name[i][0];
+        *p++ = s_stage_name[i][1];
+        *p++ = s_stage_name[i][2];
+        *p++ = ' ';
+        p = Bluetooth_AppendInt(p, Profiler_TicksToUs(g_profiler.stage[i].min));
+        *p++ = ' ';
+        p = Bluetooth_AppendInt(p, Profiler_GetMeanUs((ProfilerStage_t)i));
+        *p++ = ' ';
+        p = Bluetooth_AppendInt(p, Profiler_TicksToUs(g_profiler.stage[i].max));
+        *p++ = '\r';
+        *p++ = '\n';
+        *p   = '\0';
+        Bluetooth_SendString(line);
+    }
+
+    p = line;
+    *p++ = 'O';
+    *p++ = 'V';
+    *p++ = 'R';
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_profiler.overrun);
+    *p++ = ' ';
+    *p++ = 'P';
+    *p++ = 'E';
+    *p++ = 'R';
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, Profiler_TicksToUs(g_profiler.period_ticks));
+    *p++ = '\r';
+    *p++ = '\n';
+    *p   = '\0';
+    Bluetooth_SendString(line);
+}
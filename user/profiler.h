@@ -0,0 +1,171 @@
+/*********************************************************************************************************************
+ * @file        profiler.h
+ * @brief       飞檐走壁智能车 - 控制周期分段耗时统计模块 (头文件)
+ * @details     在 System_Control 各阶段之间打时间戳, 统计每段的最小/最大/平均耗时和超时次数
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-13
+ *
+ * @note        时间基准:
+ *              直接读取 5ms 定时中断所用 TIM2 的计数器 (T2H/T2L), 不占用额外定时器
+ *              计数器从重装值向上计到 0xFFFF 溢出产生中断, 因此 "当前计数 - 重装值" 就是本周期已用时间
+ *              重装值在 Profiler_Init 中通过观察一次回绕测得, 与 pit_ms_init 的分频配置无关
+ *
+ *              超时判定: 控制任务结束时 TIM2 中断标志已再次置位, 说明本周期耗时超过 CONTROL_PERIOD_MS
+ *
+ *              主机仿真 (CAR_HOST_BUILD) 使用可手动设置的模拟计数器, 便于验证统计逻辑
+ ********************************************************************************************************************/
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include "car_config.h"
+
+/*==================================================================================================================
+ *                                              统计阶段
+ *==================================================================================================================*/
+
+/**
+ * @brief   System_Control 中被统计的阶段
+ * @note    每个阶段的耗时 = 本次 Profiler_Mark 与上一次打点之间的时间
+ */
+typedef enum
+{
+    PROF_STAGE_ENTRY = 0,       // 周期开始 -> Profiler_Begin (中断响应 + 按键扫描)
+    PROF_STAGE_ENCODER,         // Encoder_Update
+    PROF_STAGE_INDUCTOR,        // Inductor_Update
+    PROF_STAGE_IMU,             // IMU 读取 + 姿态计算
+    PROF_STAGE_ELEMENT,         // Element_Update
+    PROF_STAGE_PID,             // 方向环 + 两个速度环
+    PROF_STAGE_MOTOR,           // Motor_SetSpeed
+    PROF_STAGE_FAN,             // Fan_AutoAdjust
+    PROF_STAGE_TOTAL,           // 周期开始 -> Profiler_End
+    PROF_STAGE_NUM
+} ProfilerStage_t;
+
+/**
+ * @brief   单个阶段的统计值 (单位: 定时器计数)
+ */
+typedef struct
+{
+    uint16 last;                // 最近一次耗时
+    uint16 min;                 // 最小耗时
+    uint16 max;                 // 最大耗时
+    uint16 count;               // 统计次数
+    uint32 sum;                 // 耗时累计 (用于求平均)
+} ProfilerStat_t;
+
+/**
+ * @brief   分段统计数据
+ */
+typedef struct
+{
+    ProfilerStat_t stage[PROF_STAGE_NUM];
+    uint16 overrun;             // 超过控制周期的次数
+    uint16 period_ticks;        // 一个控制周期对应的定时器计数
+} ProfilerData_t;
+
+extern ProfilerData_t g_profiler;
+
+/*==================================================================================================================
+ *                                              打点宏
+ *==================================================================================================================*/
+
+// PROFILER_ENABLE = 0 时打点全部编译为空, 不占用控制中断时间
+#if PROFILER_ENABLE
+    #define PROFILER_BEGIN()        Profiler_Begin()
+    #define PROFILER_MARK(stage)    Profiler_Mark(stage)
+    #define PROFILER_END()          Profiler_End()
+#else
+    #define PROFILER_BEGIN()
+    #define PROFILER_MARK(stage)
+    #define PROFILER_END()
+#endif
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化统计模块并测量定时器重装值
+ * @note    需在 pit_ms_init 之后调用, 最多等待一个控制周期
+ * @return  void
+ */
+void Profiler_Init(void);
+
+/**
+ * @brief   清零全部统计
+ * @return  void
+ */
+void Profiler_Reset(void);
+
+/**
+ * @brief   控制任务开始打点 (记录 PROF_STAGE_ENTRY)
+ * @return  void
+ */
+void Profiler_Begin(void);
+
+/**
+ * @brief   阶段结束打点
+ * @param   stage   刚结束的阶段
+ * @return  void
+ */
+void Profiler_Mark(ProfilerStage_t stage);
+
+/**
+ * @brief   控制任务结束打点 (记录 PROF_STAGE_TOTAL 并检测超时)
+ * @return  void
+ */
+void Profiler_End(void);
+
+/**
+ * @brief   定时器计数 -> 微秒
+ * @param   ticks   定时器计数
+ * @return  uint16  微秒
+ */
+uint16 Profiler_TicksToUs(uint32 ticks);
+
+/**
+ * @brief   获取某阶段平均耗时
+ * @return  uint16  微秒
+ */
+uint16 Profiler_GetMeanUs(ProfilerStage_t stage);
+
+/**
+ * @brief   获取某阶段最大耗时
+ * @return  uint16  微秒
+ */
+uint16 Profiler_GetMaxUs(ProfilerStage_t stage);
+
+/**
+ * @brief   获取平均耗时最长的阶段 (不含 TOTAL)
+ * @return  ProfilerStage_t
+ */
+ProfilerStage_t Profiler_GetSlowestStage(void);
+
+/**
+ * @brief   获取阶段名称 (3 个字符)
+ * @return  const char*
+ */
+const char *Profiler_GetStageName(ProfilerStage_t stage);
+
+/**
+ * @brief   通过蓝牙发送统计报告
+ * @details 每个阶段一行: "ENC min avg max\r\n" (微秒), 最后一行 "OVR n PER us\r\n"
+ * @return  void
+ */
+void Profiler_SendReport(void);
+
+#ifdef CAR_HOST_BUILD
+/**
+ * @brief   主机仿真: 设置模拟计数器 (重装值为 0, 1 计数 = 1us)
+ */
+void Profiler_MockSetCounter(uint16 ticks);
+
+/**
+ * @brief   主机仿真: 设置模拟的 "下一周期中断已到" 标志
+ */
+void Profiler_MockSetOverrun(uint8 pending);
+#endif
+
+#endif // __PROFILER_H__
@@ -0,0 +1,175 @@
+/*********************************************************************************************************************
+ * @file        speed_ctrl.c
+ * @brief       飞檐走壁智能车 - 单轮速度控制模块 (源文件)
+ * @details     静态模型前馈 + 位置式 PI(D) + 条件积分 + 变化率限制, 全部 Q10 定点
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-24
+ ********************************************************************************************************************/
+
+#include "speed_ctrl.h"
+#include "key.h"            // 运行模式对应的电机限幅
+#include "battery.h"        // 电压补偿倍率
+
+/*==================================================================================================================
+ *                                              全局变量
+ *==================================================================================================================*/
+
+SpeedCtrl_t g_speed_ctrl[2];
+
+SpeedCtrlParam_t g_speed_ctrl_param = {
+    SPEED_FF_DUTY_X100,
+    SPEED_FF_STATIC_DUTY,
+    SPEED_SLEW_MAX
+};
+
+/*==================================================================================================================
+ *                                              私有变量
+ *==================================================================================================================*/
+
+#define SPEED_FF_GAIN_MAX       0x3FFFFL        // 前馈增益上限 (Q12, 约 64), 保证 增益 × MOTOR_SPEED_MAX < 2^31
+#define SPEED_TERM_MAX          ((int32)PID_SPEED_OUT_MAX * 2 << PID_Q_SHIFT)     // 单项限幅 (Q10), 求和不溢出
+
+static int32 s_ff_gain = 0;                         // 前馈增益: 每单位速度占空比 (Q12)
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   限幅到 ±limit
+ */
+static int32 speed_clamp(int32 value, int32 limit)
+{
+    if (value > limit)  return limit;
+    if (value < -limit) return -limit;
+    return value;
+}
+
+/**
+ * @brief   重算前馈增益 (主循环)
+ */
+static void speed_ctrl_update_gain(void)
+{
+    int32 gain;
+
+    gain = ((int32)g_speed_ctrl_param.ff_duty_x100 << 12) / 100;
+    gain = speed_clamp(gain, SPEED_FF_GAIN_MAX);
+
+    interrupt_global_disable();
+    s_ff_gain = gain;
+    interrupt_global_enable();
+}
+
+/*==================================================================================================================
+ *                                              对外接口
+ *==================================================================================================================*/
+
+/**
+ * @brief   复位两轮控制状态
+ */
+void SpeedCtrl_Reset(void)
+{
+    uint8 i;
+
+    for (i = 0; i < 2; i++)
+    {
+        g_speed_ctrl[i].integral = 0;
+        g_speed_ctrl[i].model = 0;
+        g_speed_ctrl[i].error_last = 0;
+        g_speed_ctrl[i].feedforward = 0;
+        g_speed_ctrl[i].output = 0;
+        g_speed_ctrl[i].saturated = 0;
+    }
+    speed_ctrl_update_gain();
+}
+
+/**
+ * @brief   前馈参数修改后重算
+ */
+void SpeedCtrl_ParamChanged(void)
+{
+    speed_ctrl_update_gain();
+}
+
+/**
+ * @brief   单轮速度控制计算
+ */
+int16 SpeedCtrl_Update(uint8 wheel, const PID_Controller_t *gain, int16 target, int16 feedback)
+{
+    SpeedCtrl_t *ctrl = &g_speed_ctrl[wheel];
+    int32 out_max;
+    int32 motor_max;
+    int32 error;
+    int32 ff;
+    int32 i_step;
+    int32 sum_q;
+    int32 output;
+    int32 lower, upper;
+
+    error = LIMIT_RANGE((int32)target - feedback, -32767L, 32767L);
+
+    // 输出是标称电压下的占空比, Motor_SetSingle 再乘补偿倍率并按运行模式限幅;
+    // 把那道限幅折算回标称占空比, 否则低电压时补偿后被电机截断, 这里却不知道已饱和, 积分继续累积
+    out_max = gain->output_max;
+    motor_max = ((int32)GET_SPEED_LIMIT() * Battery_GetCompInverse()) >> 12;
+    if (out_max > motor_max) out_max = motor_max;
+
+    /*-------------------------------------------------
+     * Step 1: 前馈 (静态模型, 标称电压下的占空比, 电压补偿在电机输出中完成)
+     *-------------------------------------------------*/
+    ff = LIMIT_RANGE((int32)target, -(int32)MOTOR_SPEED_MAX, (int32)MOTOR_SPEED_MAX);
+    ff = (ff * s_ff_gain) >> 12;
+    if (target > 0)
+    {
+        ff += g_speed_ctrl_param.ff_static;
+    }
+    else if (target < 0)
+    {
+        ff -= g_speed_ctrl_param.ff_static;
+    }
+    ff = speed_clamp(ff, out_max);
+    ctrl->feedforward = (int16)ff;
+
+    /*-------------------------------------------------
+     * Step 2: 反馈 (Q10 求和, 积分先按本周期误差试算)
+     *-------------------------------------------------*/
+    // 积分跟踪的是 "按电机时间常数应有的速度" 而不是目标速度: 加减速过程中电机本来就跟不上,
+    // 这部分滞后不计入积分 (否则出弯加速后超调); 负载 (上墙重力) 造成的持续偏差照常积分消除
+    ctrl->model += (((int32)target << 8) - ctrl->model) >> SPEED_MODEL_SHIFT;
+    i_step = gain->Ki * LIMIT_RANGE((ctrl->model >> 8) - feedback, -32767L, 32767L);
+    sum_q  = ff << PID_Q_SHIFT;
+    sum_q += speed_clamp(gain->Kp * error, SPEED_TERM_MAX);
+    sum_q += speed_clamp(gain->Kd * (error - ctrl->error_last), SPEED_TERM_MAX);
+    sum_q += ctrl->integral + i_step;
+    ctrl->error_last = (int16)error;
+
+    output = (sum_q + (PID_Q_ONE / 2)) >> PID_Q_SHIFT;
+
+    /*-------------------------------------------------
+     * Step 3: 限幅 + 变化率限制, 受限时条件积分
+     *-------------------------------------------------*/
+    lower = ctrl->output - g_speed_ctrl_param.slew;
+    upper = ctrl->output + g_speed_ctrl_param.slew;
+    if (lower < -out_max) lower = -out_max;
+    if (upper > out_max)  upper = out_max;
+
+    ctrl->saturated = 0;
+    if (output > upper)
+    {
+        output = upper;
+        ctrl->saturated = 1;
+        if (i_step > 0) i_step = 0;         // 误差还在往上推: 冻结积分
+    }
+    else if (output < lower)
+    {
+        output = lower;
+        ctrl->saturated = 1;
+        if (i_step < 0) i_step = 0;
+    }
+
+    ctrl->integral = speed_clamp(ctrl->integral + i_step, out_max << PID_Q_SHIFT);
+    ctrl->output = (int16)output;
+
+    return ctrl->output;
+}
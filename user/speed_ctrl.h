@@ -0,0 +1,93 @@
+/*********************************************************************************************************************
+ * @file        speed_ctrl.h
+ * @brief       飞檐走壁智能车 - 单轮速度控制模块 (头文件)
+ * @details     电机静态模型前馈 + PI(D) 反馈 + 条件积分抗饱和 + PWM 变化率限制, 替代增量式速度环
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-24
+ *
+ * @note        输出 = 前馈 + Kp×e + 积分 + Kd×Δe, 增益取自 g_system.pid_speed_left/right (蓝牙 $SET:spd_kp 等)
+ *
+ *              - 前馈: 稳态时占空比 ≈ 目标速度 × 每单位速度占空比 (+ 起步占空比),
+ *                      反馈只需修正模型误差和负载 (上墙重力), 出弯加速不用等积分累积;
+ *                      输出是标称电压下的占空比, 电池电压补偿在 Motor_SetSingle 中统一完成
+ *              - 抗饱和: 输出已到限幅 (或被变化率限制卡住) 且误差还在往同一方向推时, 积分停止累积;
+ *                        原增量式 PID 在限幅期间 output 仍被反复推到边界, 退出饱和后要很久才能回来;
+                        限幅取 output_max 与 "电机限幅 ÷ 补偿倍率" 中的较小者, 电压补偿后被截断也算饱和
+ *              - 积分对象: 目标速度经一阶参考模型 (时间常数 2^SPEED_MODEL_SHIFT 个周期) 后与实际速度的差,
+ *                        加速过程中的正常滞后不进积分, 出弯加速不超调; 负载造成的持续偏差照常消除
+ *              - 变化率限制: 每个控制周期占空比变化不超过 SPEED_SLEW_MAX, 避免阶跃目标导致的冲击和打滑
+ *
+ *              前馈系数标定: 架空车轮, 以几档固定占空比开环运行, 记录稳定后的编码器速度,
+ *              每单位速度占空比 = 占空比 / 速度 (标称电压下), 起步占空比 = 车轮刚好转动时的占空比;
+ *              可用 $SET:spd_ff / $SET:spd_st 在线修改
+ ********************************************************************************************************************/
+
+#ifndef __SPEED_CTRL_H__
+#define __SPEED_CTRL_H__
+
+#include "car_config.h"
+#include "pid.h"
+
+/*==================================================================================================================
+ *                                              数据结构
+ *==================================================================================================================*/
+
+#define SPEED_CTRL_LEFT         0
+#define SPEED_CTRL_RIGHT        1
+
+/**
+ * @brief   单轮速度控制状态 (调试可读)
+ */
+typedef struct
+{
+    int32 integral;             // 积分项 (Q10 占空比)
+    int32 model;                // 参考模型速度 (Q8, 目标速度经电机时间常数一阶滞后)
+    int16 error_last;           // 上次误差 (微分用)
+    int16 feedforward;          // 本周期前馈占空比
+    int16 output;               // 本周期输出占空比 (已限幅、已限制变化率)
+    uint8 saturated;            // 1 = 本周期输出受限 (积分已冻结)
+} SpeedCtrl_t;
+
+extern SpeedCtrl_t g_speed_ctrl[2];
+
+/**
+ * @brief   速度控制可调参数 (默认值为 car_config.h 中的宏定义, 可由蓝牙 $SET 在线修改, 见 param_registry.h)
+ */
+typedef struct
+{
+    int16 ff_duty_x100;         // 每单位速度占空比 ×100 (SPEED_FF_DUTY_X100)
+    int16 ff_static;            // 起步占空比 (SPEED_FF_STATIC_DUTY)
+    int16 slew;                 // 每周期占空比最大变化 (SPEED_SLEW_MAX)
+} SpeedCtrlParam_t;
+
+extern SpeedCtrlParam_t g_speed_ctrl_param;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   复位两轮控制状态并计算前馈增益 (初始化、发车时调用)
+ * @return  void
+ */
+void SpeedCtrl_Reset(void);
+
+/**
+ * @brief   前馈参数修改后重算 (由参数表模块调用)
+ * @return  void
+ */
+void SpeedCtrl_ParamChanged(void);
+
+/**
+ * @brief   单轮速度控制计算
+ * @param   wheel       SPEED_CTRL_LEFT / SPEED_CTRL_RIGHT
+ * @param   gain        增益与输出限幅 (只读 Kp/Ki/Kd/output_max)
+ * @param   target      目标速度 (编码器脉冲/周期)
+ * @param   feedback    实际速度
+ * @return  int16       电机占空比 (标称电压下, ±min(output_max, 电机限幅 ÷ 补偿倍率))
+ * @note    在控制中断中调用, 没有除法
+ */
+int16 SpeedCtrl_Update(uint8 wheel, const PID_Controller_t *gain, int16 target, int16 feedback);
+
+#endif // __SPEED_CTRL_H__
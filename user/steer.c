@@ -0,0 +1,142 @@
+/*********************************************************************************************************************
+ * @file        steer.c
+ * @brief       飞檐走壁智能车 - 串级转向控制模块 (源文件)
+ * @details     外环方向 PID + 陀螺仪角速度内环 + 曲率前馈
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-19
+ ********************************************************************************************************************/
+
+#include "steer.h"
+
+/*==================================================================================================================
+ *                                              全局变量
+ *==================================================================================================================*/
+
+SteerData_t g_steer;
+
+SteerParam_t g_steer_param = {
+    STEER_RATE_KP_X100,
+    STEER_FF_GAIN
+};
+
+/*==================================================================================================================
+ *                                              私有变量
+ *==================================================================================================================*/
+
+#define STEER_GAIN_SHIFT        14              // 前馈/内环增益定点位数 (Q14)
+
+static int16 s_error_history[STEER_FF_WINDOW];     // 偏差历史 (环形缓冲区)
+static uint8 s_history_index = 0;
+
+static int32 s_ff_gain = 0;                         // 曲率前馈: ff_gain / 10000 (Q14)
+static int32 s_rate_gain = 0;                       // 内环: rate_kp_x100 / (100 × STEER_GYRO_PER_OUTPUT) (Q14)
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   重算定点增益 (主循环), 控制中断中只做乘法和移位
+ * @note    前馈: |趋势 × 基础速度| ≤ 200 × MOTOR_SPEED_MAX, 乘 Q14 增益 (ff_gain ≤ 500 时 ≤ 819) 不溢出;
+ *          内环: |期望 - 实际角速度| ≤ PID_DIRECTION_OUT_MAX × STEER_GYRO_PER_OUTPUT + 32768,
+ *          乘 Q14 增益 (rate_kp_x100 ≤ 1000 时约 1354) 不溢出
+ */
+static void steer_update_gain(void)
+{
+    int32 ff_gain;
+    int32 rate_gain;
+
+    ff_gain = (((int32)g_steer_param.ff_gain << STEER_GAIN_SHIFT) + 5000) / 10000;
+    rate_gain = (((int32)g_steer_param.rate_kp_x100 << STEER_GAIN_SHIFT) + 50L * STEER_GYRO_PER_OUTPUT)
+              / (100L * STEER_GYRO_PER_OUTPUT);
+
+    interrupt_global_disable();
+    s_ff_gain = ff_gain;
+    s_rate_gain = rate_gain;
+    interrupt_global_enable();
+}
+
+/*==================================================================================================================
+ *                                              对外接口
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化 / 复位
+ */
+void Steer_Reset(void)
+{
+    uint8 i;
+
+    for (i = 0; i < STEER_FF_WINDOW; i++)
+    {
+        s_error_history[i] = 0;
+    }
+    s_history_index = 0;
+
+    g_steer.outer_output = 0;
+    g_steer.feedforward = 0;
+    g_steer.rate_target = 0;
+    g_steer.rate_feedback = 0;
+    g_steer.output = 0;
+    steer_update_gain();
+}
+
+/**
+ * @brief   可调参数修改后重算
+ */
+void Steer_ParamChanged(void)
+{
+    steer_update_gain();
+}
+
+/**
+ * @brief   转向控制计算
+ */
+int16 Steer_Update(PID_Controller_t *outer, int16 error, int16 offset, int16 gyro_z, int16 base_speed)
+{
+    int32 u;
+    int32 trend;
+    int32 output;
+
+    /*-------------------------------------------------
+     * Step 1: 外环 (偏差 -> 差速) + 元素偏置
+     *-------------------------------------------------*/
+    // 符号由 STEER_ERROR_SIGN 决定 (见 car_config.h), 曲率前馈的趋势使用同一符号:
+    // 1 时以 error 为 "目标", 0 为 "反馈"; -1 时相反 (原代码)
+    // 车上确认: 架空车轮, 导线放在传感器左侧, error 应为负且左轮目标速度低于右轮
+#if STEER_ERROR_SIGN < 0
+    error = (int16)(-error);
+#endif
+    u = PID_Positional(outer, error, 0) + offset;
+
+    /*-------------------------------------------------
+     * Step 2: 曲率前馈 (偏差在窗口内持续朝一侧增大 = 前方在转弯)
+     *-------------------------------------------------*/
+    trend = (int32)error - s_error_history[s_history_index];
+    s_error_history[s_history_index] = error;
+    s_history_index = (s_history_index + 1 < STEER_FF_WINDOW) ? (s_history_index + 1) : 0;
+
+    g_steer.feedforward = (int16)((trend * base_speed * s_ff_gain) >> STEER_GAIN_SHIFT);
+#if STEER_CASCADE_ENABLE
+    u += g_steer.feedforward;
+#endif
+    u = LIMIT_RANGE(u, -PID_DIRECTION_OUT_MAX, PID_DIRECTION_OUT_MAX);
+    g_steer.outer_output = (int16)u;
+
+    /*-------------------------------------------------
+     * Step 3: 内环 (期望角速度跟踪)
+     *-------------------------------------------------*/
+    g_steer.rate_target = u * STEER_GYRO_PER_OUTPUT;
+    g_steer.rate_feedback = gyro_z;
+
+#if STEER_CASCADE_ENABLE
+    output = u + (((g_steer.rate_target - gyro_z) * s_rate_gain) >> STEER_GAIN_SHIFT);
+#else
+    output = u;
+#endif
+
+    output = LIMIT_RANGE(output, -PID_DIRECTION_OUT_MAX, PID_DIRECTION_OUT_MAX);
+    g_steer.output = (int16)output;
+    return g_steer.output;
+}
@@ -0,0 +1,89 @@
+/*********************************************************************************************************************
+ * @file        steer.h
+ * @brief       飞檐走壁智能车 - 串级转向控制模块 (头文件)
+ * @details     外环: 电感偏差 -> 期望偏航角速度; 内环: 陀螺仪角速度跟踪; 另加偏差趋势的曲率前馈
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-19
+ *
+ * @note        结构:
+ *
+ *              error ──> [方向环 PID (外环)] ──+── u ──> rate_target = u × STEER_GYRO_PER_OUTPUT
+ *                        元素偏置 ────────────┤                │
+ *                        曲率前馈 ────────────┘                v
+ *                                             output = u + Kr × (rate_target - gyro_z) / STEER_GYRO_PER_OUTPUT
+ *
+ *              - 外环仍是 pid_direction (蓝牙 P/I/D、元素增益表不变), 输出单位仍是差速;
+ *                差速 u 按运动学换算成期望角速度 (u 个单位差速对应的陀螺仪原始值)
+ *              - 内环按角速度误差补偿差速: 车身转得比期望慢 (打滑、速度环滞后) 就多给, 转得快就收,
+ *                相当于用陀螺仪给方向环加阻尼, 不依赖电感偏差的微分
+ *              - 曲率前馈: 最近 STEER_FF_WINDOW 个周期的偏差变化量 × 基础速度, 弯道入口提前给差速
+ *
+ *              STEER_CASCADE_ENABLE = 0 时 output = 外环输出 + 元素偏置 (与原单环一致)
+ *              内环等效为 output = u × (1 + Kr) - Kr × gyro_z / STEER_GYRO_PER_OUTPUT: 对外环和元素偏置的
+ *              瞬时响应放大 (1 + Kr) 倍, 且要求 gyro_z 与差速同号 (右转为正), 符号反了就是正反馈
+ ********************************************************************************************************************/
+
+#ifndef __STEER_H__
+#define __STEER_H__
+
+#include "car_config.h"
+#include "pid.h"
+
+/*==================================================================================================================
+ *                                              数据结构
+ *==================================================================================================================*/
+
+/**
+ * @brief   转向控制调试数据
+ */
+typedef struct
+{
+    int16 outer_output;         // 外环输出 + 元素偏置 + 前馈 (差速)
+    int16 feedforward;          // 曲率前馈 (差速, 关闭串级时只计算不叠加)
+    int32 rate_target;          // 期望角速度 (陀螺仪原始值)
+    int16 rate_feedback;        // 实际角速度 (陀螺仪原始值, 已扣除零偏)
+    int16 output;               // 最终差速输出
+} SteerData_t;
+
+extern SteerData_t g_steer;
+
+/**
+ * @brief   转向可调参数 (默认值为 car_config.h 中的宏定义, 可由蓝牙 $SET 在线修改, 见 param_registry.h)
+ */
+typedef struct
+{
+    int16 rate_kp_x100;         // 内环比例 ×100 (STEER_RATE_KP_X100)
+    int16 ff_gain;              // 曲率前馈增益 (STEER_FF_GAIN)
+} SteerParam_t;
+
+extern SteerParam_t g_steer_param;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化 / 复位 (清空偏差历史)
+ * @return  void
+ */
+void Steer_Reset(void);
+
+/**
+ * @brief   内环比例、前馈增益修改后重算定点增益 (由参数表模块调用)
+ * @return  void
+ */
+void Steer_ParamChanged(void);
+
+/**
+ * @brief   转向控制计算 (在 System_Control 中调用)
+ * @param   outer           外环 PID (pid_direction)
+ * @param   error           电感偏差 (-100 ~ +100)
+ * @param   offset          元素偏置 (差速)
+ * @param   gyro_z          陀螺仪 Z 轴角速度 (原始值, 已扣除零偏, 正 = 右转)
+ * @param   base_speed      基础速度 (编码器脉冲/周期)
+ * @return  int16           差速输出 (正 = 右转: 左轮加速, 右轮减速)
+ */
+int16 Steer_Update(PID_Controller_t *outer, int16 error, int16 offset, int16 gyro_z, int16 base_speed);
+
+#endif // __STEER_H__
@@ -9,6 +9,20 @@
 
 #include "system.h"
 #include "key.h"                    /* 按键模块 - 用于判断运行状态 */
+#include "adc_scan.h"               /* ADC DMA 后台扫描 */
+#include "profiler.h"               /* 控制周期分段耗时统计 */
+#include "attitude.h"               /* 姿态解算 */
+#include "pose.h"                   /* 里程计位姿 */
+#include "steer.h"                  /* 串级转向 */
+#include "speed_ctrl.h"             /* 速度前馈 + 抗饱和 */
+#include "telemetry.h"              /* 二进制遥测 */
+#include "blackbox.h"               /* 黑匣子记录 */
+#include "debug_display.h"          /* OLED 调试显示 */
+#include "element.h"                /* 赛道元素识别 */
+#include "track_map.h"              /* 赛道记忆与速度规划 */
+#include "inductor_cal.h"           /* 电感自动标定 */
+#include "param_store.h"            /* EEPROM 参数存储 */
+#include "param_registry.h"         /* 可调参数表 */
 #include "zf_device_imu660ra.h"    /* IMU 驱动 */
 
 /*==================================================================================================================
@@ -21,6 +35,87 @@ SystemControl_t g_system;
 // 电池检测计数器 (每20次控制周期检测一次, 即100ms)
 static uint8 s_battery_check_cnt = 0;
 
+// 停车传感器刷新计数器 (每10次控制周期刷新一次, 即50ms)
+static uint8 s_idle_update_cnt = 0;
+
+// 当前已应用增益的元素 (元素切换时才重新计算增益)
+static ElementType_t s_gain_element = ELEM_NONE;
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   按元素增益表设置方向环增益
+ */
+static void system_apply_direction_gain(void)
+{
+    const ElementGain_t code *gain = Element_GetGain();
+    
+    PID_SetParams(&g_system.pid_direction,
+                  g_system.dir_kp_base * gain->kp_percent / 100,
+                  g_system.dir_ki_base,
+                  g_system.dir_kd_base * gain->kd_percent / 100);
+    s_gain_element = Element_GetType();
+}
+
+/**
+ * @brief   应用 EEPROM 中保存的参数
+ * @note    没有有效记录时保持 car_config.h 默认值
+ */
+static void system_load_params(void)
+{
+    ParamData_t param;
+    uint8 i;
+    
+    if (!ParamStore_Load(&param))
+    {
+        return;
+    }
+    
+    // 按参数表顺序恢复 (逐项限幅并调用回调, 方向环增益与蓝牙缓存随之更新)
+    for (i = 0; i < PARAM_REG_NUM; i++)
+    {
+        ParamRegistry_Set(i, param.reg[i]);
+    }
+    
+    for (i = 0; i < 4; i++)
+    {
+        if (param.cal_max[i] > param.cal_min[i])
+        {
+            Inductor_SetCalibration(i, param.cal_min[i], param.cal_max[i]);
+        }
+    }
+}
+
+/**
+ * @brief   把当前参数保存到 EEPROM
+ * @return  1 = 成功
+ * @note    擦写期间 CPU 暂停, 运行中拒绝保存
+ */
+static uint8 system_save_params(void)
+{
+    ParamData_t param;
+    uint8 i;
+    
+    if (key_car_should_run())
+    {
+        g_param_store.result = 0;       // 运行中拒绝保存, 状态报告不能沿用上次结果
+        return 0;
+    }
+    
+    for (i = 0; i < PARAM_REG_NUM; i++)
+    {
+        param.reg[i] = ParamRegistry_Get(i);
+    }
+    for (i = 0; i < 4; i++)
+    {
+        Inductor_GetCalibration(i, &param.cal_min[i], &param.cal_max[i]);
+    }
+    
+    return ParamStore_Save(&param);
+}
+
 /*==================================================================================================================
  *                                              系统初始化
  *==================================================================================================================*/
@@ -57,11 +152,18 @@ void System_Init(void)
     // 电池监测与蜂鸣器
     Battery_Init();
     
+    // 电感/电池 ADC 后台扫描 (引脚由 Inductor_Init / Battery_Init 配置, 之后 ADC 由 DMA 独占)
+#if ADC_SCAN_DMA_ENABLE
+    AdcScan_Init();
+#endif
+    
     // 负压风扇
     Fan_Init();
     
     // 蓝牙通信
     Bluetooth_Init();
+    Telemetry_Init();
+    BlackBox_Init();
     
     // 按键与拨码开关 (启动控制)
     key_init();
@@ -78,24 +180,25 @@ void System_Init(void)
         BUZZER_OFF();
     }
     
-    /*-------------------------------------------------
-     * Step 3: 初始化 PID 控制器
-     *-------------------------------------------------*/
+    // 姿态解算 (陀螺仪零偏在停车静止时自动学习)
+    Attitude_Init();
     
-    // 左轮速度环 PID (增量式)
-    PID_Init(&g_system.pid_speed_left, 
-             PID_SPEED_KP, PID_SPEED_KI, PID_SPEED_KD, 
-             PID_SPEED_OUT_MAX);
+    // 里程计位姿 (编码器 + 陀螺仪航位推算)
+    Pose_Init();
     
-    // 右轮速度环 PID (增量式)
-    PID_Init(&g_system.pid_speed_right, 
-             PID_SPEED_KP, PID_SPEED_KI, PID_SPEED_KD, 
-             PID_SPEED_OUT_MAX);
+    // OLED 调试显示 (主循环中分时刷新)
+#if DEBUG_OLED_ENABLE
+    DebugDisplay_Init();
+#endif
     
-    // 方向环 PID (位置式)
-    PID_Init(&g_system.pid_direction, 
-             PID_DIRECTION_KP, PID_DIRECTION_KI, PID_DIRECTION_KD, 
-             PID_DIRECTION_OUT_MAX);
+    /*-------------------------------------------------
+     * Step 3: 初始化 PID 控制器、元素识别与赛道记忆
+     *-------------------------------------------------*/
+    System_InitControl();
+    
+    // EEPROM 参数 ($SAVE 保存): 覆盖参数表中各项 (PID 增益、目标速度、元素阈值等) 和电感校准默认值
+    ParamStore_Init();
+    system_load_params();
     
     /*-------------------------------------------------
      * Step 4: 注册蓝牙回调函数
@@ -110,6 +213,9 @@ void System_Init(void)
     // 频率 = 1000ms / CONTROL_PERIOD_MS = 200Hz
     pit_ms_init(TIM2_PIT, CONTROL_PERIOD_MS);
     
+    // 分段耗时统计以 TIM2 计数器为时基, 需在定时器启动后初始化
+    Profiler_Init();
+    
     /*-------------------------------------------------
      * Step 6: 启动完成提示
      *-------------------------------------------------*/
@@ -123,6 +229,59 @@ void System_Init(void)
     BUZZER_OFF();
 }
 
+/**
+ * @brief   初始化控制链 (PID 控制器、元素识别、赛道记忆)
+ */
+void System_InitControl(void)
+{
+    // 左轮速度环 PID (增量式)
+    PID_Init(&g_system.pid_speed_left, 
+             PID_GAIN_Q(PID_SPEED_KP), PID_GAIN_Q(PID_SPEED_KI), PID_GAIN_Q(PID_SPEED_KD), 
+             PID_SPEED_OUT_MAX);
+    
+    // 右轮速度环 PID (增量式)
+    PID_Init(&g_system.pid_speed_right, 
+             PID_GAIN_Q(PID_SPEED_KP), PID_GAIN_Q(PID_SPEED_KI), PID_GAIN_Q(PID_SPEED_KD), 
+             PID_SPEED_OUT_MAX);
+    
+    // 方向环 PID (位置式)
+    PID_Init(&g_system.pid_direction, 
+             PID_GAIN_Q(PID_DIRECTION_KP), PID_GAIN_Q(PID_DIRECTION_KI), PID_GAIN_Q(PID_DIRECTION_KD), 
+             PID_DIRECTION_OUT_MAX);
+    Steer_Reset();
+    SpeedCtrl_Reset();
+    g_system.dir_kp_base = g_system.pid_direction.Kp;
+    g_system.dir_ki_base = g_system.pid_direction.Ki;
+    g_system.dir_kd_base = g_system.pid_direction.Kd;
+    
+    // 赛道元素识别 (输出方向偏置、速度倍率、方向环增益倍率)
+    Element_Init();
+    
+    // 赛道记忆 (默认关闭, $TRK:1 开始学习)
+    TrackMap_Init();
+}
+
+/**
+ * @brief   发车时复位控制链状态 (增益保持不变)
+ */
+void System_ResetControl(void)
+{
+    // 重置 PID 状态
+    PID_Reset(&g_system.pid_speed_left);
+    PID_Reset(&g_system.pid_speed_right);
+    PID_Reset(&g_system.pid_direction);
+    Steer_Reset();
+    SpeedCtrl_Reset();
+    
+    // 元素状态机从头开始, 方向环恢复基础增益
+    Element_Init();
+    system_apply_direction_gain();
+    
+    // 位姿以发车点为原点, 赛道记忆本圈里程和转角从发车点开始
+    Pose_Reset();
+    TrackMap_Restart();
+}
+
 /*==================================================================================================================
  *                                              系统启动/停止
  *==================================================================================================================*/
@@ -134,10 +293,8 @@ void System_Start(void)
 {
     if (g_system.state != SYS_STATE_RUNNING)
     {
-        // 重置 PID 状态
-        PID_Reset(&g_system.pid_speed_left);
-        PID_Reset(&g_system.pid_speed_right);
-        PID_Reset(&g_system.pid_direction);
+        // 控制链从头开始 (PID、元素状态机、位姿、赛道记忆本圈)
+        System_ResetControl();
         
         // 启动风扇 (自动模式)
         Fan_SetMode(FAN_MODE_AUTO);
@@ -169,6 +326,9 @@ void System_Stop(void)
     // 停止风扇
     Fan_Stop();
     
+    // 黑匣子停止记录, 停车后由主循环导出
+    BlackBox_Freeze(BLACKBOX_REASON_STOP);
+    
     // 更新状态
     g_system.state = SYS_STATE_STOPPED;
 }
@@ -185,19 +345,47 @@ void System_Stop(void)
 void System_Control(void)
 {
     int16 inductor_error;       // 电感偏差
-    int16 direction_output;     // 方向环输出 (速度差分)
-    int16 speed_left_target;    // 左轮目标速度
-    int16 speed_right_target;   // 右轮目标速度
     int16 speed_left_feedback;  // 左轮实际速度
     int16 speed_right_feedback; // 右轮实际速度
-    int16 pwm_left, pwm_right;  // PWM 输出
+    imu660ra_data_struct imu;   // IMU 原始数据
+    
+#if ADC_SCAN_DMA_ENABLE
+    // 电池电压滤波与压降检测: 停车时也采样 (只读 DMA 扫描结果)
+    Battery_Update();
+#endif
     
     /* 如果按键模块未启动运行, 跳过控制 */
     if (!key_car_should_run())
     {
+        // 电感标定: 扫过导线时峰值只持续几十 ms, 停车时也在控制中断中按 5ms 采样
+        if (InductorCal_IsActive())
+        {
+            Inductor_Update();
+            InductorCal_Update(&g_inductor.raw);
+        }
+        
+        // 静止调试模式: 车没跑时也刷新传感器数值, 并学习陀螺仪零偏
+        // 和运行时一样放在控制中断里, 编码器、电感、姿态滤波器都只有这一个使用者,
+        // 发车瞬间不会出现主循环读到一半被中断里的控制打断 (编码器计数被提前清零、滤波状态被改写)
+        s_idle_update_cnt++;
+        if (s_idle_update_cnt >= 10)        // 5ms × 10 = 50ms
+        {
+            s_idle_update_cnt = 0;
+            Encoder_Update();
+            if (!InductorCal_IsActive())    // 标定时上面已按 5ms 采样
+            {
+                Inductor_Update();
+            }
+            imu660ra_get_all(&imu);
+            Attitude_UpdateIdle(&imu, 10 * CONTROL_PERIOD_MS);
+            g_system.pitch_angle = g_attitude.pitch / 100;
+            g_system.yaw_rate = (imu.gyro_z - g_attitude.gyro_bias_z) / 16;
+        }
         return;
     }
     
+    PROFILER_BEGIN();
+    
     /*-------------------------------------------------
      * Step 1: 读取传感器数据
      *-------------------------------------------------*/
@@ -206,84 +394,174 @@ void System_Control(void)
     Encoder_Update();
     speed_left_feedback  = Encoder_GetLeftSpeed();
     speed_right_feedback = Encoder_GetRightSpeed();
+    PROFILER_MARK(PROF_STAGE_ENCODER);
     
     // 读取电磁电感
     Inductor_Update();
     inductor_error = Inductor_GetError();
+    PROFILER_MARK(PROF_STAGE_INDUCTOR);
+    
+    // 读取 IMU (加速度和陀螺仪一次连续读取, 两组数据同一时刻)
+    imu660ra_get_all(&imu);
+    
+    // 姿态解算: 陀螺仪积分 + 加速度计互补修正, 振动和上墙时俯仰角依然可靠
+    Attitude_Update(&imu);
+    g_system.pitch_angle = g_attitude.pitch / 100;
     
-    // 读取 IMU (加速度和陀螺仪)
-    imu660ra_get_gyro();
-    imu660ra_get_acc();
+    // 偏航角速度 (用于辅助转向, 已扣除零偏)
+    g_system.yaw_rate = (imu.gyro_z - g_attitude.gyro_bias_z) / 16;     // 简化缩放
     
-    // 简化姿态解算: 使用加速度计计算俯仰角
-    // pitch ≈ atan2(acc_x, acc_z) * 180 / PI
-    // 这里使用近似公式避免浮点运算: pitch ≈ acc_x / acc_z * 57.3
-    // 更精确的做法是使用互补滤波或卡尔曼滤波结合陀螺仪数据
-    if (imu660ra_acc_z != 0)
+    // 航位推算: 编码器里程 + 陀螺仪航向 -> x/y/航向/累计里程 (元素状态机按 mm、0.01° 判断)
+    Pose_Update(speed_left_feedback, speed_right_feedback, g_attitude.yaw_delta);
+    PROFILER_MARK(PROF_STAGE_IMU);
+    
+    /*-------------------------------------------------
+     * Step 2 ~ 5: 元素识别 → 基础速度 → 串级转向 → 速度环
+     *-------------------------------------------------*/
+    System_ControlStep(speed_left_feedback,
+                       speed_right_feedback,
+                       inductor_error,
+                       imu.gyro_z - g_attitude.gyro_bias_z,
+                       g_attitude.yaw_delta);
+    
+    /*-------------------------------------------------
+     * Step 6: 电机输出
+     *-------------------------------------------------*/
+    Motor_SetSpeed(g_system.motor_left_pwm, g_system.motor_right_pwm);
+    PROFILER_MARK(PROF_STAGE_MOTOR);
+    
+    /*-------------------------------------------------
+     * Step 7: 风扇自适应 (根据俯仰角)
+     *-------------------------------------------------*/
+    if (Element_IsEmergency())
     {
-        g_system.pitch_angle = (int16)((int32)imu660ra_acc_x * 57 / imu660ra_acc_z);
+        // 墙上长时间丢线: 风扇全速吸住车身, 电机由速度环刹停
+        Fan_SetDuty(FAN_DUTY_MAX);
     }
+    else
+    {
+#if FAN_MODEL_ENABLE
+        // 俯仰角速度预测上墙、车速预转、墙上 (含墙上转弯) 保持吸力、离墙斜坡下降
+        Fan_Control(g_attitude.pitch,
+                    g_attitude.gyro_bias_y - imu.gyro_y,
+                    (speed_left_feedback + speed_right_feedback) / 2,
+                    (uint8)(Element_GetType() > ELEM_STRAIGHT));
+#else
+        Fan_AutoAdjust(g_system.pitch_angle);
+#endif
+    }
+    PROFILER_MARK(PROF_STAGE_FAN);
+    
+    /*-------------------------------------------------
+     * Step 8: 遥测 (按分频打包, DMA 后台发送) 与黑匣子记录
+     *-------------------------------------------------*/
+    Telemetry_Update();
+    BlackBox_Record();
     
-    // 偏航角速度 (用于辅助转向)
-    g_system.yaw_rate = imu660ra_gyro_z / 16;   // 简化缩放
+    PROFILER_END();
+}
+
+/**
+ * @brief   控制链: 元素识别 → 基础速度 → 串级转向 → 速度环
+ * @note    由 System_Control 在传感器读取之后调用; 上位机回放工具用记录的数据调用同一函数
+ */
+void System_ControlStep(int16 speed_left_feedback, int16 speed_right_feedback,
+                        int16 inductor_error, int16 gyro_z, int16 yaw_delta)
+{
+    int16 base_speed;           // 元素调整后的基础速度
+    int16 direction_output;     // 方向环输出 (速度差分)
+    int16 speed_left_target;    // 左轮目标速度
+    int16 speed_right_target;   // 右轮目标速度
+    int16 pwm_left, pwm_right;  // PWM 输出
     
     /*-------------------------------------------------
-     * Step 2: 方向环 PID (基于电感偏差)
+     * Step 1: 赛道元素识别 (折线/直角/环岛/十字 + 丢线保护)
      *-------------------------------------------------*/
+    Element_Update(inductor_error,
+                   g_inductor.vector.left_magnitude,
+                   g_inductor.vector.right_magnitude,
+                   g_inductor.vector.sum,
+                   g_inductor.vector.is_online,
+                   g_system.pitch_angle);
+    
+    // 元素切换时更换方向环增益 (例如折线加大 Kd)
+    if (Element_GetType() != s_gain_element)
+    {
+        system_apply_direction_gain();
+    }
+    
+    // 赛道记忆: 学习圈记录里程/转角/元素, 之后各圈按里程给出目标速度 (弯前提前刹车)
+    TrackMap_Update((speed_left_feedback + speed_right_feedback) / 2,
+                    yaw_delta,
+                    Element_GetType());
+    
+    // 元素内减速: 目标速度按元素给出的倍率 (Q8) 缩放, 紧急状态直接刹停
+    if (Element_IsEmergency())
+    {
+        base_speed = 0;
+        BlackBox_Trigger(BLACKBOX_REASON_EMERGENCY);     // 保留事故前后两段记录
+    }
+    else
+    {
+        base_speed = (int16)(((int32)TrackMap_GetTargetSpeed(g_system.target_speed) * Element_GetSpeedScale()) >> 8);
+    }
+    g_system.base_speed = base_speed;
+    
+    // 短暂丢线: 用最后有效偏差保持原来的转向
+    if (!g_inductor.vector.is_online)
+    {
+        inductor_error = Element_GetLastValidError();
+    }
+    PROFILER_MARK(PROF_STAGE_ELEMENT);
     
-    // 方向环: 偏差 -> 速度差分
-    // 结合 IMU 偏航角速度进行微分前馈, 提高响应速度
-    direction_output = PID_Positional(&g_system.pid_direction, 0, inductor_error);
+    /*-------------------------------------------------
+     * Step 2: 转向 (方向环外环 -> 陀螺仪角速度内环)
+     *-------------------------------------------------*/
     
-    // 加入陀螺仪微分前馈 (可选, 提高高速稳定性)
-    // direction_output += g_system.yaw_rate / 10;
+    // 外环: 偏差 -> 差速, 叠加元素偏置 (直角弯阶跃、环岛持续转向, 以基础速度的 1/1024 给出) 和曲率前馈;
+    // 内环: 差速换算成期望角速度, 用陀螺仪实测角速度闭环
+    g_system.direction_offset = (int16)(((int32)base_speed * Element_GetDirectionOffset()) >> 10);
+    direction_output = Steer_Update(&g_system.pid_direction,
+                                    inductor_error,
+                                    g_system.direction_offset,
+                                    gyro_z,
+                                    base_speed);
+    g_system.direction_output = direction_output;
     
     /*-------------------------------------------------
      * Step 3: 计算左右轮目标速度
      *-------------------------------------------------*/
     
     // 差速转向: 在基础速度上叠加方向输出
-    speed_left_target  = g_system.target_speed + direction_output;
-    speed_right_target = g_system.target_speed - direction_output;
+    speed_left_target  = base_speed + direction_output;
+    speed_right_target = base_speed - direction_output;
     
     // 限幅
     speed_left_target  = LIMIT_RANGE(speed_left_target, -MOTOR_SPEED_MAX, MOTOR_SPEED_MAX);
     speed_right_target = LIMIT_RANGE(speed_right_target, -MOTOR_SPEED_MAX, MOTOR_SPEED_MAX);
+    g_system.speed_left_target  = speed_left_target;
+    g_system.speed_right_target = speed_right_target;
     
     /*-------------------------------------------------
      * Step 4: 速度环 PID (闭环控制)
      *-------------------------------------------------*/
     
+#if SPEED_CTRL_ENABLE
+    // 电机模型前馈 + PI 反馈, 输出受限时冻结积分, 占空比变化率受限
+    pwm_left  = SpeedCtrl_Update(SPEED_CTRL_LEFT,  &g_system.pid_speed_left,  speed_left_target,  speed_left_feedback);
+    pwm_right = SpeedCtrl_Update(SPEED_CTRL_RIGHT, &g_system.pid_speed_right, speed_right_target, speed_right_feedback);
+#else
     // 左轮速度环 PID (增量式)
     pwm_left = PID_Incremental(&g_system.pid_speed_left, speed_left_target, speed_left_feedback);
     
     // 右轮速度环 PID (增量式)
     pwm_right = PID_Incremental(&g_system.pid_speed_right, speed_right_target, speed_right_feedback);
+#endif
     
     // 记录输出值
     g_system.motor_left_pwm  = pwm_left;
     g_system.motor_right_pwm = pwm_right;
-    
-    /*-------------------------------------------------
-     * Step 5: 电机输出
-     *-------------------------------------------------*/
-    Motor_SetSpeed(pwm_left, pwm_right);
-    
-    /*-------------------------------------------------
-     * Step 6: 风扇自适应 (根据俯仰角)
-     *-------------------------------------------------*/
-    Fan_AutoAdjust(g_system.pitch_angle);
-    
-    /*-------------------------------------------------
-     * Step 7: 丢线检测与处理
-     *-------------------------------------------------*/
-    if (!Inductor_IsOnline())
-    {
-        // 丢线处理策略:
-        // 1. 短暂丢线: 保持上次方向继续前进
-        // 2. 长时间丢线: 减速或停止
-        // 这里简单处理: 保持上次输出
-    }
+    PROFILER_MARK(PROF_STAGE_PID);
 }
 
 /*==================================================================================================================
@@ -295,17 +573,21 @@ void System_Control(void)
  */
 void System_TaskLoop(void)
 {
-    static uint8 debug_update_cnt = 0;
-    
     // 蓝牙命令处理
     Bluetooth_Process();
     
+#if !ADC_SCAN_DMA_ENABLE
+    // 非 DMA 模式下 ADC 由主循环使用, 电池在这里采样
+    Battery_Update();
+#endif
+    
     // 电池检测 (每 100ms)
     s_battery_check_cnt++;
     if (s_battery_check_cnt >= 20)      // 5ms × 20 = 100ms
     {
         s_battery_check_cnt = 0;
         Battery_Check();
+        Fan_Refresh();                  // 地面/上墙模式按新的电压补偿倍率重新输出
         
         // 严重低电压时停止系统
         if (Battery_GetStatus() == BATTERY_CRITICAL)
@@ -315,31 +597,34 @@ void System_TaskLoop(void)
         }
     }
     
-    /*-------------------------------------------------
-     * 静止调试模式: 即使车没跑也能看传感器数值
-     *-------------------------------------------------*/
-    debug_update_cnt++;
-    if (debug_update_cnt >= 10)         // 5ms × 10 = 50ms
+    // 电感标定: 长按启动键开始, 扫描结束后应用结果并保存; 发车后未完成的标定作废
+    if (key_car_should_run())
     {
-        debug_update_cnt = 0;
-        
-        // 读取传感器 (不论车是否运行)
-        Encoder_Update();
-        Inductor_Update();
-        imu660ra_get_gyro();
-        imu660ra_get_acc();
-        
-        // 更新系统变量
-        if (imu660ra_acc_z != 0)
-        {
-            g_system.pitch_angle = (int16)((int32)imu660ra_acc_x * 57 / imu660ra_acc_z);
-        }
-        g_system.yaw_rate = imu660ra_gyro_z / 16;
+        InductorCal_Stop(0);
+    }
+    else if (key_take_cal_request())
+    {
+        InductorCal_Start();
+    }
+    if (InductorCal_Task())
+    {
+        system_save_params();
+        ParamStore_SendReport();
     }
     
-    // OLED 显示更新 (可选)
-    // 显示电压、速度、偏差等信息
-    // oled_show_string(...);
+    // 赛道记忆: 学习完成后生成速度表, 分批发送详细报告
+    TrackMap_Task();
+    
+    // $LIST: 分批发送参数表
+    ParamRegistry_Task();
+    
+    // 黑匣子: 发车时开始记录, 停车后经调试串口分批导出
+    BlackBox_Task(key_car_should_run());
+    
+    // OLED 调试显示: 每次只推进一步, 单次 I2C 传输不超过 OLED_FLUSH_BUDGET_BYTES
+#if DEBUG_OLED_ENABLE
+    DebugDisplay_Task();
+#endif
 }
 
 /*==================================================================================================================
@@ -378,12 +663,14 @@ void System_SetTargetSpeed(int16 speed)
  */
 void System_PIDCallback(int16 kp_x10, int16 ki_x10, int16 kd_x10)
 {
-    // 更新方向环 PID 参数 (将 ×10 的值转换为实际浮点值)
-    float kp = (float)kp_x10 / 10.0f;
-    float ki = (float)ki_x10 / 10.0f;
-    float kd = (float)kd_x10 / 10.0f;
+    // 更新方向环 PID 参数 (×10 整数直接转换为 Q10 定点增益, 不经过浮点)
+    PID_SetParamsX10(&g_system.pid_direction, kp_x10, ki_x10, kd_x10);
+    g_system.dir_kp_base = g_system.pid_direction.Kp;
+    g_system.dir_ki_base = g_system.pid_direction.Ki;
+    g_system.dir_kd_base = g_system.pid_direction.Kd;
     
-    PID_SetParams(&g_system.pid_direction, kp, ki, kd);
+    // 正在执行元素时, 按元素倍率重新应用
+    system_apply_direction_gain();
     
     // 蜂鸣器短响确认
     BUZZER_ON();
@@ -391,6 +678,20 @@ void System_PIDCallback(int16 kp_x10, int16 ki_x10, int16 kd_x10)
     BUZZER_OFF();
 }
 
+/**
+ * @brief   可调参数修改后同步
+ */
+void System_ParamChanged(void)
+{
+    PID_Controller_t *left = &g_system.pid_speed_left;
+    
+    system_apply_direction_gain();
+    PID_SetParams(&g_system.pid_speed_right, left->Kp, left->Ki, left->Kd);
+    Bluetooth_SetPIDCache(PID_GainToX10(g_system.dir_kp_base),
+                          PID_GainToX10(g_system.dir_ki_base),
+                          PID_GainToX10(g_system.dir_kd_base));
+}
+
 /**
  * @brief   控制命令回调
  */
@@ -416,13 +717,104 @@ void System_CmdCallback(BluetoothCmd_t cmd, int16 value)
             break;
             
         case BT_CMD_DEBUG:
-            // 发送调试数据 (电压值 × 10)
-            Bluetooth_SendDebugData(
-                Inductor_GetError(),
-                Encoder_GetLeftSpeed(),
-                Encoder_GetRightSpeed(),
-                (int16)(Battery_GetVoltage() * 10)
-            );
+            // 发送一帧完整遥测 (二进制, 停车时也可用)
+            Telemetry_SendSnapshot();
+            break;
+            
+        case BT_CMD_TELEMETRY:
+            // 设置遥测分频 (0 = 关闭)
+            Telemetry_SetDecimation((uint8)value);
+            break;
+            
+        case BT_CMD_TEL_MASK:
+            // 设置遥测字段
+            Telemetry_SetMask((uint16)value);
+            break;
+            
+        case BT_CMD_PROFILE:
+            // 发送控制周期耗时报告, $PRF:1 发送后清零统计
+            Profiler_SendReport();
+#if DEBUG_OLED_ENABLE
+            DebugDisplay_SendReport();
+#endif
+            if (value == 1)
+            {
+                Profiler_Reset();
+#if DEBUG_OLED_ENABLE
+                DebugDisplay_ResetStats();
+#endif
+            }
+            break;
+            
+        case BT_CMD_TRACK:
+            // 赛道记忆: 0 = 关闭, 1 = 重新学习, 2 = 按已有地图回放, 3 = 发送详细报告
+            if (value == 3)
+            {
+                TrackMap_SendReport(1);
+                break;
+            }
+            TrackMap_SetMode(value == 1 ? TRACK_MODE_LEARN : (value == 2 ? TRACK_MODE_REPLAY : TRACK_MODE_OFF));
+            TrackMap_SendReport(0);
+            break;
+            
+        case BT_CMD_TRACK_INFO:
+            TrackMap_SendReport(0);
+            break;
+            
+        case BT_CMD_CAL:
+            // 电感标定: 1 = 开始扫线 (仅停车时), 0 = 提前结束并应用, 2 = 放弃
+            if (value == 1)
+            {
+                if (!key_car_should_run())
+                {
+                    InductorCal_Start();
+                }
+                InductorCal_SendReport();
+            }
+            else
+            {
+                InductorCal_Stop(value == 0);
+            }
+            break;
+            
+        case BT_CMD_CAL_INFO:
+            InductorCal_SendReport();
+            break;
+            
+        case BT_CMD_SAVE:
+            system_save_params();
+            ParamStore_SendReport();
+            break;
+            
+        case BT_CMD_PARAM_STORE:
+            // 参数存储: 0 = 擦除 (下次上电用默认值), 1 = 保存, 2 = 查询状态
+            if (value == 0 && !key_car_should_run())
+            {
+                ParamStore_Erase();
+            }
+            else if (value == 1)
+            {
+                system_save_params();
+            }
+            ParamStore_SendReport();
+            break;
+            
+        case BT_CMD_BATTERY:
+            Battery_SendReport();
+            break;
+            
+        case BT_CMD_PARAM_LIST:
+            ParamRegistry_CmdList();
+            break;
+            
+        case BT_CMD_BLACKBOX:
+            // 黑匣子记录分频 (下次发车生效, 0 = 不记录)
+            BlackBox_SetDecimation((uint8)value);
+            break;
+            
+        case BT_CMD_BLACKBOX_DUMP:
+            // 重新导出黑匣子 (调试串口)
+            BlackBox_Dump();
             break;
             
         default:
@@ -53,12 +53,22 @@ typedef struct
     PID_Controller_t pid_speed_right;   // 右轮速度环 PID
     PID_Controller_t pid_direction;     // 方向环 PID
     
+    // 方向环基础增益 (Q10, 蓝牙/EEPROM/默认设置), 元素增益表在此基础上按百分比缩放
+    int32 dir_kp_base;
+    int32 dir_ki_base;
+    int32 dir_kd_base;
+    
     // IMU 数据
     int16 pitch_angle;          // 俯仰角 (度)
     int16 roll_angle;           // 横滚角 (度)
     int16 yaw_rate;             // 偏航角速度 (°/s)
     
     // 控制输出
+    int16 base_speed;           // 基础速度 (赛道记忆 × 元素速度倍率)
+    int16 direction_offset;     // 元素方向偏置 (差速)
+    int16 direction_output;     // 方向环输出 (速度差分)
+    int16 speed_left_target;    // 左轮目标速度
+    int16 speed_right_target;   // 右轮目标速度
     int16 motor_left_pwm;       // 左电机 PWM
     int16 motor_right_pwm;      // 右电机 PWM
     
@@ -78,6 +88,20 @@ extern SystemControl_t g_system;
  */
 void System_Init(void);
 
+/**
+ * @brief   初始化控制链 (速度环/方向环 PID、串级转向、速度控制、元素识别、赛道记忆)
+ * @return  void
+ * @note    由 System_Init 调用; 上位机回放工具单独调用 (不初始化外设)
+ */
+void System_InitControl(void);
+
+/**
+ * @brief   复位控制链状态 (PID 历史、元素状态机、位姿、赛道记忆本圈), 增益保持不变
+ * @return  void
+ * @note    由 System_Start 在发车时调用; 上位机回放工具在每段记录开始时调用
+ */
+void System_ResetControl(void);
+
 /**
  * @brief   系统启动 (开始运行)
  * @return  void
@@ -95,21 +119,39 @@ void System_Stop(void);
  * @details 包含:
  *          1. 编码器读取
  *          2. 电感读取
- *          3. IMU 读取
- *          4. PID 计算
- *          5. 电机输出
- *          6. 风扇自适应
+ *          3. IMU 读取, 姿态解算, 里程计位姿
+ *          4. 元素识别 (速度倍率、方向偏置、方向环增益切换)
+ *             赛道记忆 (学习圈记录, 之后按里程给目标速度)
+ *          5. 串级转向 (方向环外环 + 陀螺仪内环) 与速度环 PID 计算
+ *          6. 电机输出
+ *          7. 风扇自适应
  * @return  void
  * @note    应在定时中断 (PIT) 中调用, 保证精确周期
  */
 void System_Control(void);
 
+/**
+ * @brief   控制链: 元素识别 → 基础速度 (赛道记忆 × 元素倍率) → 串级转向 → 速度环
+ * @param   speed_left_feedback     左轮速度 (编码器脉冲/周期)
+ * @param   speed_right_feedback    右轮速度
+ * @param   inductor_error          电感偏差 (Inductor_Update 之后, 丢线替换在函数内完成)
+ * @param   gyro_z                  陀螺仪 Z 轴角速度 (原始值, 已扣除零偏)
+ * @param   yaw_delta               本周期转角 (0.01°)
+ * @return  void
+ * @note    俯仰角取 g_system.pitch_angle, 电感解算结果取 g_inductor;
+ *          结果写入 g_system (base_speed、direction_offset、direction_output、speed_*_target、motor_*_pwm),
+ *          不输出到电机. System_Control 与上位机回放工具共用, 保证回放与实车是同一条控制链
+ */
+void System_ControlStep(int16 speed_left_feedback, int16 speed_right_feedback,
+                        int16 inductor_error, int16 gyro_z, int16 yaw_delta);
+
 /**
  * @brief   主循环任务 (非实时)
  * @details 包含:
  *          1. 蓝牙命令处理
  *          2. 电池检测
- *          3. OLED 显示更新
+ *          3. 电感标定结果应用 (并保存到 EEPROM), 赛道记忆速度表生成, $LIST 参数表分批发送
+ *          4. OLED 显示更新
  * @return  void
  * @note    在 main() 的 while(1) 中调用
  */
@@ -128,6 +170,13 @@ SystemState_t System_GetState(void);
  */
 void System_SetTargetSpeed(int16 speed);
 
+/**
+ * @brief   可调参数修改后同步 (由参数表模块调用)
+ * @details 按元素倍率重新应用方向环基础增益, 右轮速度环增益与左轮同步, 更新蓝牙 $P/$I/$D 缓存
+ * @return  void
+ */
+void System_ParamChanged(void);
+
 /**
  * @brief   PID 参数更新回调 (由蓝牙模块调用)
  * @param   kp_x10  Kp × 10 的整数值 (例如 15 表示 1.5)
@@ -0,0 +1,304 @@
+/*********************************************************************************************************************
+ * @file        telemetry.c
+ * @brief       飞檐走壁智能车 - 二进制遥测模块 (源文件)
+ * @details     字段打包 + CRC, 通过蓝牙发送队列 (UART4 TX DMA) 发出
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-15
+ ********************************************************************************************************************/
+
+#include "telemetry.h"
+#include "inductor.h"
+#include "encoder.h"
+#include "element.h"
+#include "battery.h"
+#include "attitude.h"
+#include "system.h"
+#include "bluetooth.h"
+
+/*==================================================================================================================
+ *                                              私有变量
+ *==================================================================================================================*/
+
+static uint8  s_decimation = TELEMETRY_DECIMATION;
+static uint8  s_decimation_cnt = 0;
+static uint16 s_mask = TELEMETRY_DEFAULT_MASK;
+static uint8  s_seq = 0;
+static uint16 s_tick = 0;
+static uint16 s_drop_count = 0;
+
+static const uint8 code s_field_size[TEL_FIELD_NUM] = TELEMETRY_FIELD_SIZES;
+
+/*==================================================================================================================
+ *                                              打包工具
+ *==================================================================================================================*/
+
+/**
+ * @brief   写入 16 位小端数据, 返回写入后的位置
+ */
+static uint8 *telemetry_put16(uint8 *p, uint16 value)
+{
+    *p++ = (uint8)(value & 0xFF);
+    *p++ = (uint8)(value >> 8);
+    return p;
+}
+
+/**
+ * @brief   计算 CRC-16/CCITT-FALSE
+ */
+uint16 Telemetry_Crc16(const uint8 *dat, uint8 len)
+{
+    uint16 crc = 0xFFFF;
+    uint8 i;
+
+    while (len--)
+    {
+        crc ^= (uint16)(*dat++) << 8;
+        for (i = 0; i < 8; i++)
+        {
+            crc = (crc & 0x8000) ? (uint16)((crc << 1) ^ 0x1021) : (uint16)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief   计算字段数据长度
+ */
+uint8 Telemetry_GetPayloadLen(uint16 mask)
+{
+    uint8 payload_len = 0;
+    uint8 i;
+
+    mask &= TEL_MASK_ALL;
+    for (i = 0; i < TEL_FIELD_NUM; i++)
+    {
+        if (mask & TEL_MASK(i))
+        {
+            payload_len += s_field_size[i];
+        }
+    }
+    return payload_len;
+}
+
+/**
+ * @brief   按掩码打包字段数据
+ */
+uint8 Telemetry_PackFields(uint8 *p, uint16 mask)
+{
+    uint8 *start = p;
+
+    // 字段顺序必须与 TelemetryField_t / TELEMETRY_FIELD_SIZES 一致
+    if (mask & TEL_MASK(TEL_FIELD_TICK))
+    {
+        p = telemetry_put16(p, s_tick);
+    }
+    if (mask & TEL_MASK(TEL_FIELD_IND_ERR))
+    {
+        p = telemetry_put16(p, (uint16)g_inductor.vector.error);
+    }
+    if (mask & TEL_MASK(TEL_FIELD_IND_MAG))
+    {
+        *p++ = g_inductor.vector.left_magnitude;
+        *p++ = g_inductor.vector.right_magnitude;
+        *p++ = g_inductor.vector.sum;
+    }
+    if (mask & TEL_MASK(TEL_FIELD_ENCODER))
+    {
+        p = telemetry_put16(p, (uint16)g_encoder.left_speed);
+        p = telemetry_put16(p, (uint16)g_encoder.right_speed);
+    }
+    if (mask & TEL_MASK(TEL_FIELD_DIR_OUT))
+    {
+        p = telemetry_put16(p, (uint16)g_system.direction_output);
+    }
+    if (mask & TEL_MASK(TEL_FIELD_PWM))
+    {
+        p = telemetry_put16(p, (uint16)g_system.motor_left_pwm);
+        p = telemetry_put16(p, (uint16)g_system.motor_right_pwm);
+    }
+    if (mask & TEL_MASK(TEL_FIELD_ELEMENT))
+    {
+        *p++ = (uint8)g_element.current_element;
+        *p++ = (uint8)g_element.state;
+    }
+    if (mask & TEL_MASK(TEL_FIELD_BATTERY))
+    {
+        p = telemetry_put16(p, Battery_GetVoltageX100());
+    }
+    if (mask & TEL_MASK(TEL_FIELD_ATTITUDE))
+    {
+        p = telemetry_put16(p, (uint16)g_attitude.pitch);
+        p = telemetry_put16(p, (uint16)g_attitude.yaw);
+    }
+    if (mask & TEL_MASK(TEL_FIELD_IND_RAW))
+    {
+        p = telemetry_put16(p, g_inductor.raw.left_x);
+        p = telemetry_put16(p, g_inductor.raw.left_y);
+        p = telemetry_put16(p, g_inductor.raw.right_x);
+        p = telemetry_put16(p, g_inductor.raw.right_y);
+    }
+    if (mask & TEL_MASK(TEL_FIELD_IND_NORM))
+    {
+        *p++ = g_inductor.norm.left_x;
+        *p++ = g_inductor.norm.left_y;
+        *p++ = g_inductor.norm.right_x;
+        *p++ = g_inductor.norm.right_y;
+    }
+
+    return (uint8)(p - start);
+}
+
+/**
+ * @brief   打包帧头和字段, 不填序号和 CRC
+ * @return  帧总长度
+ */
+static uint8 telemetry_pack_body(uint8 *frame, uint16 mask)
+{
+    uint8 payload_len;
+
+    mask &= TEL_MASK_ALL;
+
+    frame[0] = TELEMETRY_SYNC0;
+    frame[1] = TELEMETRY_SYNC1;
+    telemetry_put16(&frame[4], mask);
+    payload_len = Telemetry_PackFields(&frame[TELEMETRY_HEADER_LEN], mask);
+    frame[3] = payload_len;
+
+    return (uint8)(TELEMETRY_HEADER_LEN + payload_len + TELEMETRY_CRC_LEN);
+}
+
+/**
+ * @brief   填入序号并计算 CRC
+ */
+static void telemetry_seal(uint8 *frame, uint8 len, uint8 seq)
+{
+    frame[2] = seq;
+    telemetry_put16(&frame[len - TELEMETRY_CRC_LEN],
+                    Telemetry_Crc16(&frame[2], (uint8)(len - TELEMETRY_CRC_LEN - 2)));
+}
+
+/**
+ * @brief   按掩码打包一帧
+ */
+uint8 Telemetry_PackFrame(uint8 *frame, uint8 seq, uint16 mask)
+{
+    uint8 len = telemetry_pack_body(frame, mask);
+
+    telemetry_seal(frame, len, seq);
+    return len;
+}
+
+/*==================================================================================================================
+ *                                              发送
+ *==================================================================================================================*/
+
+/**
+ * @brief   打包并写入蓝牙发送队列
+ * @return  uint8   1 = 已入队, 0 = 队列空间不足, 本帧丢弃
+ * @note    主循环 ($DBG) 和控制中断都会调用, 因此使用局部缓冲区;
+ *          取序号、入队、序号加 1 (以及丢帧计数) 在同一个关中断区间内完成,
+ *          否则中断插在中间时两帧会用同一个序号, 上位机丢帧统计出错
+ */
+static uint8 telemetry_send(uint16 mask)
+{
+    uint8 frame[TELEMETRY_FRAME_MAX];
+    uint8 len;
+    uint8 ok;
+
+    // 队列放不下一整帧时不打包, 省下打包和 CRC 的时间
+    if (Bluetooth_GetTxFree() < TELEMETRY_FRAME_MAX)
+    {
+        interrupt_global_disable();
+        s_drop_count++;
+        interrupt_global_enable();
+        return 0;
+    }
+
+    // 字段在临界区外打包; 临界区内只有序号、CRC 和入队 (最长帧约 46 字节)
+    len = telemetry_pack_body(frame, mask);
+
+    interrupt_global_disable();
+    telemetry_seal(frame, len, s_seq);
+    ok = Bluetooth_SendBufferNoLock(frame, len);
+    if (ok)
+    {
+        s_seq++;
+    }
+    else
+    {
+        s_drop_count++;
+    }
+    interrupt_global_enable();
+    return ok;
+}
+
+/*==================================================================================================================
+ *                                              对外接口
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化遥测模块
+ */
+void Telemetry_Init(void)
+{
+    s_decimation = TELEMETRY_DECIMATION;
+    s_decimation_cnt = 0;
+    s_mask = TELEMETRY_DEFAULT_MASK;
+    s_seq = 0;
+    s_tick = 0;
+    s_drop_count = 0;
+}
+
+/**
+ * @brief   控制周期遥测任务
+ */
+void Telemetry_Update(void)
+{
+    s_tick++;
+
+    if (s_decimation == 0 || s_mask == 0)
+    {
+        return;
+    }
+
+    s_decimation_cnt++;
+    if (s_decimation_cnt >= s_decimation)
+    {
+        s_decimation_cnt = 0;
+        telemetry_send(s_mask);
+    }
+}
+
+/**
+ * @brief   立即发送一帧包含全部字段的遥测
+ */
+uint8 Telemetry_SendSnapshot(void)
+{
+    return telemetry_send(TEL_MASK_ALL);
+}
+
+/**
+ * @brief   设置发送分频
+ */
+void Telemetry_SetDecimation(uint8 decimation)
+{
+    s_decimation = decimation;
+    s_decimation_cnt = 0;
+}
+
+/**
+ * @brief   设置发送字段
+ */
+void Telemetry_SetMask(uint16 mask)
+{
+    s_mask = mask & TEL_MASK_ALL;
+}
+
+/**
+ * @brief   获取丢帧数
+ */
+uint16 Telemetry_GetDropCount(void)
+{
+    return s_drop_count;
+}
@@ -0,0 +1,140 @@
+/*********************************************************************************************************************
+ * @file        telemetry.h
+ * @brief       飞檐走壁智能车 - 二进制遥测模块 (头文件)
+ * @details     以固定分频把控制周期数据打包成二进制帧, 写入蓝牙发送队列 (UART4 TX DMA 后台发出)
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-15
+ *
+ * @note        帧格式 (多字节均为小端):
+ *              +------+------+-----+-----+--------+-----------+--------+
+ *              | 0xA5 | 0x5A | seq | len | mask   | payload   | crc16  |
+ *              |  1   |  1   |  1  |  1  |  2     | len 字节  |  2     |
+ *              +------+------+-----+-----+--------+-----------+--------+
+ *              - seq:     帧序号, 每帧加 1, 上位机据此统计丢帧
+ *              - len:     payload 长度
+ *              - mask:    本帧包含的字段, bit n 对应 TelemetryField_t 中的第 n 个字段
+ *              - payload: 按 bit 从低到高依次排列的字段数据
+ *              - crc16:   CRC-16/CCITT-FALSE (多项式 0x1021, 初值 0xFFFF), 覆盖 seq ~ payload
+ *
+ *              上位机解码: host/telemetry_decode.c (输出 CSV)
+ *              黑匣子 (blackbox.h) 的记录也按这里的字段打包, 导出时使用同样的帧格式
+ ********************************************************************************************************************/
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include "car_config.h"
+
+/*==================================================================================================================
+ *                                              帧格式定义
+ *==================================================================================================================*/
+
+#define TELEMETRY_SYNC0             0xA5
+#define TELEMETRY_SYNC1             0x5A
+#define TELEMETRY_HEADER_LEN        6           // sync(2) + seq + len + mask(2)
+#define TELEMETRY_CRC_LEN           2
+#define TELEMETRY_PAYLOAD_MAX       40
+#define TELEMETRY_FRAME_MAX         (TELEMETRY_HEADER_LEN + TELEMETRY_PAYLOAD_MAX + TELEMETRY_CRC_LEN)
+
+/**
+ * @brief   遥测字段 (枚举值即 mask 中的 bit 位置)
+ */
+typedef enum
+{
+    TEL_FIELD_TICK = 0,         // uint16       控制周期计数 (5ms)
+    TEL_FIELD_IND_ERR,          // int16        电感偏差 (-100 ~ +100)
+    TEL_FIELD_IND_MAG,          // uint8 × 3    左模值, 右模值, 向量和
+    TEL_FIELD_ENCODER,          // int16 × 2    左轮速度, 右轮速度
+    TEL_FIELD_DIR_OUT,          // int16        方向环输出
+    TEL_FIELD_PWM,              // int16 × 2    左电机 PWM, 右电机 PWM
+    TEL_FIELD_ELEMENT,          // uint8 × 2    当前元素, 状态机状态
+    TEL_FIELD_BATTERY,          // uint16       电池电压 × 100
+    TEL_FIELD_ATTITUDE,         // int16 × 2    俯仰角, 偏航角 (0.01°)
+    TEL_FIELD_IND_RAW,          // uint16 × 4   电感原始 ADC 值 (LX, LY, RX, RY)
+    TEL_FIELD_IND_NORM,         // uint8 × 4    电感归一化值 (LX, LY, RX, RY)
+    TEL_FIELD_NUM
+} TelemetryField_t;
+
+// 各字段字节数 (与 TelemetryField_t 顺序一致, 上位机解码共用)
+#define TELEMETRY_FIELD_SIZES       { 2, 2, 3, 4, 2, 4, 2, 2, 4, 8, 4 }
+
+#define TEL_MASK(field)             ((uint16)1 << (field))
+#define TEL_MASK_ALL                ((uint16)(TEL_MASK(TEL_FIELD_NUM) - 1))
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化遥测模块
+ * @return  void
+ */
+void Telemetry_Init(void);
+
+/**
+ * @brief   控制周期遥测任务
+ * @note    在 System_Control() 末尾调用, 每 TELEMETRY_DECIMATION 个周期发送一帧
+ *          蓝牙发送队列放不下时本帧丢弃 (计入丢帧数), 不等待
+ * @return  void
+ */
+void Telemetry_Update(void);
+
+/**
+ * @brief   立即发送一帧包含全部字段的遥测 (响应 $DBG, 停车时也可用)
+ * @return  uint8   1 = 已入队, 0 = 发送队列已满
+ */
+uint8 Telemetry_SendSnapshot(void);
+
+/**
+ * @brief   设置发送分频
+ * @param   decimation  每 N 个控制周期发送一帧, 0 = 关闭周期发送
+ * @return  void
+ */
+void Telemetry_SetDecimation(uint8 decimation);
+
+/**
+ * @brief   设置发送字段
+ * @param   mask    字段掩码 (bit n = TelemetryField_t 第 n 项)
+ * @return  void
+ */
+void Telemetry_SetMask(uint16 mask);
+
+/**
+ * @brief   按掩码打包字段数据 (不含帧头和 CRC)
+ * @param   p       输出缓冲区 (至少 Telemetry_GetPayloadLen(mask) 字节)
+ * @param   mask    字段掩码
+ * @return  uint8   写入的字节数
+ * @note    只读各模块数据, 主循环和控制中断都可调用 (黑匣子记录也使用)
+ */
+uint8 Telemetry_PackFields(uint8 *p, uint16 mask);
+
+/**
+ * @brief   计算字段数据长度
+ * @param   mask    字段掩码
+ * @return  uint8   字节数
+ */
+uint8 Telemetry_GetPayloadLen(uint16 mask);
+
+/**
+ * @brief   按掩码打包一帧
+ * @param   frame   输出缓冲区 (至少 TELEMETRY_FRAME_MAX 字节)
+ * @param   seq     帧序号
+ * @param   mask    字段掩码
+ * @return  uint8   帧总长度
+ */
+uint8 Telemetry_PackFrame(uint8 *frame, uint8 seq, uint16 mask);
+
+/**
+ * @brief   计算 CRC-16/CCITT-FALSE
+ * @return  uint16  CRC 值
+ */
+uint16 Telemetry_Crc16(const uint8 *dat, uint8 len);
+
+/**
+ * @brief   获取因发送队列满而丢弃的帧数
+ * @return  uint16
+ */
+uint16 Telemetry_GetDropCount(void);
+
+#endif // __TELEMETRY_H__
@@ -0,0 +1,489 @@
+/*********************************************************************************************************************
+ * @file        track_map.c
+ * @brief       飞檐走壁智能车 - 赛道记忆与速度规划模块 (源文件)
+ * @details     按里程分格记录转角和元素, 生成带刹车点的速度表, 之后各圈按里程查表
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-17
+ ********************************************************************************************************************/
+
+#include "track_map.h"
+#include "bluetooth.h"
+
+/*==================================================================================================================
+ *                                              全局变量
+ *==================================================================================================================*/
+
+TrackMapData_t g_track;
+
+/*==================================================================================================================
+ *                                              私有变量
+ *==================================================================================================================*/
+
+static int8  xdata s_bin_yaw[TRACK_MAX_BINS];           // 每格转角 (度, 正 = 右转)
+static uint8 xdata s_bin_speed[TRACK_MAX_BINS];         // 每格目标速度 (目标速度的百分比)
+static TrackEvent_t xdata s_event[TRACK_MAX_EVENTS];    // 元素记录 (按出现顺序)
+
+static int16 s_bin_yaw_acc = 0;                         // 当前格转角累计 (0.01°)
+static ElementType_t s_last_element = ELEM_NONE;
+static uint8 s_next_event = 0;                          // 回放时下一个要对齐的元素
+static int32 s_map_distance = 0;                        // 学习圈从发车点到转角闭合的里程
+static int32 s_closure_odo = 0;                         // 距上次转角闭合的里程
+
+static uint16 s_dump_pos = 0xFFFF;                      // 详细报告发送进度 (0xFFFF = 不在发送)
+
+// 详细报告每行格数: "B255" + 4 × " -127/100" + "\r\n" 最长 42 字节, 不超过 TrackMap_Task 的行缓冲
+#define TRACK_DUMP_BINS     4
+
+/*==================================================================================================================
+ *                                              私有函数
+ *==================================================================================================================*/
+
+/**
+ * @brief   本圈位置清零
+ */
+static void track_lap_reset(void)
+{
+    g_track.lap_distance = 0;
+    g_track.bin = 0;
+    s_bin_yaw_acc = 0;
+    s_next_event = 0;
+}
+
+/**
+ * @brief   判断一圈是否结束
+ * @details 累计转角达到 TRACK_LAP_YAW - TRACK_LAP_YAW_MARGIN 即认为一圈结束 (在最后一个弯内触发,
+ *          每圈位置相同), 扣掉整圈 TRACK_LAP_YAW 后余量留给下一圈
+ * @return  1 = 一圈结束
+ */
+static uint8 track_lap_closed(void)
+{
+    if (ABS_VALUE(g_track.lap_yaw) < (int32)(TRACK_LAP_YAW - TRACK_LAP_YAW_MARGIN) * 100)
+    {
+        return 0;
+    }
+
+    if (g_track.lap_yaw > 0)
+    {
+        g_track.lap_yaw -= (int32)TRACK_LAP_YAW * 100;
+    }
+    else
+    {
+        g_track.lap_yaw += (int32)TRACK_LAP_YAW * 100;
+    }
+    return 1;
+}
+
+/**
+ * @brief   学习: 当前格结束, 写入转角
+ */
+static void track_learn_close_bin(void)
+{
+    int16 deg = s_bin_yaw_acc / 100;
+
+    if (g_track.bin < TRACK_MAX_BINS)
+    {
+        s_bin_yaw[g_track.bin] = (int8)LIMIT_RANGE(deg, -127, 127);
+    }
+    s_bin_yaw_acc -= deg * 100;     // 不足 1° 的部分留到下一格
+}
+
+/**
+ * @brief   学习: 记录元素进出
+ */
+static void track_learn_element(ElementType_t element)
+{
+    uint8 bin = (uint8)g_track.bin;
+
+    if (element != ELEM_NONE && s_last_element == ELEM_NONE)
+    {
+        if (g_track.event_num < TRACK_MAX_EVENTS)
+        {
+            s_event[g_track.event_num].start_bin = bin;
+            s_event[g_track.event_num].end_bin   = bin;
+            s_event[g_track.event_num].type      = (uint8)element;
+            g_track.event_num++;
+        }
+    }
+    else if (element == ELEM_NONE && s_last_element != ELEM_NONE && g_track.event_num > 0)
+    {
+        s_event[g_track.event_num - 1].end_bin = bin;
+    }
+}
+
+/**
+ * @brief   回放: 识别到元素时对齐里程
+ * @details 从下一个待对齐的记录开始, 找窗口内同类型的元素, 找到后把里程对齐到它的入口格
+ */
+static void track_replay_anchor(ElementType_t element)
+{
+    uint8 i;
+    int16 diff;
+
+    if (element == ELEM_NONE || s_last_element != ELEM_NONE)
+    {
+        return;
+    }
+
+    for (i = s_next_event; i < g_track.event_num; i++)
+    {
+        diff = (int16)s_event[i].start_bin - (int16)g_track.bin;
+        if (diff > TRACK_ANCHOR_WINDOW)
+        {
+            break;          // 记录按位置排序, 后面的更远
+        }
+        if (diff >= -TRACK_ANCHOR_WINDOW && s_event[i].type == (uint8)element)
+        {
+            g_track.bin = s_event[i].start_bin;
+            g_track.lap_distance = (int32)g_track.bin * TRACK_BIN_DIST;
+            g_track.anchor_count++;
+            s_next_event = i + 1;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief   把区间 [start, end] (可跨圈) 的速度限制到 percent 以下
+ */
+static void track_limit_range(uint16 start, uint16 end, uint8 percent)
+{
+    uint16 i = start;
+
+    while (1)
+    {
+        if (s_bin_speed[i] > percent)
+        {
+            s_bin_speed[i] = percent;
+        }
+        if (i == end)
+        {
+            break;
+        }
+        i = (i + 1 < g_track.lap_bins) ? (i + 1) : 0;
+    }
+}
+
+/**
+ * @brief   生成速度表
+ */
+static void track_build_profile(void)
+{
+    uint16 n = g_track.lap_bins;
+    uint16 i, j, k;
+    int16 window_yaw;
+    uint8 pass;
+    uint8 limit;
+
+    // 1. 急弯: 从每格往前看 TRACK_CORNER_WINDOW 格, 累计转角超过阈值
+    for (i = 0; i < n; i++)
+    {
+        window_yaw = 0;
+        for (j = 0, k = i; j < TRACK_CORNER_WINDOW; j++)
+        {
+            window_yaw += s_bin_yaw[k];
+            k = (k + 1 < n) ? (k + 1) : 0;
+        }
+        s_bin_speed[i] = (ABS_VALUE(window_yaw) >= TRACK_CORNER_YAW) ? TRACK_CORNER_PERCENT : 100;
+    }
+
+    // 2. 记录到的元素
+    for (i = 0; i < g_track.event_num; i++)
+    {
+        if (s_event[i].type == ELEM_TURN_90)
+        {
+            track_limit_range(s_event[i].start_bin,
+                              (s_event[i].start_bin + TRACK_CORNER_WINDOW) % n,
+                              TRACK_CORNER_PERCENT);
+        }
+        else if (s_event[i].type == ELEM_HEXAGON)
+        {
+            track_limit_range(s_event[i].start_bin, s_event[i].end_bin, TRACK_HEXAGON_PERCENT);
+        }
+    }
+
+    // 3. 刹车点: 从后往前, 每格最多比后一格快 TRACK_BRAKE_STEP (首尾相连, 两遍保证跨圈传递)
+    for (pass = 0; pass < 2; pass++)
+    {
+        for (i = n; i > 0; i--)
+        {
+            j = i - 1;
+            k = (i < n) ? i : 0;
+            limit = (s_bin_speed[k] + TRACK_BRAKE_STEP < 100) ? (uint8)(s_bin_speed[k] + TRACK_BRAKE_STEP) : 100;
+            if (s_bin_speed[j] > limit)
+            {
+                s_bin_speed[j] = limit;
+            }
+        }
+    }
+}
+
+/*==================================================================================================================
+ *                                              对外接口
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化
+ */
+void TrackMap_Init(void)
+{
+    g_track.mode = TRACK_MODE_OFF;
+    g_track.lap_bins = 0;
+    g_track.event_num = 0;
+    g_track.laps = 0;
+    g_track.lap_yaw = 0;
+    g_track.anchor_count = 0;
+    g_track.tail_distance = 0;
+    track_lap_reset();
+    s_last_element = ELEM_NONE;
+    s_map_distance = 0;
+    s_closure_odo = 0;
+    s_dump_pos = 0xFFFF;
+}
+
+/**
+ * @brief   设置模式
+ */
+void TrackMap_SetMode(TrackMode_t mode)
+{
+    switch (mode)
+    {
+        case TRACK_MODE_LEARN:
+            g_track.lap_bins = 0;
+            g_track.event_num = 0;
+            g_track.laps = 0;
+            g_track.anchor_count = 0;
+            g_track.tail_distance = 0;
+            g_track.mode = TRACK_MODE_LEARN;
+            break;
+
+        case TRACK_MODE_REPLAY:
+            if (g_track.lap_bins > 0)
+            {
+                g_track.mode = TRACK_MODE_REPLAY;
+            }
+            break;
+
+        default:
+            g_track.mode = TRACK_MODE_OFF;
+            break;
+    }
+}
+
+/**
+ * @brief   发车时调用
+ */
+void TrackMap_Restart(void)
+{
+    g_track.lap_yaw = 0;
+    g_track.laps = 0;
+    track_lap_reset();
+    s_closure_odo = 0;
+    s_last_element = ELEM_NONE;
+}
+
+/**
+ * @brief   控制周期更新
+ */
+void TrackMap_Update(int16 encoder_delta, int16 yaw_delta, ElementType_t element)
+{
+    if (g_track.mode == TRACK_MODE_OFF)
+    {
+        return;
+    }
+
+    if (encoder_delta > 0)
+    {
+        g_track.lap_distance += encoder_delta;
+        s_closure_odo += encoder_delta;
+    }
+    g_track.lap_yaw += yaw_delta;
+
+    if (g_track.mode == TRACK_MODE_LEARN)
+    {
+        s_bin_yaw_acc += yaw_delta;
+        track_learn_element(element);
+
+        // 跨格: 写入上一格
+        while (g_track.lap_distance >= (int32)(g_track.bin + 1) * TRACK_BIN_DIST)
+        {
+            track_learn_close_bin();
+            g_track.bin++;
+        }
+
+        // 一圈结束 (转角闭合), 或者里程超出地图容量 (学习失败)
+        if (track_lap_closed())
+        {
+            track_learn_close_bin();
+            g_track.lap_bins = (g_track.bin < TRACK_MAX_BINS) ? (g_track.bin + 1) : TRACK_MAX_BINS;
+            s_map_distance = g_track.lap_distance;
+            s_closure_odo = 0;
+            track_lap_reset();
+            g_track.mode = TRACK_MODE_BUILD;
+        }
+        else if (g_track.bin >= TRACK_MAX_BINS)
+        {
+            g_track.mode = TRACK_MODE_OFF;
+        }
+    }
+    else
+    {
+        if (g_track.mode == TRACK_MODE_REPLAY)
+        {
+            track_replay_anchor(element);
+        }
+
+        // 每圈转角闭合: 两次闭合间的里程即整圈长度, 减去地图长度得到闭合点到发车点的尾段,
+        // 本圈从尾段起点 (负里程) 开始, 误差不会逐圈累积
+        if (track_lap_closed())
+        {
+            if (s_closure_odo > s_map_distance)
+            {
+                g_track.tail_distance = s_closure_odo - s_map_distance;
+            }
+            s_closure_odo = 0;
+            track_lap_reset();
+            g_track.lap_distance = -g_track.tail_distance;
+            g_track.laps++;
+        }
+
+        // 尾段 (闭合点到发车点) 不在地图内, 按第 0 格
+        if (g_track.lap_distance <= 0)
+        {
+            g_track.bin = 0;
+        }
+        else
+        {
+            g_track.bin = (uint16)(g_track.lap_distance / TRACK_BIN_DIST);
+            if (g_track.bin >= g_track.lap_bins)
+            {
+                g_track.bin = g_track.lap_bins - 1;
+            }
+        }
+    }
+
+    s_last_element = element;
+}
+
+/**
+ * @brief   获取当前目标速度
+ */
+int16 TrackMap_GetTargetSpeed(int16 target_speed)
+{
+    switch (g_track.mode)
+    {
+        case TRACK_MODE_LEARN:
+        case TRACK_MODE_BUILD:
+            return (target_speed < TRACK_LEARN_SPEED) ? target_speed : TRACK_LEARN_SPEED;
+
+        case TRACK_MODE_REPLAY:
+            return (int16)((int32)target_speed * s_bin_speed[g_track.bin] / 100);
+
+        default:
+            return target_speed;
+    }
+}
+
+/**
+ * @brief   主循环任务
+ */
+void TrackMap_Task(void)
+{
+    char line[48];
+    char *p;
+    uint8 i;
+
+    // 学习完成: 生成速度表后切换到回放
+    if (g_track.mode == TRACK_MODE_BUILD)
+    {
+        track_build_profile();
+        g_track.mode = TRACK_MODE_REPLAY;
+    }
+
+    // 分批发送每格数据, 每行 TRACK_DUMP_BINS 格 "转角/速度%", 发送队列放得下才发
+    while (s_dump_pos < g_track.lap_bins && Bluetooth_GetTxFree() >= sizeof(line))
+    {
+        p = line;
+        *p++ = 'B';
+        p = Bluetooth_AppendInt(p, (int16)s_dump_pos);
+        for (i = 0; i < TRACK_DUMP_BINS && s_dump_pos < g_track.lap_bins; i++, s_dump_pos++)
+        {
+            *p++ = ' ';
+            p = Bluetooth_AppendInt(p, s_bin_yaw[s_dump_pos]);
+            *p++ = '/';
+            p = Bluetooth_AppendInt(p, s_bin_speed[s_dump_pos]);
+        }
+        *p++ = '\r';
+        *p++ = '\n';
+        *p   = '\0';
+        Bluetooth_SendString(line);
+    }
+    if (s_dump_pos >= g_track.lap_bins)
+    {
+        s_dump_pos = 0xFFFF;
+    }
+}
+
+/**
+ * @brief   通过蓝牙发送地图信息
+ * @details 状态行: "TRK <模式> <格数> <元素数> <圈数> <当前格> <校准次数> <尾段格数>"
+ *          元素行: "E <序号> <类型> <入口格> <出口格>"
+ *          每格行: "B<起始格> 转角/速度% ..." (每行 TRACK_DUMP_BINS 格, 由 TrackMap_Task 分批发送)
+ */
+void TrackMap_SendReport(uint8 detail)
+{
+    char line[40];
+    char *p;
+    uint8 i;
+
+    p = line;
+    *p++ = 'T';
+    *p++ = 'R';
+    *p++ = 'K';
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, (int16)g_track.mode);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, (int16)g_track.lap_bins);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_track.event_num);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, g_track.laps);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, (int16)g_track.bin);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, (int16)g_track.anchor_count);
+    *p++ = ' ';
+    p = Bluetooth_AppendInt(p, (int16)(g_track.tail_distance / TRACK_BIN_DIST));
+    *p++ = '\r';
+    *p++ = '\n';
+    *p   = '\0';
+    Bluetooth_SendString(line);
+
+    if (!detail)
+    {
+        return;
+    }
+
+    for (i = 0; i < g_track.event_num; i++)
+    {
+        p = line;
+        *p++ = 'E';
+        *p++ = ' ';
+        p = Bluetooth_AppendInt(p, i);
+        *p++ = ' ';
+        p = Bluetooth_AppendInt(p, s_event[i].type);
+        *p++ = ' ';
+        p = Bluetooth_AppendInt(p, s_event[i].start_bin);
+        *p++ = ' ';
+        p = Bluetooth_AppendInt(p, s_event[i].end_bin);
+        *p++ = '\r';
+        *p++ = '\n';
+        *p   = '\0';
+        Bluetooth_SendString(line);
+    }
+
+    if (g_track.lap_bins > 0)
+    {
+        s_dump_pos = 0;
+    }
+}
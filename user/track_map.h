@@ -0,0 +1,132 @@
+/*********************************************************************************************************************
+ * @file        track_map.h
+ * @brief       飞檐走壁智能车 - 赛道记忆与速度规划模块 (头文件)
+ * @details     第一圈低速学习: 按里程分格记录每格转角和识别到的元素;
+ *              学习完成后生成每格目标速度 (急弯/环岛前提前刹车), 之后各圈按里程查表给出目标速度
+ * @author      智能车竞赛代码
+ * @version     1.0
+ * @date        2026-02-17
+ *
+ * @note        工作流程:
+ *              1. $TRK:1 后启动, 以 TRACK_LEARN_SPEED 跑第一圈
+ *              2. 累计转角接近 TRACK_LAP_YAW (闭合赛道一圈 360°, 在最后一个弯内) 时一圈结束, 主循环生成速度表
+ *                 地图从发车点开始, 到转角闭合点 (最后一个弯内) 结束
+ *              3. 之后各圈: 目标速度 = 蓝牙设置的目标速度 × 当前格百分比
+ *
+ *              位置校准:
+ *              - 每圈累计转角再次闭合时里程重新对齐, 误差不会逐圈累积
+ *              - 闭合点到发车点的尾段不在地图内: 回放第一圈结束时由两次闭合间的里程减去地图长度测得,
+ *                之后各圈从负里程开始; 测得之前按 0 处理 (位置偏前, 即提前刹车)
+ *              - 圈内识别到与地图中同类型的元素 (TRACK_ANCHOR_WINDOW 格以内) 时, 里程对齐到记录位置
+ *
+ *              速度表生成:
+ *              1. 窗口内转角超过 TRACK_CORNER_YAW 或记录为直角弯的格: TRACK_CORNER_PERCENT
+ *              2. 环岛区间: TRACK_HEXAGON_PERCENT, 其余: 100
+ *              3. 从后往前每格最多升 TRACK_BRAKE_STEP 个百分点, 即弯前提前刹车 (首尾相连, 算两遍)
+ ********************************************************************************************************************/
+
+#ifndef __TRACK_MAP_H__
+#define __TRACK_MAP_H__
+
+#include "car_config.h"
+#include "element.h"
+
+/*==================================================================================================================
+ *                                              数据结构
+ *==================================================================================================================*/
+
+/**
+ * @brief   工作模式
+ */
+typedef enum
+{
+    TRACK_MODE_OFF = 0,         // 关闭, 目标速度不变
+    TRACK_MODE_LEARN,           // 学习圈 (低速记录)
+    TRACK_MODE_BUILD,           // 学习完成, 等待主循环生成速度表 (仍按学习速度行驶)
+    TRACK_MODE_REPLAY           // 按速度表行驶
+} TrackMode_t;
+
+/**
+ * @brief   元素记录
+ */
+typedef struct
+{
+    uint8 start_bin;            // 进入元素时所在格
+    uint8 end_bin;              // 退出元素时所在格
+    uint8 type;                 // ElementType_t
+} TrackEvent_t;
+
+/**
+ * @brief   赛道记忆数据
+ */
+typedef struct
+{
+    TrackMode_t mode;
+
+    uint16 lap_bins;            // 一圈格数 (学习完成后有效)
+    uint8  event_num;           // 记录的元素数
+    uint8  laps;                // 学习完成后已跑圈数
+
+    int32  lap_distance;        // 本圈里程 (编码器脉冲)
+    int32  lap_yaw;             // 本圈累计转角 (0.01°)
+    uint16 bin;                 // 当前格
+    uint16 anchor_count;        // 元素位置校准次数
+    int32  tail_distance;       // 转角闭合点到发车点的里程 (回放第一圈结束后测得)
+} TrackMapData_t;
+
+extern TrackMapData_t g_track;
+
+/*==================================================================================================================
+ *                                              函数声明
+ *==================================================================================================================*/
+
+/**
+ * @brief   初始化 (清空地图, 模式为关闭)
+ * @return  void
+ */
+void TrackMap_Init(void);
+
+/**
+ * @brief   设置模式
+ * @param   mode    TRACK_MODE_OFF / TRACK_MODE_LEARN / TRACK_MODE_REPLAY
+ * @note    TRACK_MODE_LEARN 清空地图重新学习; 没有地图时 TRACK_MODE_REPLAY 无效
+ * @return  void
+ */
+void TrackMap_SetMode(TrackMode_t mode);
+
+/**
+ * @brief   发车时调用: 本圈里程和转角从 0 开始
+ * @return  void
+ */
+void TrackMap_Restart(void);
+
+/**
+ * @brief   控制周期更新 (在 System_Control 中, Element_Update 之后调用)
+ * @param   encoder_delta   本周期编码器增量 (左+右)/2
+ * @param   yaw_delta       本周期偏航角变化 (0.01°)
+ * @param   element         当前识别到的元素
+ * @return  void
+ */
+void TrackMap_Update(int16 encoder_delta, int16 yaw_delta, ElementType_t element);
+
+/**
+ * @brief   获取当前目标速度
+ * @param   target_speed    蓝牙设置的目标速度 (直道速度)
+ * @return  int16           本格目标速度
+ */
+int16 TrackMap_GetTargetSpeed(int16 target_speed);
+
+/**
+ * @brief   主循环任务: 学习完成后生成速度表
+ * @return  void
+ */
+void TrackMap_Task(void);
+
+/**
+ * @brief   通过蓝牙发送地图信息
+ * @param   detail  0 = 只发送状态行, 1 = 同时发送元素列表和每格 "转角/速度%"
+ * @return  void
+ */
+void TrackMap_SendReport(uint8 detail);
+
+#endif // __TRACK_MAP_H__
@@ -131,7 +131,7 @@ float imu660ra_transition_factor[2] = {4096, 16.4};
 	static void imu660ra_read_registers(uint8 reg, uint8 *dat, uint32 len)
 	{
 		uint16 i = 0;
-		uint8 temp_data[8];
+		uint8 temp_data[13];                                                    // 最长一次读取 12 字节 + 1 字节空读
 		IMU660RA_CS(0);
 		spi_read_8bit_registers(IMU660RA_SPI, reg | IMU660RA_SPI_R, temp_data, len + 1);
 		IMU660RA_CS(1);
@@ -281,7 +281,7 @@ float imu660ra_transition_factor[2] = {4096, 16.4};
 	static void imu660ra_read_registers(uint8 reg, uint8 *dat, uint32 len)
 	{
 		uint16 i = 0;
-		uint8 temp_data[8];
+		uint8 temp_data[13];                                                    // 最长一次读取 12 字节 + 1 字节空读
 		IMU660RA_CS(0);
 		imu660ra_simspi_r_reg_bytes(reg | IMU660RA_SPI_R, temp_data, len + 1);
 		IMU660RA_CS(1);
@@ -366,6 +366,35 @@ void imu660ra_get_gyro (void)
     imu660ra_gyro_z = (int16)(((uint16)dat[5] << 8 | dat[4]));
 }
 
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     一次读取 IMU660RA 加速度计和陀螺仪数据
+// 参数说明     dat             数据输出结构体
+// 返回参数     void
+// 使用示例     imu660ra_get_all(&imu_data);
+// 备注信息     加速度计 (0x0C~0x11) 与陀螺仪 (0x12~0x17) 寄存器地址连续 一次连续读取 12 字节
+//            两组数据来自同一时刻 耗时约为分别调用 imu660ra_get_acc/imu660ra_get_gyro 的一半
+//            同时更新 imu660ra_acc_x 等全局变量 兼容原有用法
+//-------------------------------------------------------------------------------------------------------------------
+void imu660ra_get_all (imu660ra_data_struct *dat)
+{
+    uint8 buf[12];
+    
+    imu660ra_read_registers(IMU660RA_ACC_ADDRESS, buf, 12);
+    dat->acc_x  = (int16)(((uint16)buf[1]  << 8 | buf[0]));
+    dat->acc_y  = (int16)(((uint16)buf[3]  << 8 | buf[2]));
+    dat->acc_z  = (int16)(((uint16)buf[5]  << 8 | buf[4]));
+    dat->gyro_x = (int16)(((uint16)buf[7]  << 8 | buf[6]));
+    dat->gyro_y = (int16)(((uint16)buf[9]  << 8 | buf[8]));
+    dat->gyro_z = (int16)(((uint16)buf[11] << 8 | buf[10]));
+    
+    imu660ra_acc_x  = dat->acc_x;
+    imu660ra_acc_y  = dat->acc_y;
+    imu660ra_acc_z  = dat->acc_z;
+    imu660ra_gyro_x = dat->gyro_x;
+    imu660ra_gyro_y = dat->gyro_y;
+    imu660ra_gyro_z = dat->gyro_z;
+}
+
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介     初始化 IMU660RA
 // 参数说明     void
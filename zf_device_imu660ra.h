@@ -127,12 +127,19 @@ typedef enum
 #define IMU660RA_GYR_RANGE          ( 0x43 )
 //================================================定义 IMU660RA 内部地址================================================
 
+typedef struct
+{
+    int16 acc_x, acc_y, acc_z;                                                  // 三轴加速度计数据
+    int16 gyro_x, gyro_y, gyro_z;                                               // 三轴陀螺仪数据
+} imu660ra_data_struct;
+
 extern int16 imu660ra_gyro_x, imu660ra_gyro_y, imu660ra_gyro_z;                 // 三轴陀螺仪数据      gyro (陀螺仪)
 extern int16 imu660ra_acc_x, imu660ra_acc_y, imu660ra_acc_z;                    // 三轴加速度计数据     acc (accelerometer 加速度计)
 extern float imu660ra_transition_factor[2];
 
 void  imu660ra_get_acc              (void);                                     // 获取 IMU660RA 加速度计数据
 void  imu660ra_get_gyro             (void);                                     // 获取 IMU660RA 陀螺仪数据
+void  imu660ra_get_all              (imu660ra_data_struct *dat);                // 一次读取 IMU660RA 加速度计和陀螺仪数据
 
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介     将 IMU660RA 加速度计数据转换为实际物理数据